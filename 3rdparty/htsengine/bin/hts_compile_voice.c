@@ -0,0 +1,52 @@
+/* ----------------------------------------------------------------- */
+/*  hts_compile_voice: build precompiled voice image from .htsvoice  */
+/* ----------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+
+#include "HTS_engine.h"
+
+/* usage: output usage */
+static void usage(void)
+{
+   fprintf(stderr, "%s\n", HTS_COPYRIGHT);
+   fprintf(stderr, "hts_compile_voice - build precompiled voice image\n");
+   fprintf(stderr, "\n");
+   fprintf(stderr, "  usage:\n");
+   fprintf(stderr, "       hts_compile_voice voice image     build image from voice\n");
+   fprintf(stderr, "       hts_compile_voice -c voice image  check that image was built from voice\n");
+}
+
+int main(int argc, char **argv)
+{
+   HTS_Engine engine;
+   char *voice;
+   HTS_Boolean result;
+
+   /* voice files use '.' as decimal separator */
+   setlocale(LC_NUMERIC, "C");
+
+   if (argc == 4 && strcmp(argv[1], "-c") == 0) {
+      if (HTS_Engine_check_image(argv[3], argv[2]) != TRUE) {
+         fprintf(stderr, "%s was not built from %s.\n", argv[3], argv[2]);
+         return 1;
+      }
+      return 0;
+   }
+
+   if (argc != 3) {
+      usage();
+      return 1;
+   }
+
+   voice = argv[1];
+   HTS_Engine_initialize(&engine);
+   result = HTS_Engine_load(&engine, &voice, 1);
+   if (result == TRUE)
+      result = HTS_Engine_save_image(&engine, argv[2], voice);
+   HTS_Engine_clear(&engine);
+
+   return result == TRUE ? 0 : 1;
+}
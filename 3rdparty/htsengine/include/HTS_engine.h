@@ -56,6 +56,7 @@
 HTS_ENGINE_H_START;
 
 #include <stdio.h>
+#include <limits.h>
 
 /* common ---------------------------------------------------------- */
 
@@ -88,6 +89,35 @@ typedef struct _HTS_Audio {
    void *audio_interface;       /* audio interface specified in compile step */
 } HTS_Audio;
 
+/* context --------------------------------------------------------- */
+
+#define HTS_CONTEXT_STRING    0 /* value is a string */
+#define HTS_CONTEXT_INTEGER   1 /* value is a non-negative integer */
+#define HTS_CONTEXT_SIGNED    2 /* value is an integer which may be negative */
+
+#define HTS_CONTEXT_UNDEFINED INT_MIN   /* integer value written as "xx" */
+
+/* HTS_ContextField: field of a structured full-context label. */
+typedef struct _HTS_ContextField {
+   const char *prefix;          /* delimiter written before the value */
+   int type;                    /* type of the value */
+} HTS_ContextField;
+
+/* HTS_ContextFormat: layout of structured full-context labels. The string form is the */
+/* concatenation of prefix and value of each field. Values are alphanumeric (except for */
+/* the sign of HTS_CONTEXT_SIGNED values), and every prefix but the first one contains */
+/* a delimiter character, so that a question can be compiled into a field comparison. */
+typedef struct _HTS_ContextFormat {
+   const HTS_ContextField *field;       /* fields */
+   size_t nfield;               /* # of fields */
+} HTS_ContextFormat;
+
+/* HTS_ContextValue: value of a field of a structured full-context label. */
+typedef union _HTS_ContextValue {
+   int integer;                 /* value of integer field (HTS_CONTEXT_UNDEFINED for "xx") */
+   const char *string;          /* value of string field */
+} HTS_ContextValue;
+
 /* model ----------------------------------------------------------- */
 
 /* HTS_Window: window coefficients to calculate dynamic features. */
@@ -95,39 +125,50 @@ typedef struct _HTS_Window {
    size_t size;                 /* # of windows (static + deltas) */
    int *l_width;                /* left width of windows */
    int *r_width;                /* right width of windows */
-   double **coefficient;        /* window coefficient */
+   unsigned int *center;        /* index of the center coefficient of each window */
+   double *coefficient;         /* window coefficients (all windows, contiguous) */
    size_t max_width;            /* maximum width of windows */
 } HTS_Window;
 
-/* HTS_Pattern: list of patterns in a question and a tree. */
+/* HTS_PatternField: field-indexed form of a pattern for structured labels. */
+typedef struct _HTS_PatternField {
+   int field;                   /* index of compared field (HTS_PATTERN_STRING or HTS_PATTERN_ANY if none) */
+   int integer;                 /* value of integer field */
+   unsigned int string;         /* offset of value of string field in string pool (not terminated) */
+   unsigned int length;         /* length of value of string field (0 for integer field) */
+} HTS_PatternField;
+
+#define HTS_PATTERN_STRING (-1)  /* pattern needs string matching */
+#define HTS_PATTERN_ANY    (-2)  /* pattern matches any label */
+
+/* HTS_Pattern: precompiled pattern in a question or a tree. */
 typedef struct _HTS_Pattern {
-   char *string;                /* pattern string */
-   struct _HTS_Pattern *next;   /* pointer to the next pattern */
+   unsigned int string;         /* offset of pattern string in string pool */
+   unsigned int length;         /* # of characters consumed by a match (excluding '*') */
+   unsigned int is_substring;   /* pattern is "*...*": string holds the inner part for strstr() */
 } HTS_Pattern;
 
-/* HTS_Question: list of questions in a tree. */
+/* HTS_Question: question in a model. */
 typedef struct _HTS_Question {
-   char *string;                /* name of this question */
-   HTS_Pattern *head;           /* pointer to the head of pattern list */
-   struct _HTS_Question *next;  /* pointer to the next question */
+   unsigned int string;         /* offset of question name in string pool */
+   unsigned int head;           /* index of first pattern */
+   unsigned int npattern;       /* # of patterns */
 } HTS_Question;
 
-/* HTS_Node: list of tree nodes in a tree. */
+/* HTS_Node: tree node, children are indices into the node array. */
 typedef struct _HTS_Node {
-   int index;                   /* index of this node */
-   size_t pdf;                  /* index of PDF for this node (leaf node only) */
-   struct _HTS_Node *yes;       /* pointer to its child node (yes) */
-   struct _HTS_Node *no;        /* pointer to its child node (no) */
-   struct _HTS_Node *next;      /* pointer to the next node */
-   HTS_Question *quest;         /* question applied at this node */
+   int quest;                   /* index of question applied at this node (-1 for leaf node) */
+   unsigned int pdf;            /* index of PDF for this node (leaf node only) */
+   unsigned int yes;            /* index of its child node (yes) */
+   unsigned int no;             /* index of its child node (no) */
 } HTS_Node;
 
-/* HTS_Tree: list of decision trees in a model. */
+/* HTS_Tree: decision tree in a model. */
 typedef struct _HTS_Tree {
-   HTS_Pattern *head;           /* pointer to the head of pattern list for this tree */
-   struct _HTS_Tree *next;      /* pointer to next tree */
-   HTS_Node *root;              /* root node of this tree */
-   size_t state;                /* state index of this tree */
+   unsigned int state;          /* state index of this tree */
+   unsigned int head;           /* index of first pattern for this tree */
+   unsigned int npattern;       /* # of patterns for this tree */
+   unsigned int root;           /* index of root node */
 } HTS_Tree;
 
 /* HTS_Model: set of PDFs, decision trees and questions. */
@@ -136,10 +177,20 @@ typedef struct _HTS_Model {
    size_t num_windows;          /* # of windows for delta */
    HTS_Boolean is_msd;          /* flag for MSD */
    size_t ntree;                /* # of trees */
-   size_t *npdf;                /* # of PDFs at each tree */
-   float ***pdf;                /* PDFs */
-   HTS_Tree *tree;              /* pointer to the list of trees */
-   HTS_Question *question;      /* pointer to the list of questions */
+   size_t pdf_length;           /* # of floats in each PDF */
+   unsigned int *npdf;          /* # of PDFs at each tree */
+   unsigned int *pdf_offset;    /* index of first PDF of each tree */
+   float *pdf;                  /* PDFs (all trees, contiguous) */
+   HTS_Tree *tree;              /* trees (NULL if no tree is given) */
+   HTS_Node *node;              /* nodes of all trees */
+   size_t nnode;                /* # of nodes */
+   HTS_Question *question;      /* questions */
+   size_t nquestion;            /* # of questions */
+   HTS_Pattern *pattern;        /* patterns of all questions and trees */
+   size_t npattern;             /* # of patterns */
+   char *string;                /* string pool for questions and patterns */
+   size_t string_size;          /* size of string pool */
+   HTS_PatternField *field;     /* field-indexed form of each pattern (NULL without context format) */
 } HTS_Model;
 
 /* HTS_ModelSet: set of duration models, HMMs and GV models. */
@@ -153,12 +204,16 @@ typedef struct _HTS_ModelSet {
    char *stream_type;           /* stream type */
    char *fullcontext_format;    /* fullcontext label format */
    char *fullcontext_version;   /* version of fullcontext label */
-   HTS_Question *gv_off_context;        /* GV switch */
+   HTS_Model *gv_off_context;   /* GV switch (single question, no trees) */
    char **option;               /* options for each stream */
    HTS_Model *duration;         /* duration PDFs and trees */
    HTS_Window *window;          /* window coefficients for delta */
    HTS_Model **stream;          /* parameter PDFs and trees */
    HTS_Model **gv;              /* GV PDFs and trees */
+   void **image;                /* memory-mapped voice images, one per voice (NULL if loaded from .htsvoice) */
+   size_t *image_size;          /* sizes of memory-mapped voice images */
+   const HTS_ContextFormat *context_format;     /* format of structured labels (NULL if not set) */
+   HTS_Boolean context_string;  /* some pattern still needs the string form of structured labels */
 } HTS_ModelSet;
 
 /* label ----------------------------------------------------------- */
@@ -166,7 +221,8 @@ typedef struct _HTS_ModelSet {
 /* HTS_LabelString: individual label string with time information */
 typedef struct _HTS_LabelString {
    struct _HTS_LabelString *next;       /* pointer to next label string */
-   char *name;                  /* label string */
+   char *name;                  /* label string (formatted on demand for structured labels) */
+   HTS_ContextValue *context;   /* fields of structured label (NULL for string labels) */
    double start;                /* start frame specified in the given label */
    double end;                  /* end frame specified in the given label */
 } HTS_LabelString;
@@ -175,6 +231,8 @@ typedef struct _HTS_LabelString {
 typedef struct _HTS_Label {
    HTS_LabelString *head;       /* pointer to the head of label string */
    size_t size;                 /* # of label strings */
+   const HTS_ContextFormat *format;     /* format of structured labels */
+   struct _HTS_Arena *arena;    /* memory for label strings formatted on demand */
 } HTS_Label;
 
 /* sstream --------------------------------------------------------- */
@@ -201,6 +259,8 @@ typedef struct _HTS_SStreamSet {
    size_t nstream;              /* # of streams */
    size_t nstate;               /* # of states */
    size_t *duration;            /* duration sequence */
+   double *duration_mean;       /* mean of state durations */
+   double *duration_vari;       /* variance of state durations */
    size_t total_state;          /* total state */
    size_t total_frame;          /* total frame */
 } HTS_SStreamSet;
@@ -260,6 +320,9 @@ typedef struct _HTS_GStreamSet {
 
 /* engine ---------------------------------------------------------- */
 
+/* HTS_FrameCallback: called before the first and after each synthesized frame with the number of frames done, synthesis stops when it returns FALSE */
+typedef HTS_Boolean(*HTS_FrameCallback) (void *data, size_t frame, size_t total_frame);
+
 /* HTS_Condition: synthesis condition */
 typedef struct _HTS_Condition {
    /* global */
@@ -267,6 +330,8 @@ typedef struct _HTS_Condition {
    size_t fperiod;              /* frame period */
    size_t audio_buff_size;      /* audio buffer size (for audio device) */
    HTS_Boolean stop;            /* stop flag */
+   HTS_FrameCallback frame_callback;    /* called after each synthesized frame (NULL for none) */
+   void *frame_callback_data;   /* data passed to frame callback */
    double volume;               /* volume */
    double *msd_threshold;       /* MSD thresholds */
    double *gv_weight;           /* GV weights */
@@ -280,6 +345,7 @@ typedef struct _HTS_Condition {
    HTS_Boolean use_log_gain;    /* log gain flag (for LSP) */
    double alpha;                /* all-pass constant */
    double beta;                 /* postfiltering coefficient */
+   size_t pade_order;           /* pade order of the MLSA filter */
 
    /* log F0 */
    double additional_half_tone; /* additional half tone */
@@ -290,15 +356,38 @@ typedef struct _HTS_Condition {
    double **gv_iw;              /* weights for GV interpolation */
 } HTS_Condition;
 
+/* HTS_ArenaBlock: block of arena memory (data follows the header). */
+typedef struct _HTS_ArenaBlock {
+   struct _HTS_ArenaBlock *next;        /* previous (smaller) block */
+   size_t size;                 /* size of data */
+   size_t used;                 /* allocated bytes of data */
+} HTS_ArenaBlock;
+
+/* HTS_Arena: bump allocator for data of one utterance. */
+typedef struct _HTS_Arena {
+   HTS_ArenaBlock *block;       /* current block */
+   size_t capacity;             /* total size of all blocks */
+} HTS_Arena;
+
+/* HTS_ArenaMark: position in arena to rewind to. */
+typedef struct _HTS_ArenaMark {
+   HTS_ArenaBlock *block;       /* current block */
+   size_t used;                 /* allocated bytes of current block */
+} HTS_ArenaMark;
+
 /* HTS_Engine: Engine itself. */
 typedef struct _HTS_Engine {
    HTS_Condition condition;     /* synthesis condition */
+   HTS_Arena arena;             /* memory for label and streams, reset by refresh */
    HTS_Audio audio;             /* audio output */
    HTS_ModelSet ms;             /* set of duration models, HMMs and GV models */
    HTS_Label label;             /* label */
    HTS_SStreamSet sss;          /* set of state streams */
    HTS_PStreamSet pss;          /* set of PDF streams */
    HTS_GStreamSet gss;          /* set of generated parameter streams */
+   HTS_ArenaMark state_mark;    /* end of state sequence in arena */
+   HTS_ArenaMark parameter_mark;        /* end of parameter sequence in arena */
+   double *lf0_mean;            /* log F0 means of state sequence without additional half tone */
 } HTS_Engine;
 
 /* engine method --------------------------------------------------- */
@@ -309,6 +398,18 @@ void HTS_Engine_initialize(HTS_Engine * engine);
 /* HTS_Engine_load: load HTS voices */
 HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices);
 
+/* HTS_Engine_load_image: load precompiled voice image (memory-mapped, read-only) */
+HTS_Boolean HTS_Engine_load_image(HTS_Engine * engine, const char *fn);
+
+/* HTS_Engine_load_images: load precompiled voice images to be interpolated (memory-mapped, read-only) */
+HTS_Boolean HTS_Engine_load_images(HTS_Engine * engine, char **fn, size_t num_images);
+
+/* HTS_Engine_save_image: save loaded voice as precompiled image, with checksum of source voice */
+HTS_Boolean HTS_Engine_save_image(HTS_Engine * engine, const char *fn, const char *voice);
+
+/* HTS_Engine_check_image: check that precompiled image was built from given voice and is not damaged */
+HTS_Boolean HTS_Engine_check_image(const char *fn, const char *voice);
+
 /* HTS_Engine_set_sampling_frequency: set sampling fraquency */
 void HTS_Engine_set_sampling_frequency(HTS_Engine * engine, size_t i);
 
@@ -333,6 +434,9 @@ void HTS_Engine_set_stop_flag(HTS_Engine * engine, HTS_Boolean b);
 /* HTS_Engine_get_stop_flag: get stop flag */
 HTS_Boolean HTS_Engine_get_stop_flag(HTS_Engine * engine);
 
+/* HTS_Engine_set_frame_callback: set function called after each synthesized frame */
+void HTS_Engine_set_frame_callback(HTS_Engine * engine, HTS_FrameCallback callback, void *data);
+
 /* HTS_Engine_set_volume: set volume in db */
 void HTS_Engine_set_volume(HTS_Engine * engine, double f);
 
@@ -345,7 +449,7 @@ void HTS_Engine_set_msd_threshold(HTS_Engine * engine, size_t stream_index, doub
 /* HTS_Engine_get_msd_threshold: get MSD threshold */
 double HTS_Engine_get_msd_threshold(HTS_Engine * engine, size_t stream_index);
 
-/* HTS_Engine_set_gv_weight: set GV weight */
+/* HTS_Engine_set_gv_weight: set GV weight, 0 skips GV for the stream */
 void HTS_Engine_set_gv_weight(HTS_Engine * engine, size_t stream_index, double f);
 
 /* HTS_Engine_get_gv_weight: get GV weight */
@@ -369,6 +473,12 @@ void HTS_Engine_set_beta(HTS_Engine * engine, double f);
 /* HTS_Engine_get_beta: get beta */
 double HTS_Engine_get_beta(HTS_Engine * engine);
 
+/* HTS_Engine_set_pade_order: set pade order of the MLSA filter */
+void HTS_Engine_set_pade_order(HTS_Engine * engine, size_t i);
+
+/* HTS_Engine_get_pade_order: get pade order of the MLSA filter */
+size_t HTS_Engine_get_pade_order(HTS_Engine * engine);
+
 /* HTS_Engine_add_half_tone: add half tone */
 void HTS_Engine_add_half_tone(HTS_Engine * engine, double f);
 
@@ -417,6 +527,9 @@ const char *HTS_Engine_get_fullcontext_label_format(HTS_Engine * engine);
 /* HTS_Engine_get_fullcontext_label_version: get full context label version */
 const char *HTS_Engine_get_fullcontext_label_version(HTS_Engine * engine);
 
+/* HTS_Engine_set_context_format: compile questions for structured labels of given format (after loading voices), return TRUE if no question needs the string form */
+HTS_Boolean HTS_Engine_set_context_format(HTS_Engine * engine, const HTS_ContextFormat * format);
+
 /* HTS_Engine_get_total_frame: get total number of frame */
 size_t HTS_Engine_get_total_frame(HTS_Engine * engine);
 
@@ -435,16 +548,25 @@ HTS_Boolean HTS_Engine_synthesize_from_fn(HTS_Engine * engine, const char *fn);
 /* HTS_Engine_synthesize_from_strings: synthesize speech from string list */
 HTS_Boolean HTS_Engine_synthesize_from_strings(HTS_Engine * engine, char **lines, size_t num_lines);
 
+/* HTS_Engine_synthesize_from_contexts: synthesize speech from structured labels (num_labels * nfield values) */
+HTS_Boolean HTS_Engine_synthesize_from_contexts(HTS_Engine * engine, const HTS_ContextValue * context, size_t num_labels);
+
 /* HTS_Engine_generate_state_sequence_from_fn: generate state sequence from file name (1st synthesis step) */
 HTS_Boolean HTS_Engine_generate_state_sequence_from_fn(HTS_Engine * engine, const char *fn);
 
 /* HTS_Engine_generate_state_sequence_from_strings: generate state sequence from string list (1st synthesis step) */
 HTS_Boolean HTS_Engine_generate_state_sequence_from_strings(HTS_Engine * engine, char **lines, size_t num_lines);
 
+/* HTS_Engine_generate_state_sequence_from_contexts: generate state sequence from structured labels (1st synthesis step) */
+HTS_Boolean HTS_Engine_generate_state_sequence_from_contexts(HTS_Engine * engine, const HTS_ContextValue * context, size_t num_labels);
+
+/* HTS_Engine_update_state_sequence: apply speed and additional half tone to generated state sequence without searching trees again */
+HTS_Boolean HTS_Engine_update_state_sequence(HTS_Engine * engine);
+
 /* HTS_Engine_generate_parameter_sequence: generate parameter sequence (2nd synthesis step) */
 HTS_Boolean HTS_Engine_generate_parameter_sequence(HTS_Engine * engine);
 
-/* HTS_Engine_generate_sample_sequence: generate sample sequence (3rd synthesis step) */
+/* HTS_Engine_generate_sample_sequence: generate sample sequence (3rd synthesis step), steps can be repeated after changing their conditions */
 HTS_Boolean HTS_Engine_generate_sample_sequence(HTS_Engine * engine);
 
 /* HTS_Engine_save_information: save trace information */
@@ -70,6 +70,8 @@ void HTS_Engine_initialize(HTS_Engine * engine)
    engine->condition.fperiod = 0;
    engine->condition.audio_buff_size = 0;
    engine->condition.stop = FALSE;
+   engine->condition.frame_callback = NULL;
+   engine->condition.frame_callback_data = NULL;
    engine->condition.volume = 1.0;
    engine->condition.msd_threshold = NULL;
    engine->condition.gv_weight = NULL;
@@ -83,6 +85,7 @@ void HTS_Engine_initialize(HTS_Engine * engine)
    engine->condition.use_log_gain = FALSE;
    engine->condition.alpha = 0.0;
    engine->condition.beta = 0.0;
+   engine->condition.pade_order = PADEORDER;
 
    /* log F0 */
    engine->condition.additional_half_tone = 0.0;
@@ -92,6 +95,8 @@ void HTS_Engine_initialize(HTS_Engine * engine)
    engine->condition.parameter_iw = NULL;
    engine->condition.gv_iw = NULL;
 
+   /* initialize arena */
+   HTS_Arena_initialize(&engine->arena);
    /* initialize audio */
    HTS_Audio_initialize(&engine->audio);
    /* initialize model set */
@@ -104,25 +109,21 @@ void HTS_Engine_initialize(HTS_Engine * engine)
    HTS_PStreamSet_initialize(&engine->pss);
    /* initialize gstream set */
    HTS_GStreamSet_initialize(&engine->gss);
+   HTS_Arena_mark(&engine->arena, &engine->state_mark);
+   HTS_Arena_mark(&engine->arena, &engine->parameter_mark);
+   engine->lf0_mean = NULL;
 }
 
-/* HTS_Engine_load: load HTS voices */
-HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices)
+/* HTS_Engine_initialize_condition: set synthesis condition for loaded voices */
+static void HTS_Engine_initialize_condition(HTS_Engine * engine)
 {
    size_t i, j;
-   size_t nstream;
+   size_t nstream, num_voices;
    double average_weight;
    const char *option, *find;
 
-   /* reset engine */
-   HTS_Engine_clear(engine);
-
-   /* load voices */
-   if (HTS_ModelSet_load(&engine->ms, voices, num_voices) != TRUE) {
-      HTS_Engine_clear(engine);
-      return FALSE;
-   }
    nstream = HTS_ModelSet_get_nstream(&engine->ms);
+   num_voices = HTS_ModelSet_get_nvoices(&engine->ms);
    average_weight = 1.0 / num_voices;
 
    /* global */
@@ -163,10 +164,58 @@ HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voice
       for (j = 0; j < nstream; j++)
          engine->condition.gv_iw[i][j] = average_weight;
    }
+}
+
+/* HTS_Engine_load: load HTS voices */
+HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices)
+{
+   /* reset engine */
+   HTS_Engine_clear(engine);
+
+   /* load voices */
+   if (HTS_ModelSet_load(&engine->ms, voices, num_voices) != TRUE) {
+      HTS_Engine_clear(engine);
+      return FALSE;
+   }
+   HTS_Engine_initialize_condition(engine);
+
+   return TRUE;
+}
+
+/* HTS_Engine_load_image: load precompiled voice image */
+HTS_Boolean HTS_Engine_load_image(HTS_Engine * engine, const char *fn)
+{
+   return HTS_Engine_load_images(engine, (char **) &fn, 1);
+}
+
+/* HTS_Engine_load_images: load precompiled voice images to be interpolated */
+HTS_Boolean HTS_Engine_load_images(HTS_Engine * engine, char **fn, size_t num_images)
+{
+   /* reset engine */
+   HTS_Engine_clear(engine);
+
+   /* load voice images */
+   if (HTS_ModelSet_load_images(&engine->ms, fn, num_images) != TRUE) {
+      HTS_Engine_clear(engine);
+      return FALSE;
+   }
+   HTS_Engine_initialize_condition(engine);
 
    return TRUE;
 }
 
+/* HTS_Engine_save_image: save loaded voice as precompiled image */
+HTS_Boolean HTS_Engine_save_image(HTS_Engine * engine, const char *fn, const char *voice)
+{
+   return HTS_ModelSet_save_image(&engine->ms, fn, voice);
+}
+
+/* HTS_Engine_check_image: check that precompiled image was built from given voice */
+HTS_Boolean HTS_Engine_check_image(const char *fn, const char *voice)
+{
+   return HTS_ModelSet_check_image(fn, voice);
+}
+
 /* HTS_Engine_set_sampling_frequency: set sampling frequency */
 void HTS_Engine_set_sampling_frequency(HTS_Engine * engine, size_t i)
 {
@@ -221,6 +270,13 @@ HTS_Boolean HTS_Engine_get_stop_flag(HTS_Engine * engine)
    return engine->condition.stop;
 }
 
+/* HTS_Engine_set_frame_callback: set function called after each synthesized frame */
+void HTS_Engine_set_frame_callback(HTS_Engine * engine, HTS_FrameCallback callback, void *data)
+{
+   engine->condition.frame_callback = callback;
+   engine->condition.frame_callback_data = data;
+}
+
 /* HTS_Engine_set_volume: set volume in db */
 void HTS_Engine_set_volume(HTS_Engine * engine, double f)
 {
@@ -249,7 +305,7 @@ double HTS_Engine_get_msd_threshold(HTS_Engine * engine, size_t stream_index)
    return engine->condition.msd_threshold[stream_index];
 }
 
-/* HTS_Engine_set_gv_weight: set GV weight */
+/* HTS_Engine_set_gv_weight: set GV weight, 0 skips GV for the stream */
 void HTS_Engine_set_gv_weight(HTS_Engine * engine, size_t stream_index, double f)
 {
    if (f < 0.0)
@@ -309,6 +365,22 @@ double HTS_Engine_get_beta(HTS_Engine * engine)
    return engine->condition.beta;
 }
 
+/* HTS_Engine_set_pade_order: set pade order of the MLSA filter */
+void HTS_Engine_set_pade_order(HTS_Engine * engine, size_t i)
+{
+   if (i < MIN_PADEORDER)
+      i = MIN_PADEORDER;
+   if (i > PADEORDER)
+      i = PADEORDER;
+   engine->condition.pade_order = i;
+}
+
+/* HTS_Engine_get_pade_order: get pade order of the MLSA filter */
+size_t HTS_Engine_get_pade_order(HTS_Engine * engine)
+{
+   return engine->condition.pade_order;
+}
+
 /* HTS_Engine_add_half_tone: add half tone */
 void HTS_Engine_add_half_tone(HTS_Engine * engine, double f)
 {
@@ -405,6 +477,12 @@ const char *HTS_Engine_get_fullcontext_label_version(HTS_Engine * engine)
    return HTS_ModelSet_get_fullcontext_label_version(&engine->ms);
 }
 
+/* HTS_Engine_set_context_format: compile questions for structured labels of given format */
+HTS_Boolean HTS_Engine_set_context_format(HTS_Engine * engine, const HTS_ContextFormat * format)
+{
+   return HTS_ModelSet_set_context_format(&engine->ms, format);
+}
+
 /* HTS_Engine_get_total_frame: get total number of frame */
 size_t HTS_Engine_get_total_frame(HTS_Engine * engine)
 {
@@ -429,34 +507,42 @@ double HTS_Engine_get_generated_speech(HTS_Engine * engine, size_t index)
    return HTS_GStreamSet_get_speech(&engine->gss, index);
 }
 
-/* HTS_Engine_generate_state_sequence: genereate state sequence (1st synthesis step) */
-static HTS_Boolean HTS_Engine_generate_state_sequence(HTS_Engine * engine)
+/* HTS_Engine_apply_half_tone: set log F0 means of state sequence with additional half tone */
+static void HTS_Engine_apply_half_tone(HTS_Engine * engine)
 {
-   size_t i, state_index, model_index;
+   size_t i;
    double f;
 
-   if (HTS_SStreamSet_create(&engine->sss, &engine->ms, &engine->label, engine->condition.phoneme_alignment_flag, engine->condition.speed, engine->condition.duration_iw, engine->condition.parameter_iw, engine->condition.gv_iw) != TRUE) {
-      HTS_Engine_refresh(engine);
-      return FALSE;
-   }
-   if (engine->condition.additional_half_tone != 0.0) {
-      state_index = 0;
-      model_index = 0;
-      for (i = 0; i < HTS_Engine_get_total_state(engine); i++) {
-         f = HTS_Engine_get_state_mean(engine, 1, i, 0);
+   for (i = 0; i < HTS_Engine_get_total_state(engine); i++) {
+      f = engine->lf0_mean[i];
+      if (engine->condition.additional_half_tone != 0.0) {
          f += engine->condition.additional_half_tone * HALF_TONE;
          if (f < MIN_LF0)
             f = MIN_LF0;
          else if (f > MAX_LF0)
             f = MAX_LF0;
-         HTS_Engine_set_state_mean(engine, 1, i, 0, f);
-         state_index++;
-         if (state_index >= HTS_Engine_get_nstate(engine)) {
-            state_index = 0;
-            model_index++;
-         }
       }
+      HTS_Engine_set_state_mean(engine, 1, i, 0, f);
+   }
+}
+
+/* HTS_Engine_generate_state_sequence: genereate state sequence (1st synthesis step) */
+static HTS_Boolean HTS_Engine_generate_state_sequence(HTS_Engine * engine)
+{
+   size_t i;
+
+   if (HTS_SStreamSet_create(&engine->sss, &engine->ms, &engine->label, engine->condition.phoneme_alignment_flag, engine->condition.speed, engine->condition.duration_iw, engine->condition.parameter_iw, engine->condition.gv_iw, &engine->arena) != TRUE) {
+      HTS_Engine_refresh(engine);
+      return FALSE;
    }
+   /* keep log F0 means, so the half tone can be changed without searching trees again */
+   engine->lf0_mean = (double *) HTS_Arena_calloc(&engine->arena, HTS_Engine_get_total_state(engine), sizeof(double));
+   for (i = 0; i < HTS_Engine_get_total_state(engine); i++)
+      engine->lf0_mean[i] = HTS_Engine_get_state_mean(engine, 1, i, 0);
+   if (engine->condition.additional_half_tone != 0.0)
+      HTS_Engine_apply_half_tone(engine);
+   HTS_Arena_mark(&engine->arena, &engine->state_mark);
+   HTS_Arena_mark(&engine->arena, &engine->parameter_mark);
    return TRUE;
 }
 
@@ -464,7 +550,7 @@ static HTS_Boolean HTS_Engine_generate_state_sequence(HTS_Engine * engine)
 HTS_Boolean HTS_Engine_generate_state_sequence_from_fn(HTS_Engine * engine, const char *fn)
 {
    HTS_Engine_refresh(engine);
-   HTS_Label_load_from_fn(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, fn);
+   HTS_Label_load_from_fn(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, fn, &engine->arena);
    return HTS_Engine_generate_state_sequence(engine);
 }
 
@@ -472,20 +558,55 @@ HTS_Boolean HTS_Engine_generate_state_sequence_from_fn(HTS_Engine * engine, cons
 HTS_Boolean HTS_Engine_generate_state_sequence_from_strings(HTS_Engine * engine, char **lines, size_t num_lines)
 {
    HTS_Engine_refresh(engine);
-   HTS_Label_load_from_strings(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, lines, num_lines);
+   HTS_Label_load_from_strings(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, lines, num_lines, &engine->arena);
    return HTS_Engine_generate_state_sequence(engine);
 }
 
+/* HTS_Engine_generate_state_sequence_from_contexts: generate state sequence from structured labels (1st synthesis step) */
+HTS_Boolean HTS_Engine_generate_state_sequence_from_contexts(HTS_Engine * engine, const HTS_ContextValue * context, size_t num_labels)
+{
+   HTS_Engine_refresh(engine);
+   if (engine->ms.context_format == NULL)
+      return FALSE;
+   HTS_Label_load_from_contexts(&engine->label, engine->ms.context_format, context, num_labels, &engine->arena);
+   return HTS_Engine_generate_state_sequence(engine);
+}
+
+/* HTS_Engine_update_state_sequence: apply speed and additional half tone to generated state sequence without searching trees again */
+HTS_Boolean HTS_Engine_update_state_sequence(HTS_Engine * engine)
+{
+   if (engine->lf0_mean == NULL)
+      return FALSE;
+   HTS_GStreamSet_clear(&engine->gss);
+   HTS_PStreamSet_clear(&engine->pss);
+   HTS_Arena_rewind(&engine->arena, &engine->state_mark);
+   HTS_Arena_mark(&engine->arena, &engine->parameter_mark);
+   /* durations given by label don't depend on speed */
+   if (engine->condition.phoneme_alignment_flag != TRUE)
+      HTS_SStreamSet_set_speed(&engine->sss, engine->condition.speed);
+   HTS_Engine_apply_half_tone(engine);
+   return TRUE;
+}
+
 /* HTS_Engine_generate_parameter_sequence: generate parameter sequence (2nd synthesis step) */
 HTS_Boolean HTS_Engine_generate_parameter_sequence(HTS_Engine * engine)
 {
-   return HTS_PStreamSet_create(&engine->pss, &engine->sss, engine->condition.msd_threshold, engine->condition.gv_weight);
+   /* streams of an earlier call are released */
+   HTS_GStreamSet_clear(&engine->gss);
+   HTS_PStreamSet_clear(&engine->pss);
+   HTS_Arena_rewind(&engine->arena, &engine->state_mark);
+   if (HTS_PStreamSet_create(&engine->pss, &engine->sss, engine->condition.msd_threshold, engine->condition.gv_weight, &engine->arena) != TRUE)
+      return FALSE;
+   HTS_Arena_mark(&engine->arena, &engine->parameter_mark);
+   return TRUE;
 }
 
 /* HTS_Engine_generate_sample_sequence: generate sample sequence (3rd synthesis step) */
 HTS_Boolean HTS_Engine_generate_sample_sequence(HTS_Engine * engine)
 {
-   return HTS_GStreamSet_create(&engine->gss, &engine->pss, engine->condition.stage, engine->condition.use_log_gain, engine->condition.sampling_frequency, engine->condition.fperiod, engine->condition.alpha, engine->condition.beta, &engine->condition.stop, engine->condition.volume, engine->condition.audio_buff_size > 0 ? &engine->audio : NULL);
+   HTS_GStreamSet_clear(&engine->gss);
+   HTS_Arena_rewind(&engine->arena, &engine->parameter_mark);
+   return HTS_GStreamSet_create(&engine->gss, &engine->pss, engine->condition.stage, engine->condition.pade_order, engine->condition.use_log_gain, engine->condition.sampling_frequency, HTS_ModelSet_get_sampling_frequency(&engine->ms), engine->condition.fperiod, engine->condition.alpha, engine->condition.beta, &engine->condition.stop, engine->condition.frame_callback, engine->condition.frame_callback_data, engine->condition.volume, engine->condition.audio_buff_size > 0 ? &engine->audio : NULL, &engine->arena);
 }
 
 /* HTS_Engine_synthesize: synthesize speech */
@@ -510,7 +631,7 @@ static HTS_Boolean HTS_Engine_synthesize(HTS_Engine * engine)
 HTS_Boolean HTS_Engine_synthesize_from_fn(HTS_Engine * engine, const char *fn)
 {
    HTS_Engine_refresh(engine);
-   HTS_Label_load_from_fn(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, fn);
+   HTS_Label_load_from_fn(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, fn, &engine->arena);
    return HTS_Engine_synthesize(engine);
 }
 
@@ -518,7 +639,17 @@ HTS_Boolean HTS_Engine_synthesize_from_fn(HTS_Engine * engine, const char *fn)
 HTS_Boolean HTS_Engine_synthesize_from_strings(HTS_Engine * engine, char **lines, size_t num_lines)
 {
    HTS_Engine_refresh(engine);
-   HTS_Label_load_from_strings(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, lines, num_lines);
+   HTS_Label_load_from_strings(&engine->label, engine->condition.sampling_frequency, engine->condition.fperiod, lines, num_lines, &engine->arena);
+   return HTS_Engine_synthesize(engine);
+}
+
+/* HTS_Engine_synthesize_from_contexts: synthesize speech from structured labels */
+HTS_Boolean HTS_Engine_synthesize_from_contexts(HTS_Engine * engine, const HTS_ContextValue * context, size_t num_labels)
+{
+   HTS_Engine_refresh(engine);
+   if (engine->ms.context_format == NULL)
+      return FALSE;
+   HTS_Label_load_from_contexts(&engine->label, engine->ms.context_format, context, num_labels, &engine->arena);
    return HTS_Engine_synthesize(engine);
 }
 
@@ -617,7 +748,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp)
       fprintf(fp, "  Duration\n");
       for (j = 0; j < HTS_ModelSet_get_nvoices(ms); j++) {
          fprintf(fp, "    Interpolation[%2lu]\n", (unsigned long) j);
-         HTS_ModelSet_get_duration_index(ms, j, HTS_Label_get_string(label, i), &k, &l);
+         HTS_ModelSet_get_duration_index(ms, j, HTS_Label_get_string(label, i), HTS_Label_get_context(label, i), &k, &l);
          fprintf(fp, "      Tree index                       -> %8lu\n", (unsigned long) k);
          fprintf(fp, "      PDF index                        -> %8lu\n", (unsigned long) l);
       }
@@ -634,7 +765,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp)
             }
             for (l = 0; l < HTS_ModelSet_get_nvoices(ms); l++) {
                fprintf(fp, "      Interpolation[%2lu]\n", (unsigned long) l);
-               HTS_ModelSet_get_parameter_index(ms, l, k, j + 2, HTS_Label_get_string(label, i), &m, &n);
+               HTS_ModelSet_get_parameter_index(ms, l, k, j + 2, HTS_Label_get_string(label, i), HTS_Label_get_context(label, i), &m, &n);
                fprintf(fp, "        Tree index                     -> %8lu\n", (unsigned long) m);
                fprintf(fp, "        PDF index                      -> %8lu\n", (unsigned long) n);
             }
@@ -756,6 +887,11 @@ void HTS_Engine_refresh(HTS_Engine * engine)
    HTS_SStreamSet_clear(&engine->sss);
    /* free label list */
    HTS_Label_clear(&engine->label);
+   /* release memory of the utterance, keeping capacity for the next one */
+   HTS_Arena_reset(&engine->arena);
+   HTS_Arena_mark(&engine->arena, &engine->state_mark);
+   HTS_Arena_mark(&engine->arena, &engine->parameter_mark);
+   engine->lf0_mean = NULL;
    /* stop flag */
    engine->condition.stop = FALSE;
 }
@@ -784,6 +920,7 @@ void HTS_Engine_clear(HTS_Engine * engine)
 
    HTS_ModelSet_clear(&engine->ms);
    HTS_Audio_clear(&engine->audio);
+   HTS_Arena_clear(&engine->arena);
    HTS_Engine_initialize(engine);
 }
 
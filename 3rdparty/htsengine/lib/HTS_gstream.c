@@ -69,13 +69,14 @@ void HTS_GStreamSet_initialize(HTS_GStreamSet * gss)
 }
 
 /* HTS_GStreamSet_create: generate speech */
-HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio)
+HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, size_t pade_order, HTS_Boolean use_log_gain, size_t sampling_rate, size_t voice_sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, HTS_FrameCallback callback, void *callback_data, double volume, HTS_Audio * audio, HTS_Arena * arena)
 {
    size_t i, j, k;
    size_t msd_frame;
    HTS_Vocoder v;
    size_t nlpf = 0;
    double *lpf = NULL;
+   HTS_Boolean running;
 
    /* check */
    if (gss->gstream || gss->gspeech) {
@@ -87,14 +88,12 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, si
    gss->nstream = HTS_PStreamSet_get_nstream(pss);
    gss->total_frame = HTS_PStreamSet_get_total_frame(pss);
    gss->total_nsample = fperiod * gss->total_frame;
-   gss->gstream = (HTS_GStream *) HTS_calloc(gss->nstream, sizeof(HTS_GStream));
+   gss->gstream = (HTS_GStream *) HTS_Arena_calloc(arena, gss->nstream, sizeof(HTS_GStream));
    for (i = 0; i < gss->nstream; i++) {
       gss->gstream[i].vector_length = HTS_PStreamSet_get_vector_length(pss, i);
-      gss->gstream[i].par = (double **) HTS_calloc(gss->total_frame, sizeof(double *));
-      for (j = 0; j < gss->total_frame; j++)
-         gss->gstream[i].par[j] = (double *) HTS_calloc(gss->gstream[i].vector_length, sizeof(double));
+      gss->gstream[i].par = HTS_Arena_alloc_matrix(arena, gss->total_frame, gss->gstream[i].vector_length);
    }
-   gss->gspeech = (double *) HTS_calloc(gss->total_nsample, sizeof(double));
+   gss->gspeech = (double *) HTS_Arena_calloc(arena, gss->total_nsample, sizeof(double));
 
    /* copy generated parameter */
    for (i = 0; i < gss->nstream; i++) {
@@ -132,14 +131,17 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, si
    }
 
    /* synthesize speech waveform */
-   HTS_Vocoder_initialize(&v, gss->gstream[0].vector_length - 1, stage, use_log_gain, sampling_rate, fperiod);
+   HTS_Vocoder_initialize(&v, gss->gstream[0].vector_length - 1, stage, pade_order, use_log_gain, sampling_rate, voice_sampling_rate, fperiod);
    if (gss->nstream >= 3)
       nlpf = gss->gstream[2].vector_length;
-   for (i = 0; i < gss->total_frame && (*stop) == FALSE; i++) {
+   running = callback != NULL ? callback(callback_data, 0, gss->total_frame) : TRUE;
+   for (i = 0; i < gss->total_frame && (*stop) == FALSE && running == TRUE; i++) {
       j = i * fperiod;
       if (gss->nstream >= 3)
          lpf = &gss->gstream[2].par[i][0];
       HTS_Vocoder_synthesize(&v, gss->gstream[0].vector_length - 1, gss->gstream[1].par[i][0], &gss->gstream[0].par[i][0], nlpf, lpf, alpha, beta, volume, &gss->gspeech[j], audio);
+      if (callback != NULL)
+         running = callback(callback_data, i + 1, gss->total_frame);
    }
    HTS_Vocoder_clear(&v);
    if (audio)
@@ -178,23 +180,9 @@ double HTS_GStreamSet_get_parameter(HTS_GStreamSet * gss, size_t stream_index, s
    return gss->gstream[stream_index].par[frame_index][vector_index];
 }
 
-/* HTS_GStreamSet_clear: free generated parameter stream set */
+/* HTS_GStreamSet_clear: free generated parameter stream set (memory is owned by the arena) */
 void HTS_GStreamSet_clear(HTS_GStreamSet * gss)
 {
-   size_t i, j;
-
-   if (gss->gstream) {
-      for (i = 0; i < gss->nstream; i++) {
-         if (gss->gstream[i].par != NULL) {
-            for (j = 0; j < gss->total_frame; j++)
-               HTS_free(gss->gstream[i].par[j]);
-            HTS_free(gss->gstream[i].par);
-         }
-      }
-      HTS_free(gss->gstream);
-   }
-   if (gss->gspeech)
-      HTS_free(gss->gspeech);
    HTS_GStreamSet_initialize(gss);
 }
 
@@ -146,6 +146,36 @@ void HTS_free_matrix(double **p, size_t x);
 /* HTS_Free: wrapper for free */
 void HTS_free(void *p);
 
+/* HTS_mmap: map file into memory (read-only) */
+void *HTS_mmap(const char *name, size_t * size);
+
+/* HTS_munmap: unmap file mapped by HTS_mmap */
+void HTS_munmap(void *data, size_t size);
+
+/* HTS_Arena_initialize: initialize arena */
+void HTS_Arena_initialize(HTS_Arena * arena);
+
+/* HTS_Arena_calloc: allocate zero-filled memory from arena */
+void *HTS_Arena_calloc(HTS_Arena * arena, const size_t num, const size_t size);
+
+/* HTS_Arena_strdup: copy string into arena */
+char *HTS_Arena_strdup(HTS_Arena * arena, const char *string);
+
+/* HTS_Arena_alloc_matrix: allocate double matrix from arena */
+double **HTS_Arena_alloc_matrix(HTS_Arena * arena, size_t x, size_t y);
+
+/* HTS_Arena_mark: get current position of arena */
+void HTS_Arena_mark(HTS_Arena * arena, HTS_ArenaMark * mark);
+
+/* HTS_Arena_rewind: release allocations made after mark */
+void HTS_Arena_rewind(HTS_Arena * arena, const HTS_ArenaMark * mark);
+
+/* HTS_Arena_reset: release all allocations but keep capacity */
+void HTS_Arena_reset(HTS_Arena * arena);
+
+/* HTS_Arena_clear: free arena */
+void HTS_Arena_clear(HTS_Arena * arena);
+
 /* HTS_error: output error message */
 void HTS_error(int error, const char *message, ...);
 
@@ -174,6 +204,21 @@ void HTS_ModelSet_initialize(HTS_ModelSet * ms);
 /* HTS_ModelSet_load: load HTS voices */
 HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voices);
 
+/* HTS_ModelSet_load_images: load precompiled voice images, one per voice */
+HTS_Boolean HTS_ModelSet_load_images(HTS_ModelSet * ms, char **fn, size_t num_images);
+
+/* HTS_ModelSet_save_image: save model set as precompiled voice image */
+HTS_Boolean HTS_ModelSet_save_image(HTS_ModelSet * ms, const char *fn, const char *voice);
+
+/* HTS_ModelSet_check_image: check checksums of source voice and image body recorded in image */
+HTS_Boolean HTS_ModelSet_check_image(const char *fn, const char *voice);
+
+/* HTS_ModelSet_set_context_format: compile patterns for structured labels, return TRUE if no pattern needs string matching */
+HTS_Boolean HTS_ModelSet_set_context_format(HTS_ModelSet * ms, const HTS_ContextFormat * format);
+
+/* HTS_ModelSet_use_context: check given structured label can be matched without its string form */
+HTS_Boolean HTS_ModelSet_use_context(HTS_ModelSet * ms, const HTS_ContextValue * context);
+
 /* HTS_ModelSet_get_sampling_frequency: get sampling frequency of HTS voices */
 size_t HTS_ModelSet_get_sampling_frequency(HTS_ModelSet * ms);
 
@@ -184,7 +229,7 @@ size_t HTS_ModelSet_get_fperiod(HTS_ModelSet * ms);
 const char *HTS_ModelSet_get_option(HTS_ModelSet * ms, size_t stream_index);
 
 /* HTS_ModelSet_get_gv_flag: get GV flag */
-HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string);
+HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string, const HTS_ContextValue * context);
 
 /* HTS_ModelSet_get_nstate: get number of state */
 size_t HTS_ModelSet_get_nstate(HTS_ModelSet * ms);
@@ -226,21 +271,21 @@ size_t HTS_ModelSet_get_window_max_width(HTS_ModelSet * ms, size_t stream_index)
 HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, size_t stream_index);
 
 /* HTS_ModelSet_get_duration_index: get index of duration tree and PDF */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const double *iw, double *mean, double *vari);
+void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const HTS_ContextValue * context, const double *iw, double *mean, double *vari);
 
 /* HTS_ModelSet_get_parameter_index: get index of parameter tree and PDF */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const double *const *iw, double *mean, double *vari, double *msd);
+void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const HTS_ContextValue * context, const double *const *iw, double *mean, double *vari, double *msd);
 
-void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const double *const *iw, double *mean, double *vari);
+void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const HTS_ContextValue * context, const double *const *iw, double *mean, double *vari);
 
 /* HTS_ModelSet_clear: free model set */
 void HTS_ModelSet_clear(HTS_ModelSet * ms);
@@ -251,17 +296,23 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms);
 void HTS_Label_initialize(HTS_Label * label);
 
 /* HTS_Label_load_from_fn: load label from file name */
-void HTS_Label_load_from_fn(HTS_Label * label, size_t sampling_rate, size_t fperiod, const char *fn);
+void HTS_Label_load_from_fn(HTS_Label * label, size_t sampling_rate, size_t fperiod, const char *fn, HTS_Arena * arena);
 
 /* HTS_Label_load_from_strings: load label list from string list */
-void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t fperiod, char **lines, size_t num_lines);
+void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t fperiod, char **lines, size_t num_lines, HTS_Arena * arena);
+
+/* HTS_Label_load_from_contexts: load label list from structured labels */
+void HTS_Label_load_from_contexts(HTS_Label * label, const HTS_ContextFormat * format, const HTS_ContextValue * context, size_t num_labels, HTS_Arena * arena);
 
 /* HTS_Label_get_size: get number of label string */
 size_t HTS_Label_get_size(HTS_Label * label);
 
-/* HTS_Label_get_string: get label string */
+/* HTS_Label_get_string: get label string, formatting structured label on first use */
 const char *HTS_Label_get_string(HTS_Label * label, size_t index);
 
+/* HTS_Label_get_context: get fields of structured label (NULL for string label) */
+const HTS_ContextValue *HTS_Label_get_context(HTS_Label * label, size_t index);
+
 /* HTS_Label_get_start_frame: get start frame */
 double HTS_Label_get_start_frame(HTS_Label * label, size_t index);
 
@@ -277,7 +328,7 @@ void HTS_Label_clear(HTS_Label * label);
 void HTS_SStreamSet_initialize(HTS_SStreamSet * sss);
 
 /* HTS_SStreamSet_create: parse label and determine state duration */
-HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, HTS_Boolean phoneme_alignment_flag, double speed, double *duration_iw, double **parameter_iw, double **gv_iw);
+HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, HTS_Boolean phoneme_alignment_flag, double speed, double *duration_iw, double **parameter_iw, double **gv_iw, HTS_Arena * arena);
 
 /* HTS_SStreamSet_get_nstream: get number of stream */
 size_t HTS_SStreamSet_get_nstream(HTS_SStreamSet * sss);
@@ -315,6 +366,9 @@ size_t HTS_SStreamSet_get_window_max_width(HTS_SStreamSet * sss, size_t stream_i
 /* HTS_SStreamSet_use_gv: get GV flag */
 HTS_Boolean HTS_SStreamSet_use_gv(HTS_SStreamSet * sss, size_t stream_index);
 
+/* HTS_SStreamSet_set_speed: determine state duration for speech speed */
+void HTS_SStreamSet_set_speed(HTS_SStreamSet * sss, double speed);
+
 /* HTS_SStreamSet_get_duration: get state duration */
 size_t HTS_SStreamSet_get_duration(HTS_SStreamSet * sss, size_t state_index);
 
@@ -365,7 +419,7 @@ void HTS_SStreamSet_clear(HTS_SStreamSet * sss);
 void HTS_PStreamSet_initialize(HTS_PStreamSet * pss);
 
 /* HTS_PStreamSet_create: parameter generation using GV weight */
-HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight);
+HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight, HTS_Arena * arena);
 
 /* HTS_PStreamSet_get_nstream: get number of stream */
 size_t HTS_PStreamSet_get_nstream(HTS_PStreamSet * pss);
@@ -397,7 +451,7 @@ void HTS_PStreamSet_clear(HTS_PStreamSet * pss);
 void HTS_GStreamSet_initialize(HTS_GStreamSet * gss);
 
 /* HTS_GStreamSet_create: generate speech */
-HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio);
+HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, size_t pade_order, HTS_Boolean use_log_gain, size_t sampling_rate, size_t voice_sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, HTS_FrameCallback callback, void *callback_data, double volume, HTS_Audio * audio, HTS_Arena * arena);
 
 /* HTS_GStreamSet_get_total_nsamples: get total number of sample */
 size_t HTS_GStreamSet_get_total_nsamples(HTS_GStreamSet * gss);
@@ -453,6 +507,7 @@ void HTS_GStreamSet_clear(HTS_GStreamSet * gss);
 #define PADEORDER 5
 #define IRLENG    576
 #endif                          /* HTS_EMBEDDED */
+#define MIN_PADEORDER 4         /* lowest pade order with coefficients in HTS_pade */
 
 #define CHECK_LSP_STABILITY_MIN 0.25
 #define CHECK_LSP_STABILITY_NUM 4
@@ -469,17 +524,19 @@ typedef struct _HTS_Vocoder {
    HTS_Boolean is_first;
    size_t stage;                /* Gamma=-1/stage: if stage=0 then Gamma=0 */
    double gamma;                /* Gamma */
+   size_t pade_order;           /* pade order of the MLSA filter (for MCP) */
    HTS_Boolean use_log_gain;    /* log gain flag (for LSP) */
    size_t fprd;                 /* frame shift */
    unsigned long next;          /* temporary variable for random generator */
    HTS_Boolean gauss;           /* flag to use Gaussian noise */
    double rate;                 /* sampling rate */
+   double voice_rate;           /* sampling rate the voice was trained at */
    double pitch_of_curr_point;  /* used in excitation generation */
    double pitch_counter;        /* used in excitation generation */
    double pitch_inc_per_point;  /* used in excitation generation */
-   double *excite_ring_buff;    /* used in excitation generation */
-   size_t excite_buff_size;     /* used in excitation generation */
-   size_t excite_buff_index;    /* used in excitation generation */
+   double *excite_buff;         /* excitation of a frame and the tail that spills into the next one */
+   size_t excite_buff_size;     /* length of the low-pass filter used in excitation generation */
+   size_t excite_tail_size;     /* used in excitation generation */
    unsigned char sw;            /* switch used in random generator */
    int x;                       /* excitation signal */
    double *freqt_buff;          /* used in freqt */
@@ -494,10 +551,14 @@ typedef struct _HTS_Vocoder {
    size_t lsp2lpc_size;         /* buffer size of lsp2lpc */
    double *gc2gc_buff;          /* used in gc2gc */
    size_t gc2gc_size;           /* buffer size for gc2gc */
+   double *band_mcp;            /* maps mel-cepstrum of the voice band to the output band */
+   double *band_lpf;            /* maps low-pass filter of the voice band to the output band */
+   double *band_buff;           /* mel-cepstrum and low-pass filter of the output band */
+   double band_gain;            /* log gain between the voice band and the output band */
 } HTS_Vocoder;
 
 /* HTS_Vocoder_initialize: initialize vocoder */
-void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, HTS_Boolean use_log_gain, size_t rate, size_t fperiod);
+void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, size_t pade_order, HTS_Boolean use_log_gain, size_t rate, size_t voice_rate, size_t fperiod);
 
 /* HTS_Vocoder_synthesize: pulse/noise excitation and MLSA/MGLSA filster based waveform synthesis */
 void HTS_Vocoder_synthesize(HTS_Vocoder * v, size_t m, double lf0, double *spectrum, size_t nlpf, double *lpf, double alpha, double beta, double volume, double *rawdata, HTS_Audio * audio);
@@ -57,6 +57,7 @@ HTS_LABEL_C_START;
 
 #include <stdlib.h>             /* for atof() */
 #include <ctype.h>              /* for isgraph(),isdigit() */
+#include <string.h>             /* for memcpy() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -76,6 +77,8 @@ void HTS_Label_initialize(HTS_Label * label)
 {
    label->head = NULL;
    label->size = 0;
+   label->format = NULL;
+   label->arena = NULL;
 }
 
 /* HTS_Label_check_time: check label */
@@ -103,7 +106,7 @@ static void HTS_Label_check_time(HTS_Label * label)
 }
 
 /* HTS_Label_load: load label */
-static void HTS_Label_load(HTS_Label * label, size_t sampling_rate, size_t fperiod, HTS_File * fp)
+static void HTS_Label_load(HTS_Label * label, size_t sampling_rate, size_t fperiod, HTS_File * fp, HTS_Arena * arena)
 {
    char buff[HTS_MAXBUFLEN];
    HTS_LabelString *lstring = NULL;
@@ -122,10 +125,10 @@ static void HTS_Label_load(HTS_Label * label, size_t sampling_rate, size_t fperi
       label->size++;
 
       if (lstring) {
-         lstring->next = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring->next = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
          lstring = lstring->next;
       } else {                  /* first time */
-         lstring = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
          label->head = lstring;
       }
       if (isdigit_string(buff)) {       /* has frame infomation */
@@ -140,21 +143,21 @@ static void HTS_Label_load(HTS_Label * label, size_t sampling_rate, size_t fperi
          lstring->end = -1.0;
       }
       lstring->next = NULL;
-      lstring->name = HTS_strdup(buff);
+      lstring->name = HTS_Arena_strdup(arena, buff);
    }
    HTS_Label_check_time(label);
 }
 
 /* HTS_Label_load_from_fn: load label from file name */
-void HTS_Label_load_from_fn(HTS_Label * label, size_t sampling_rate, size_t fperiod, const char *fn)
+void HTS_Label_load_from_fn(HTS_Label * label, size_t sampling_rate, size_t fperiod, const char *fn, HTS_Arena * arena)
 {
    HTS_File *fp = HTS_fopen_from_fn(fn, "r");
-   HTS_Label_load(label, sampling_rate, fperiod, fp);
+   HTS_Label_load(label, sampling_rate, fperiod, fp, arena);
    HTS_fclose(fp);
 }
 
 /* HTS_Label_load_from_strings: load label from strings */
-void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t fperiod, char **lines, size_t num_lines)
+void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t fperiod, char **lines, size_t num_lines, HTS_Arena * arena)
 {
    char buff[HTS_MAXBUFLEN];
    HTS_LabelString *lstring = NULL;
@@ -174,10 +177,10 @@ void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t
       label->size++;
 
       if (lstring) {
-         lstring->next = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring->next = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
          lstring = lstring->next;
       } else {                  /* first time */
-         lstring = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
          label->head = lstring;
       }
       data_index = 0;
@@ -187,13 +190,13 @@ void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t
          HTS_get_token_from_string(lines[i], &data_index, buff);
          end = atof(buff);
          HTS_get_token_from_string(lines[i], &data_index, buff);
-         lstring->name = HTS_strdup(buff);
+         lstring->name = HTS_Arena_strdup(arena, buff);
          lstring->start = rate * start;
          lstring->end = rate * end;
       } else {
          lstring->start = -1.0;
          lstring->end = -1.0;
-         lstring->name = HTS_strdup(lines[i]);
+         lstring->name = HTS_Arena_strdup(arena, lines[i]);
       }
       lstring->next = NULL;
    }
@@ -201,6 +204,63 @@ void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t
 }
 
 /* HTS_Label_get_size: get number of label string */
+void HTS_Label_load_from_contexts(HTS_Label * label, const HTS_ContextFormat * format, const HTS_ContextValue * context, size_t num_labels, HTS_Arena * arena)
+{
+   HTS_LabelString *lstring = NULL;
+   size_t i;
+
+   if (label->head || label->size != 0) {
+      HTS_error(1, "HTS_Label_load_from_contexts: label list is not initialized.\n");
+      return;
+   }
+   label->format = format;
+   label->arena = arena;
+   /* copy fields, the string form is made only when asked for */
+   for (i = 0; i < num_labels; i++) {
+      label->size++;
+
+      if (lstring) {
+         lstring->next = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
+         lstring = lstring->next;
+      } else {                  /* first time */
+         lstring = (HTS_LabelString *) HTS_Arena_calloc(arena, 1, sizeof(HTS_LabelString));
+         label->head = lstring;
+      }
+      lstring->start = -1.0;
+      lstring->end = -1.0;
+      lstring->name = NULL;
+      lstring->context = (HTS_ContextValue *) HTS_Arena_calloc(arena, format->nfield, sizeof(HTS_ContextValue));
+      memcpy(lstring->context, &context[i * format->nfield], format->nfield * sizeof(HTS_ContextValue));
+      lstring->next = NULL;
+   }
+   HTS_Label_check_time(label);
+}
+
+static char *HTS_Label_format(HTS_Label * label, const HTS_ContextValue * context)
+{
+   char buff[HTS_MAXBUFLEN];
+   size_t i;
+   size_t length = 0;
+   int n;
+   const HTS_ContextField *field;
+
+   buff[0] = '\0';
+   for (i = 0; i < label->format->nfield && length < HTS_MAXBUFLEN; i++) {
+      field = &label->format->field[i];
+      if (field->type == HTS_CONTEXT_STRING)
+         n = snprintf(&buff[length], HTS_MAXBUFLEN - length, "%s%s", field->prefix, context[i].string);
+      else if (context[i].integer == HTS_CONTEXT_UNDEFINED)
+         n = snprintf(&buff[length], HTS_MAXBUFLEN - length, "%sxx", field->prefix);
+      else
+         n = snprintf(&buff[length], HTS_MAXBUFLEN - length, "%s%d", field->prefix, context[i].integer);
+      if (n < 0)
+         break;
+      length += (size_t) n;
+   }
+
+   return HTS_Arena_strdup(label->arena, buff);
+}
+
 size_t HTS_Label_get_size(HTS_Label * label)
 {
    return label->size;
@@ -216,9 +276,23 @@ const char *HTS_Label_get_string(HTS_Label * label, size_t index)
       lstring = lstring->next;
    if (!lstring)
       return NULL;
+   if (lstring->name == NULL && lstring->context != NULL)
+      lstring->name = HTS_Label_format(label, lstring->context);
    return lstring->name;
 }
 
+const HTS_ContextValue *HTS_Label_get_context(HTS_Label * label, size_t index)
+{
+   size_t i;
+   HTS_LabelString *lstring = label->head;
+
+   for (i = 0; i < index && lstring; i++)
+      lstring = lstring->next;
+   if (!lstring)
+      return NULL;
+   return lstring->context;
+}
+
 /* HTS_Label_get_start_frame: get start frame */
 double HTS_Label_get_start_frame(HTS_Label * label, size_t index)
 {
@@ -245,16 +319,9 @@ double HTS_Label_get_end_frame(HTS_Label * label, size_t index)
    return lstring->end;
 }
 
-/* HTS_Label_clear: free label */
+/* HTS_Label_clear: free label (memory is owned by the arena) */
 void HTS_Label_clear(HTS_Label * label)
 {
-   HTS_LabelString *lstring, *next_lstring;
-
-   for (lstring = label->head; lstring; lstring = next_lstring) {
-      next_lstring = lstring->next;
-      HTS_free(lstring->name);
-      HTS_free(lstring);
-   }
    HTS_Label_initialize(label);
 }
 
@@ -66,9 +66,22 @@ HTS_MISC_C_START;
 #include "EST_walloc.h"
 #endif                          /* FESTIVAL */
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>              /* for open() */
+#include <sys/mman.h>           /* for mmap(),munmap() */
+#include <sys/stat.h>           /* for fstat() */
+#include <unistd.h>             /* for close() */
+#endif                          /* _WIN32 */
+
 #define HTS_FILE  0
 #define HTS_DATA  1
 
+#define HTS_ARENA_ALIGNMENT      16
+#define HTS_ARENA_MIN_BLOCK_SIZE 65536
+#define HTS_ARENA_HEADER_SIZE    ((sizeof(HTS_ArenaBlock) + HTS_ARENA_ALIGNMENT - 1) & ~((size_t) HTS_ARENA_ALIGNMENT - 1))
+
 typedef struct _HTS_Data {
    unsigned char *data;
    size_t size;
@@ -585,6 +598,203 @@ void HTS_free_matrix(double **p, size_t x)
    HTS_free(p);
 }
 
+/* HTS_Arena_block_new: allocate arena block with data size */
+static HTS_ArenaBlock *HTS_Arena_block_new(size_t size)
+{
+   HTS_ArenaBlock *block = (HTS_ArenaBlock *) HTS_calloc(1, HTS_ARENA_HEADER_SIZE + size);
+
+   block->next = NULL;
+   block->size = size;
+   block->used = 0;
+   return block;
+}
+
+/* HTS_Arena_initialize: initialize arena */
+void HTS_Arena_initialize(HTS_Arena * arena)
+{
+   arena->block = NULL;
+   arena->capacity = 0;
+}
+
+/* HTS_Arena_calloc: allocate zero-filled memory from arena */
+void *HTS_Arena_calloc(HTS_Arena * arena, const size_t num, const size_t size)
+{
+   size_t n = (num * size + HTS_ARENA_ALIGNMENT - 1) & ~((size_t) HTS_ARENA_ALIGNMENT - 1);
+   size_t block_size;
+   HTS_ArenaBlock *block;
+   void *mem;
+
+   if (n == 0)
+      return NULL;
+
+   block = arena->block;
+   if (block == NULL || block->used + n > block->size) {
+      /* grow geometrically, previous blocks stay valid until reset */
+      block_size = arena->capacity > HTS_ARENA_MIN_BLOCK_SIZE ? arena->capacity : HTS_ARENA_MIN_BLOCK_SIZE;
+      if (block_size < n)
+         block_size = n;
+      block = HTS_Arena_block_new(block_size);
+      block->next = arena->block;
+      arena->block = block;
+      arena->capacity += block_size;
+   }
+
+   mem = (char *) block + HTS_ARENA_HEADER_SIZE + block->used;
+   block->used += n;
+   memset(mem, 0, n);
+   return mem;
+}
+
+/* HTS_Arena_strdup: copy string into arena */
+char *HTS_Arena_strdup(HTS_Arena * arena, const char *string)
+{
+   char *buff = (char *) HTS_Arena_calloc(arena, strlen(string) + 1, sizeof(char));
+   strcpy(buff, string);
+   return buff;
+}
+
+/* HTS_Arena_alloc_matrix: allocate double matrix from arena */
+double **HTS_Arena_alloc_matrix(HTS_Arena * arena, size_t x, size_t y)
+{
+   size_t i;
+   double **p;
+
+   if (x == 0 || y == 0)
+      return NULL;
+
+   p = (double **) HTS_Arena_calloc(arena, x, sizeof(double *));
+   p[0] = (double *) HTS_Arena_calloc(arena, x * y, sizeof(double));
+   for (i = 1; i < x; i++)
+      p[i] = p[i - 1] + y;
+   return p;
+}
+
+/* HTS_Arena_mark: get current position of arena */
+void HTS_Arena_mark(HTS_Arena * arena, HTS_ArenaMark * mark)
+{
+   mark->block = arena->block;
+   mark->used = arena->block != NULL ? arena->block->used : 0;
+}
+
+/* HTS_Arena_rewind: release allocations made after mark */
+void HTS_Arena_rewind(HTS_Arena * arena, const HTS_ArenaMark * mark)
+{
+   HTS_ArenaBlock *block;
+
+   /* blocks added after mark are newer than the marked one */
+   while (arena->block != NULL && arena->block != mark->block) {
+      block = arena->block;
+      arena->block = block->next;
+      arena->capacity -= block->size;
+      HTS_free(block);
+   }
+   if (arena->block != NULL)
+      arena->block->used = mark->used;
+}
+
+/* HTS_Arena_reset: release all allocations but keep capacity */
+void HTS_Arena_reset(HTS_Arena * arena)
+{
+   HTS_ArenaBlock *block, *next;
+   size_t capacity = arena->capacity;
+
+   if (arena->block == NULL)
+      return;
+
+   if (arena->block->next == NULL) {
+      arena->block->used = 0;
+      return;
+   }
+
+   /* merge into a single block of the high-water size */
+   for (block = arena->block; block; block = next) {
+      next = block->next;
+      HTS_free(block);
+   }
+   arena->block = HTS_Arena_block_new(capacity);
+   arena->capacity = capacity;
+}
+
+/* HTS_Arena_clear: free arena */
+void HTS_Arena_clear(HTS_Arena * arena)
+{
+   HTS_ArenaBlock *block, *next;
+
+   for (block = arena->block; block; block = next) {
+      next = block->next;
+      HTS_free(block);
+   }
+   HTS_Arena_initialize(arena);
+}
+
+/* HTS_mmap: map file into memory (read-only) */
+void *HTS_mmap(const char *name, size_t * size)
+{
+#ifdef _WIN32
+   HANDLE file, mapping;
+   LARGE_INTEGER file_size;
+   void *data;
+
+   file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (file == INVALID_HANDLE_VALUE) {
+      HTS_error(0, "HTS_mmap: Cannot open %s.\n", name);
+      return NULL;
+   }
+   if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+      CloseHandle(file);
+      return NULL;
+   }
+   mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   CloseHandle(file);
+   if (mapping == NULL) {
+      HTS_error(0, "HTS_mmap: Cannot map %s.\n", name);
+      return NULL;
+   }
+   data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(mapping);
+   if (data == NULL) {
+      HTS_error(0, "HTS_mmap: Cannot map %s.\n", name);
+      return NULL;
+   }
+   *size = (size_t) file_size.QuadPart;
+   return data;
+#else
+   int fd;
+   struct stat st;
+   void *data;
+
+   fd = open(name, O_RDONLY);
+   if (fd < 0) {
+      HTS_error(0, "HTS_mmap: Cannot open %s.\n", name);
+      return NULL;
+   }
+   if (fstat(fd, &st) < 0 || st.st_size == 0) {
+      close(fd);
+      return NULL;
+   }
+   data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (data == MAP_FAILED) {
+      HTS_error(0, "HTS_mmap: Cannot map %s.\n", name);
+      return NULL;
+   }
+   *size = (size_t) st.st_size;
+   return data;
+#endif                          /* _WIN32 */
+}
+
+/* HTS_munmap: unmap file mapped by HTS_mmap */
+void HTS_munmap(void *data, size_t size)
+{
+   if (data == NULL)
+      return;
+#ifdef _WIN32
+   UnmapViewOfFile(data);
+#else
+   munmap(data, size);
+#endif                          /* _WIN32 */
+}
+
 /* HTS_error: output error message */
 void HTS_error(int error, const char *message, ...)
 {
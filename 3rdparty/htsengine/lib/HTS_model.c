@@ -64,10 +64,50 @@ HTS_MODEL_C_START;
 
 #ifdef WIN32
 typedef unsigned __int32 uint32_t;
+typedef unsigned __int64 uint64_t;
 #else
 #include <stdint.h>
 #endif                          /* WIN32 */
 
+/* voice image format */
+#define HTS_IMAGE_MAGIC      "HTSVIMG"
+#define HTS_IMAGE_VERSION    2
+#define HTS_CHECKSUM_BASIS   14695981039346656037ULL
+#define HTS_IMAGE_BYTE_ORDER 0x01020304
+#define HTS_IMAGE_ALIGNMENT  64
+
+/* HTS_ModelBuffer: capacity of model arrays while loading from text */
+typedef struct _HTS_ModelBuffer {
+   size_t tree;
+   size_t node;
+   size_t question;
+   size_t pattern;
+   size_t string;
+   int *number;                 /* node numbers used in tree file */
+   size_t number_size;
+} HTS_ModelBuffer;
+
+/* HTS_grow: make room for at least n elements, doubling the capacity */
+static void *HTS_grow(void *p, size_t * capacity, size_t n, size_t size)
+{
+   size_t new_capacity;
+   void *q;
+
+   if (n <= *capacity)
+      return p;
+   new_capacity = *capacity > 0 ? *capacity * 2 : 16;
+   while (new_capacity < n)
+      new_capacity *= 2;
+   q = HTS_calloc(new_capacity, size);
+   if (p != NULL) {
+      memcpy(q, p, *capacity * size);
+      HTS_free(p);
+   }
+   *capacity = new_capacity;
+
+   return q;
+}
+
 /* HTS_dp_match: recursive matching */
 static HTS_Boolean HTS_dp_match(const char *string, const char *pattern, size_t pos, size_t max)
 {
@@ -89,39 +129,30 @@ static HTS_Boolean HTS_dp_match(const char *string, const char *pattern, size_t
    return FALSE;
 }
 
-/* HTS_pattern_match: pattern matching function */
-static HTS_Boolean HTS_pattern_match(const char *string, const char *pattern)
+/* HTS_Pattern_match: match label against precompiled pattern */
+static HTS_Boolean HTS_Pattern_match(const HTS_Model * model, size_t index, const char *string, const HTS_ContextValue * context)
 {
-   size_t i, j;
-   size_t buff_length, max = 0, nstar = 0, nquestion = 0;
-   char buff[HTS_MAXBUFLEN];
-   size_t pattern_length = strlen(pattern);
-
-   for (i = 0; i < pattern_length; i++) {
-      switch (pattern[i]) {
-      case '*':
-         nstar++;
-         break;
-      case '?':
-         nquestion++;
-         max++;
-         break;
-      default:
-         max++;
-      }
-   }
-   if (nstar == 2 && nquestion == 0 && pattern[0] == '*' && pattern[i - 1] == '*') {
-      /* only string matching is required */
-      buff_length = i - 2;
-      for (i = 0, j = 1; i < buff_length; i++, j++)
-         buff[i] = pattern[j];
-      buff[buff_length] = '\0';
-      if (strstr(string, buff) != NULL)
+   size_t length;
+   const HTS_Pattern *pattern = &model->pattern[index];
+   const HTS_PatternField *field;
+   const char *p = &model->string[pattern->string];
+
+   if (context != NULL && model->field != NULL && model->field[index].field != HTS_PATTERN_STRING) {
+      field = &model->field[index];
+      if (field->field == HTS_PATTERN_ANY)
          return TRUE;
-      else
-         return FALSE;
-   } else
-      return HTS_dp_match(string, pattern, 0, strlen(string) - max);
+      if (field->length == 0)
+         return context[field->field].integer == field->integer ? TRUE : FALSE;
+      return strncmp(context[field->field].string, &model->string[field->string], field->length) == 0 && context[field->field].string[field->length] == '\0' ? TRUE : FALSE;
+   }
+
+   if (pattern->is_substring)
+      return strstr(string, p) != NULL ? TRUE : FALSE;
+
+   length = strlen(string);
+   if (length < pattern->length)
+      return FALSE;
+   return HTS_dp_match(string, p, 0, length - pattern->length);
 }
 
 /* HTS_is_num: check given buffer is number or not */
@@ -165,168 +196,146 @@ static size_t HTS_get_state_num(const char *string)
    return (size_t) atoi(left);
 }
 
-/* HTS_Question_initialize: initialize question */
-static void HTS_Question_initialize(HTS_Question * question)
+/* HTS_Model_add_string: add string to string pool and return its offset */
+static unsigned int HTS_Model_add_string(HTS_Model * model, HTS_ModelBuffer * buffer, const char *string, size_t length)
 {
-   question->string = NULL;
-   question->head = NULL;
-   question->next = NULL;
+   unsigned int offset = (unsigned int) model->string_size;
+
+   model->string = (char *) HTS_grow(model->string, &buffer->string, model->string_size + length + 1, sizeof(char));
+   memcpy(&model->string[offset], string, length);
+   model->string[offset + length] = '\0';
+   model->string_size += length + 1;
+
+   return offset;
 }
 
-/* HTS_Question_clear: clear loaded question */
-static void HTS_Question_clear(HTS_Question * question)
+/* HTS_Model_add_pattern: precompile pattern and add it to pattern list */
+static void HTS_Model_add_pattern(HTS_Model * model, HTS_ModelBuffer * buffer, const char *string)
 {
-   HTS_Pattern *pattern, *next_pattern;
+   size_t i;
+   size_t length = strlen(string);
+   size_t nstar = 0, nquestion = 0;
+   HTS_Pattern *pattern;
+
+   for (i = 0; i < length; i++) {
+      if (string[i] == '*')
+         nstar++;
+      else if (string[i] == '?')
+         nquestion++;
+   }
 
-   if (question->string != NULL)
-      HTS_free(question->string);
-   for (pattern = question->head; pattern; pattern = next_pattern) {
-      next_pattern = pattern->next;
-      HTS_free(pattern->string);
-      HTS_free(pattern);
+   model->pattern = (HTS_Pattern *) HTS_grow(model->pattern, &buffer->pattern, model->npattern + 1, sizeof(HTS_Pattern));
+   pattern = &model->pattern[model->npattern++];
+   pattern->length = (unsigned int) (length - nstar);
+   if (nstar == 2 && nquestion == 0 && string[0] == '*' && string[length - 1] == '*') {
+      /* only string matching is required */
+      pattern->is_substring = TRUE;
+      pattern->string = HTS_Model_add_string(model, buffer, string + 1, length - 2);
+   } else {
+      pattern->is_substring = FALSE;
+      pattern->string = HTS_Model_add_string(model, buffer, string, length);
    }
-   HTS_Question_initialize(question);
 }
 
 /* HTS_Question_load: Load questions from file */
-static HTS_Boolean HTS_Question_load(HTS_Question * question, HTS_File * fp)
+static HTS_Boolean HTS_Question_load(HTS_Model * model, HTS_ModelBuffer * buffer, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Pattern *pattern, *last_pattern;
+   HTS_Question *question;
 
-   if (question == NULL || fp == NULL)
+   if (model == NULL || fp == NULL)
       return FALSE;
 
-   HTS_Question_clear(question);
-
    /* get question name */
    if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   question->string = HTS_strdup(buff);
+   model->question = (HTS_Question *) HTS_grow(model->question, &buffer->question, model->nquestion + 1, sizeof(HTS_Question));
+   question = &model->question[model->nquestion];
+   question->string = HTS_Model_add_string(model, buffer, buff, strlen(buff));
+   question->head = (unsigned int) model->npattern;
+   question->npattern = 0;
 
    /* get pattern list */
-   if (HTS_get_pattern_token(fp, buff) == FALSE) {
-      HTS_Question_clear(question);
+   if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   }
 
-   last_pattern = NULL;
    if (strcmp(buff, "{") == 0) {
       while (1) {
-         if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Question_clear(question);
+         if (HTS_get_pattern_token(fp, buff) == FALSE)
             return FALSE;
-         }
-         pattern = (HTS_Pattern *) HTS_calloc(1, sizeof(HTS_Pattern));
-         if (question->head != NULL)
-            last_pattern->next = pattern;
-         else                   /* first time */
-            question->head = pattern;
-         pattern->string = HTS_strdup(buff);
-         pattern->next = NULL;
-         if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Question_clear(question);
+         HTS_Model_add_pattern(model, buffer, buff);
+         question->npattern++;
+         if (HTS_get_pattern_token(fp, buff) == FALSE)
             return FALSE;
-         }
          if (!strcmp(buff, "}"))
             break;
-         last_pattern = pattern;
       }
    }
+   model->nquestion++;
+
    return TRUE;
 }
 
-/* HTS_Question_match: check given string match given question */
-static HTS_Boolean HTS_Question_match(HTS_Question * question, const char *string)
+/* HTS_Question_match: check given label match given question */
+static HTS_Boolean HTS_Question_match(const HTS_Model * model, const HTS_Question * question, const char *string, const HTS_ContextValue * context)
 {
-   HTS_Pattern *pattern;
+   size_t i;
 
-   for (pattern = question->head; pattern; pattern = pattern->next)
-      if (HTS_pattern_match(string, pattern->string))
+   for (i = 0; i < question->npattern; i++)
+      if (HTS_Pattern_match(model, question->head + i, string, context))
          return TRUE;
 
    return FALSE;
 }
 
 /* HTS_Question_find: find question from question list */
-static HTS_Question *HTS_Question_find(HTS_Question * question, const char *string)
+static int HTS_Question_find(const HTS_Model * model, const char *string)
 {
-   for (; question; question = question->next)
-      if (strcmp(string, question->string) == 0)
-         return question;
+   size_t i;
 
-   return NULL;
-}
+   for (i = 0; i < model->nquestion; i++)
+      if (strcmp(string, &model->string[model->question[i].string]) == 0)
+         return (int) i;
 
-/* HTS_Node_initialzie: initialize node */
-static void HTS_Node_initialize(HTS_Node * node)
-{
-   node->index = 0;
-   node->pdf = 0;
-   node->yes = NULL;
-   node->no = NULL;
-   node->next = NULL;
-   node->quest = NULL;
+   return -1;
 }
 
-/* HTS_Node_clear: recursive function to free node */
-static void HTS_Node_clear(HTS_Node * node)
+/* HTS_Node_add: add leaf node with given number */
+static unsigned int HTS_Node_add(HTS_Model * model, HTS_ModelBuffer * buffer, int num)
 {
-   if (node->yes != NULL) {
-      HTS_Node_clear(node->yes);
-      HTS_free(node->yes);
-   }
-   if (node->no != NULL) {
-      HTS_Node_clear(node->no);
-      HTS_free(node->no);
-   }
-   HTS_Node_initialize(node);
-}
+   HTS_Node *node;
 
-/* HTS_Node_find: find node for given number */
-static HTS_Node *HTS_Node_find(HTS_Node * node, int num)
-{
-   for (; node; node = node->next)
-      if (node->index == num)
-         return node;
+   model->node = (HTS_Node *) HTS_grow(model->node, &buffer->node, model->nnode + 1, sizeof(HTS_Node));
+   buffer->number = (int *) HTS_grow(buffer->number, &buffer->number_size, model->nnode + 1, sizeof(int));
+   node = &model->node[model->nnode];
+   node->quest = -1;
+   node->pdf = 0;
+   node->yes = 0;
+   node->no = 0;
+   buffer->number[model->nnode] = num;
 
-   return NULL;
+   return (unsigned int) model->nnode++;
 }
 
-/* HTS_Tree_initialize: initialize tree */
-static void HTS_Tree_initialize(HTS_Tree * tree)
+/* HTS_Node_find: find node for given number in nodes of current tree */
+static int HTS_Node_find(const HTS_Model * model, const HTS_ModelBuffer * buffer, size_t root, int num)
 {
-   tree->head = NULL;
-   tree->next = NULL;
-   tree->root = NULL;
-   tree->state = 0;
-}
+   size_t i;
 
-/* HTS_Tree_clear: clear given tree */
-static void HTS_Tree_clear(HTS_Tree * tree)
-{
-   HTS_Pattern *pattern, *next_pattern;
+   for (i = model->nnode; i > root; i--)
+      if (buffer->number[i - 1] == num)
+         return (int) (i - 1);
 
-   for (pattern = tree->head; pattern; pattern = next_pattern) {
-      next_pattern = pattern->next;
-      HTS_free(pattern->string);
-      HTS_free(pattern);
-   }
-   if (tree->root != NULL) {
-      HTS_Node_clear(tree->root);
-      HTS_free(tree->root);
-   }
-   HTS_Tree_initialize(tree);
+   return -1;
 }
 
 /* HTS_Tree_parse_pattern: parse pattern specified for each tree */
-static void HTS_Tree_parse_pattern(HTS_Tree * tree, char *string)
+static void HTS_Tree_parse_pattern(HTS_Model * model, HTS_ModelBuffer * buffer, HTS_Tree * tree, char *string)
 {
    char *left, *right;
-   HTS_Pattern *pattern, *last_pattern;
 
-   tree->head = NULL;
-   last_pattern = NULL;
+   tree->head = (unsigned int) model->npattern;
+   tree->npattern = 0;
    /* parse tree pattern */
    if ((left = strchr(string, '{')) != NULL) {  /* pattern is specified */
       string = left + 1;
@@ -340,117 +349,233 @@ static void HTS_Tree_parse_pattern(HTS_Tree * tree, char *string)
 
       /* parse pattern */
       while ((left = strchr(string, ',')) != NULL) {
-         pattern = (HTS_Pattern *) HTS_calloc(1, sizeof(HTS_Pattern));
-         if (tree->head) {
-            last_pattern->next = pattern;
-         } else {
-            tree->head = pattern;
-         }
          *left = '\0';
-         pattern->string = HTS_strdup(string);
+         HTS_Model_add_pattern(model, buffer, string);
+         tree->npattern++;
          string = left + 1;
-         pattern->next = NULL;
-         last_pattern = pattern;
       }
    }
 }
 
 /* HTS_Tree_load: load trees */
-static HTS_Boolean HTS_Tree_load(HTS_Tree * tree, HTS_File * fp, HTS_Question * question)
+static HTS_Boolean HTS_Tree_load(HTS_Model * model, HTS_ModelBuffer * buffer, HTS_Tree * tree, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Node *node, *last_node;
+   int index, quest;
+   unsigned int yes, no;
+   HTS_Boolean result = TRUE;
 
    if (tree == NULL || fp == NULL)
       return FALSE;
 
-   if (HTS_get_pattern_token(fp, buff) == FALSE) {
-      HTS_Tree_clear(tree);
+   if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   }
-   node = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
-   HTS_Node_initialize(node);
-   tree->root = last_node = node;
+   tree->root = HTS_Node_add(model, buffer, 0);
 
    if (strcmp(buff, "{") == 0) {
       while (HTS_get_pattern_token(fp, buff) == TRUE && strcmp(buff, "}") != 0) {
-         node = HTS_Node_find(last_node, atoi(buff));
-         if (node == NULL) {
+         index = HTS_Node_find(model, buffer, tree->root, atoi(buff));
+         if (index < 0) {
             HTS_error(0, "HTS_Tree_load: Cannot find node %d.\n", atoi(buff));
-            HTS_Tree_clear(tree);
-            return FALSE;
+            result = FALSE;
+            break;
          }
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Tree_clear(tree);
-            return FALSE;
+            result = FALSE;
+            break;
          }
-         node->quest = HTS_Question_find(question, buff);
-         if (node->quest == NULL) {
+         quest = HTS_Question_find(model, buff);
+         if (quest < 0) {
             HTS_error(0, "HTS_Tree_load: Cannot find question %s.\n", buff);
-            HTS_Tree_clear(tree);
-            return FALSE;
+            result = FALSE;
+            break;
          }
-         node->yes = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
-         node->no = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
-         HTS_Node_initialize(node->yes);
-         HTS_Node_initialize(node->no);
 
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            node->quest = NULL;
-            free(node->yes);
-            free(node->no);
-            HTS_Tree_clear(tree);
-            return FALSE;
+            result = FALSE;
+            break;
          }
+         no = HTS_Node_add(model, buffer, 0);
          if (HTS_is_num(buff))
-            node->no->index = atoi(buff);
+            buffer->number[no] = atoi(buff);
          else
-            node->no->pdf = HTS_name2num(buff);
-         node->no->next = last_node;
-         last_node = node->no;
+            model->node[no].pdf = (unsigned int) HTS_name2num(buff);
 
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            node->quest = NULL;
-            free(node->yes);
-            free(node->no);
-            HTS_Tree_clear(tree);
-            return FALSE;
+            result = FALSE;
+            break;
          }
+         yes = HTS_Node_add(model, buffer, 0);
          if (HTS_is_num(buff))
-            node->yes->index = atoi(buff);
+            buffer->number[yes] = atoi(buff);
          else
-            node->yes->pdf = HTS_name2num(buff);
-         node->yes->next = last_node;
-         last_node = node->yes;
+            model->node[yes].pdf = (unsigned int) HTS_name2num(buff);
+
+         model->node[index].quest = quest;
+         model->node[index].no = no;
+         model->node[index].yes = yes;
       }
    } else {
-      node->pdf = HTS_name2num(buff);
+      model->node[tree->root].pdf = (unsigned int) HTS_name2num(buff);
    }
 
-   return TRUE;
+   return result;
 }
 
-/* HTS_Node_search: tree search */
-static size_t HTS_Tree_search_node(HTS_Tree * tree, const char *string)
+/* HTS_Tree_search_node: tree search */
+static size_t HTS_Tree_search_node(const HTS_Model * model, const HTS_Tree * tree, const char *string, const HTS_ContextValue * context)
 {
-   HTS_Node *node = tree->root;
+   const HTS_Node *node = &model->node[tree->root];
 
-   while (node != NULL) {
-      if (node->quest == NULL)
-         return node->pdf;
-      if (HTS_Question_match(node->quest, string)) {
-         if (node->yes->pdf > 0)
-            return node->yes->pdf;
-         node = node->yes;
-      } else {
-         if (node->no->pdf > 0)
-            return node->no->pdf;
-         node = node->no;
+   while (node->quest >= 0) {
+      if (HTS_Question_match(model, &model->question[node->quest], string, context))
+         node = &model->node[node->yes];
+      else
+         node = &model->node[node->no];
+   }
+
+   return node->pdf;
+}
+
+/* HTS_is_context_value: check given value can be written for field of given type */
+static HTS_Boolean HTS_is_context_value(const char *value, size_t length, int type, int *integer)
+{
+   size_t i = 0;
+   int n = 0;
+
+   if (length == 0)
+      return FALSE;
+   if (type == HTS_CONTEXT_STRING) {
+      for (i = 0; i < length; i++)
+         if (!isalnum((int) value[i]))
+            return FALSE;
+      return TRUE;
+   }
+   if (length == 2 && value[0] == 'x' && value[1] == 'x') {
+      *integer = HTS_CONTEXT_UNDEFINED;
+      return TRUE;
+   }
+   if (value[0] == '-') {
+      if (type != HTS_CONTEXT_SIGNED)
+         return FALSE;
+      i++;
+   }
+   /* only what "%d" writes */
+   if (i == length || (value[i] == '0' && (length > i + 1 || i > 0)) || length - i > 9)
+      return FALSE;
+   for (; i < length; i++) {
+      if (!isdigit((int) value[i]))
+         return FALSE;
+      n = n * 10 + (value[i] - '0');
+   }
+   *integer = value[0] == '-' ? -n : n;
+
+   return TRUE;
+}
+
+/* HTS_Pattern_compile: find the only field whose value a pattern can match (see HTS_ContextFormat) */
+static void HTS_Pattern_compile(const HTS_Model * model, size_t index, const HTS_ContextFormat * format, HTS_PatternField * field)
+{
+   const HTS_Pattern *pattern = &model->pattern[index];
+   const char *p = &model->string[pattern->string];
+   size_t length = strlen(p);
+   HTS_Boolean head = TRUE, tail = TRUE;
+   const char *prefix, *next;
+   size_t prefix_length, next_length;
+   size_t i, a, b, first;
+   size_t ncandidate = 0;
+   int integer = 0;
+
+   field->field = HTS_PATTERN_STRING;
+   field->integer = 0;
+   field->string = 0;
+   field->length = 0;
+
+   /* strip leading and trailing '*' */
+   if (pattern->is_substring) {
+      head = FALSE;
+      tail = FALSE;
+   } else {
+      if (length > 0 && p[0] == '*') {
+         head = FALSE;
+         p++;
+         length--;
+      }
+      if (length > 0 && p[length - 1] == '*') {
+         tail = FALSE;
+         length--;
+      }
+   }
+   if (length == 0) {
+      if (head == FALSE || tail == FALSE)
+         field->field = HTS_PATTERN_ANY;
+      return;
+   }
+   for (i = 0; i < length; i++)
+      if (p[i] == '*' || p[i] == '?')
+         return;
+
+   /* pattern must be prefix (suffix of it) + value + prefix of next field (head of it) */
+   for (i = 0; i < format->nfield; i++) {
+      if ((head == TRUE && i != 0) || (tail == TRUE && i + 1 != format->nfield))
+         continue;
+      prefix = format->field[i].prefix;
+      next = i + 1 < format->nfield ? format->field[i + 1].prefix : "";
+      prefix_length = strlen(prefix);
+      next_length = strlen(next);
+      /* a signed value may be matched from its sign */
+      first = head == TRUE ? prefix_length : (format->field[i].type == HTS_CONTEXT_SIGNED ? 0 : 1);
+      for (a = first; a <= prefix_length; a++) {
+         /* the delimiters at both ends of the value have to be matched */
+         if (head == FALSE && a > 0 && (isalnum((int) prefix[prefix_length - 1]) || (a < prefix_length && isalnum((int) prefix[prefix_length - a]))))
+            continue;
+         if (head == FALSE && a == 0 && p[0] != '-')
+            continue;
+         if (a > length || strncmp(p, &prefix[prefix_length - a], a) != 0)
+            continue;
+         for (b = tail == TRUE ? 0 : 1; b <= next_length; b++) {
+            if (tail == FALSE && (isalnum((int) next[0]) || (b < next_length && isalnum((int) next[b - 1]))))
+               continue;
+            if (a + b >= length || strncmp(&p[length - b], next, b) != 0)
+               continue;
+            if (HTS_is_context_value(&p[a], length - a - b, format->field[i].type, &integer) == FALSE)
+               continue;
+            if (ncandidate++ > 0)
+               continue;
+            field->field = (int) i;
+            field->integer = integer;
+            if (format->field[i].type == HTS_CONTEXT_STRING) {
+               field->string = (unsigned int) (&p[a] - model->string);
+               field->length = (unsigned int) (length - a - b);
+            }
+         }
       }
    }
+   if (ncandidate != 1)
+      field->field = HTS_PATTERN_STRING;
+}
+
+/* HTS_Model_set_context_format: compile patterns for structured labels, return # of patterns which need string matching */
+static size_t HTS_Model_set_context_format(HTS_Model * model, const HTS_ContextFormat * format)
+{
+   size_t i;
+   size_t nstring = 0;
+
+   if (model->field != NULL) {
+      HTS_free(model->field);
+      model->field = NULL;
+   }
+   if (format == NULL || model->npattern == 0)
+      return 0;
 
-   HTS_error(0, "HTS_Tree_search_node: Cannot find node.\n");
-   return 1;
+   model->field = (HTS_PatternField *) HTS_calloc(model->npattern, sizeof(HTS_PatternField));
+   for (i = 0; i < model->npattern; i++) {
+      HTS_Pattern_compile(model, i, format, &model->field[i]);
+      if (model->field[i].field == HTS_PATTERN_STRING)
+         nstring++;
+   }
+
+   return nstring;
 }
 
 /* HTS_Window_initialize: initialize dynamic window */
@@ -459,6 +584,7 @@ static void HTS_Window_initialize(HTS_Window * win)
    win->size = 0;
    win->l_width = NULL;
    win->r_width = NULL;
+   win->center = NULL;
    win->coefficient = NULL;
    win->max_width = 0;
 }
@@ -466,15 +592,10 @@ static void HTS_Window_initialize(HTS_Window * win)
 /* HTS_Window_clear: free dynamic window */
 static void HTS_Window_clear(HTS_Window * win)
 {
-   size_t i;
-
-   if (win->coefficient != NULL) {
-      for (i = 0; i < win->size; i++) {
-         win->coefficient[i] += win->l_width[i];
-         HTS_free(win->coefficient[i]);
-      }
+   if (win->coefficient != NULL)
       HTS_free(win->coefficient);
-   }
+   if (win->center != NULL)
+      HTS_free(win->center);
    if (win->l_width)
       HTS_free(win->l_width);
    if (win->r_width)
@@ -488,6 +609,7 @@ static HTS_Boolean HTS_Window_load(HTS_Window * win, HTS_File ** fp, size_t size
 {
    size_t i, j;
    size_t fsize, length;
+   size_t ncoefficient = 0, capacity = 0;
    char buff[HTS_MAXBUFLEN];
    HTS_Boolean result = TRUE;
 
@@ -498,7 +620,7 @@ static HTS_Boolean HTS_Window_load(HTS_Window * win, HTS_File ** fp, size_t size
    win->size = size;
    win->l_width = (int *) HTS_calloc(win->size, sizeof(int));
    win->r_width = (int *) HTS_calloc(win->size, sizeof(int));
-   win->coefficient = (double **) HTS_calloc(win->size, sizeof(double *));
+   win->center = (unsigned int *) HTS_calloc(win->size, sizeof(unsigned int));
    /* set delta coefficents */
    for (i = 0; i < win->size; i++) {
       if (HTS_get_token_from_fp(fp[i], buff) == FALSE) {
@@ -512,22 +634,23 @@ static HTS_Boolean HTS_Window_load(HTS_Window * win, HTS_File ** fp, size_t size
          }
       }
       /* read coefficients */
-      win->coefficient[i] = (double *) HTS_calloc(fsize, sizeof(double));
+      win->coefficient = (double *) HTS_grow(win->coefficient, &capacity, ncoefficient + fsize, sizeof(double));
       for (j = 0; j < fsize; j++) {
          if (HTS_get_token_from_fp(fp[i], buff) == FALSE) {
             result = FALSE;
-            win->coefficient[i][j] = 0.0;
+            win->coefficient[ncoefficient + j] = 0.0;
          } else {
-            win->coefficient[i][j] = (double) atof(buff);
+            win->coefficient[ncoefficient + j] = (double) atof(buff);
          }
       }
-      /* set pointer */
+      /* set center */
       length = fsize / 2;
-      win->coefficient[i] += length;
+      win->center[i] = (unsigned int) (ncoefficient + length);
       win->l_width[i] = -1 * (int) length;
       win->r_width[i] = (int) length;
       if (fsize % 2 == 0)
          win->r_width[i]--;
+      ncoefficient += fsize;
    }
    /* calcurate max_width to determine size of band matrix */
    win->max_width = 0;
@@ -552,44 +675,43 @@ static void HTS_Model_initialize(HTS_Model * model)
    model->num_windows = 0;
    model->is_msd = FALSE;
    model->ntree = 0;
+   model->pdf_length = 0;
    model->npdf = NULL;
+   model->pdf_offset = NULL;
    model->pdf = NULL;
    model->tree = NULL;
+   model->node = NULL;
+   model->nnode = 0;
    model->question = NULL;
+   model->nquestion = 0;
+   model->pattern = NULL;
+   model->npattern = 0;
+   model->string = NULL;
+   model->string_size = 0;
+   model->field = NULL;
 }
 
 /* HTS_Model_clear: free pdfs and trees */
 static void HTS_Model_clear(HTS_Model * model)
 {
-   size_t i, j;
-   HTS_Question *question, *next_question;
-   HTS_Tree *tree, *next_tree;
-
-   for (question = model->question; question; question = next_question) {
-      next_question = question->next;
-      HTS_Question_clear(question);
-      HTS_free(question);
-   }
-   for (tree = model->tree; tree; tree = next_tree) {
-      next_tree = tree->next;
-      HTS_Tree_clear(tree);
-      HTS_free(tree);
-   }
-   if (model->pdf) {
-      for (i = 2; i <= model->ntree + 1; i++) {
-         for (j = 1; j <= model->npdf[i]; j++) {
-            HTS_free(model->pdf[i][j]);
-         }
-         model->pdf[i]++;
-         HTS_free(model->pdf[i]);
-      }
-      model->pdf += 2;
-      HTS_free(model->pdf);
-   }
-   if (model->npdf) {
-      model->npdf += 2;
+   if (model->npdf != NULL)
       HTS_free(model->npdf);
-   }
+   if (model->pdf_offset != NULL)
+      HTS_free(model->pdf_offset);
+   if (model->pdf != NULL)
+      HTS_free(model->pdf);
+   if (model->tree != NULL)
+      HTS_free(model->tree);
+   if (model->node != NULL)
+      HTS_free(model->node);
+   if (model->question != NULL)
+      HTS_free(model->question);
+   if (model->pattern != NULL)
+      HTS_free(model->pattern);
+   if (model->string != NULL)
+      HTS_free(model->string);
+   if (model->field != NULL)
+      HTS_free(model->field);
    HTS_Model_initialize(model);
 }
 
@@ -597,9 +719,10 @@ static void HTS_Model_clear(HTS_Model * model)
 static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Question *question, *last_question;
-   HTS_Tree *tree, *last_tree;
+   HTS_ModelBuffer buffer;
+   HTS_Tree *tree;
    size_t state;
+   HTS_Boolean result = TRUE;
 
    /* check */
    if (model == NULL) {
@@ -612,48 +735,37 @@ static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
       return TRUE;
    }
 
+   memset(&buffer, 0, sizeof(buffer));
    model->ntree = 0;
-   last_question = NULL;
-   last_tree = NULL;
    while (!HTS_feof(fp)) {
       HTS_get_pattern_token(fp, buff);
       /* parse questions */
       if (strcmp(buff, "QS") == 0) {
-         question = (HTS_Question *) HTS_calloc(1, sizeof(HTS_Question));
-         HTS_Question_initialize(question);
-         if (HTS_Question_load(question, fp) == FALSE) {
-            free(question);
-            HTS_Model_clear(model);
-            return FALSE;
+         if (HTS_Question_load(model, &buffer, fp) == FALSE) {
+            result = FALSE;
+            break;
          }
-         if (model->question)
-            last_question->next = question;
-         else
-            model->question = question;
-         question->next = NULL;
-         last_question = question;
       }
       /* parse trees */
       state = HTS_get_state_num(buff);
       if (state != 0) {
-         tree = (HTS_Tree *) HTS_calloc(1, sizeof(HTS_Tree));
-         HTS_Tree_initialize(tree);
-         tree->state = state;
-         HTS_Tree_parse_pattern(tree, buff);
-         if (HTS_Tree_load(tree, fp, model->question) == FALSE) {
-            free(tree);
-            HTS_Model_clear(model);
-            return FALSE;
+         model->tree = (HTS_Tree *) HTS_grow(model->tree, &buffer.tree, model->ntree + 1, sizeof(HTS_Tree));
+         tree = &model->tree[model->ntree];
+         tree->state = (unsigned int) state;
+         HTS_Tree_parse_pattern(model, &buffer, tree, buff);
+         if (HTS_Tree_load(model, &buffer, tree, fp) == FALSE) {
+            result = FALSE;
+            break;
          }
-         if (model->tree)
-            last_tree->next = tree;
-         else
-            model->tree = tree;
-         tree->next = NULL;
-         last_tree = tree;
          model->ntree++;
       }
    }
+   if (buffer.number != NULL)
+      HTS_free(buffer.number);
+   if (result == FALSE) {
+      HTS_Model_clear(model);
+      return FALSE;
+   }
    /* No Tree information in tree file */
    if (model->tree == NULL)
       model->ntree = 1;
@@ -665,9 +777,9 @@ static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
 static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, size_t vector_length, size_t num_windows, HTS_Boolean is_msd)
 {
    uint32_t i;
-   size_t j, k;
+   size_t j;
+   size_t total = 0;
    HTS_Boolean result = TRUE;
-   size_t len;
 
    /* check */
    if (model == NULL || fp == NULL || model->ntree <= 0) {
@@ -679,46 +791,36 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, size_t v
    model->vector_length = vector_length;
    model->num_windows = num_windows;
    model->is_msd = is_msd;
-   model->npdf = (size_t *) HTS_calloc(model->ntree, sizeof(size_t));
-   model->npdf -= 2;
+   model->npdf = (unsigned int *) HTS_calloc(model->ntree, sizeof(unsigned int));
+   model->pdf_offset = (unsigned int *) HTS_calloc(model->ntree, sizeof(unsigned int));
    /* read the number of pdfs */
-   for (j = 2; j <= model->ntree + 1; j++) {
+   for (j = 0; j < model->ntree; j++) {
       if (HTS_fread_little_endian(&i, sizeof(i), 1, fp) != 1) {
          result = FALSE;
          break;
       }
-      model->npdf[j] = (size_t) i;
+      model->npdf[j] = (unsigned int) i;
    }
-   for (j = 2; j <= model->ntree + 1; j++) {
+   for (j = 0; j < model->ntree && result == TRUE; j++) {
       if (model->npdf[j] <= 0) {
-         HTS_error(1, "HTS_Model_load_pdf: # of pdfs at %d-th state should be positive.\n", j);
+         HTS_error(1, "HTS_Model_load_pdf: # of pdfs at %d-th state should be positive.\n", j + 2);
          result = FALSE;
          break;
       }
+      model->pdf_offset[j] = (unsigned int) total;
+      total += model->npdf[j];
    }
    if (result == FALSE) {
-      model->npdf += 2;
-      free(model->npdf);
-      HTS_Model_initialize(model);
+      HTS_Model_clear(model);
       return FALSE;
    }
-   model->pdf = (float ***) HTS_calloc(model->ntree, sizeof(float **));
-   model->pdf -= 2;
    /* read means and variances */
    if (is_msd)                  /* for MSD */
-      len = model->vector_length * model->num_windows * 2 + 1;
+      model->pdf_length = model->vector_length * model->num_windows * 2 + 1;
    else
-      len = model->vector_length * model->num_windows * 2;
-   for (j = 2; j <= model->ntree + 1; j++) {
-      model->pdf[j] = (float **) HTS_calloc(model->npdf[j], sizeof(float *));
-      model->pdf[j]--;
-      for (k = 1; k <= model->npdf[j]; k++) {
-         model->pdf[j][k] = (float *) HTS_calloc(len, sizeof(float));
-         if (HTS_fread_little_endian(model->pdf[j][k], sizeof(float), len, fp) != len)
-            result = FALSE;
-      }
-   }
-   if (result == FALSE) {
+      model->pdf_length = model->vector_length * model->num_windows * 2;
+   model->pdf = (float *) HTS_calloc(total * model->pdf_length, sizeof(float));
+   if (HTS_fread_little_endian(model->pdf, sizeof(float), total * model->pdf_length, fp) != total * model->pdf_length) {
       HTS_Model_clear(model);
       return FALSE;
    }
@@ -750,12 +852,11 @@ static HTS_Boolean HTS_Model_load(HTS_Model * model, HTS_File * pdf, HTS_File *
    return TRUE;
 }
 
-
 /* HTS_Model_get_index: get index of tree and PDF */
-static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index)
+static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Tree *tree;
-   HTS_Pattern *pattern;
+   size_t i, j;
+   const HTS_Tree *tree;
    HTS_Boolean find;
 
    (*tree_index) = 2;
@@ -765,13 +866,13 @@ static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const cha
       return;
 
    find = FALSE;
-   for (tree = model->tree; tree; tree = tree->next) {
+   for (i = 0; i < model->ntree; i++) {
+      tree = &model->tree[i];
       if (tree->state == state_index) {
-         pattern = tree->head;
-         if (!pattern)
+         if (tree->npattern == 0)
             find = TRUE;
-         for (; pattern; pattern = pattern->next)
-            if (HTS_pattern_match(string, pattern->string)) {
+         for (j = 0; j < tree->npattern; j++)
+            if (HTS_Pattern_match(model, tree->head + j, string, context)) {
                find = TRUE;
                break;
             }
@@ -781,13 +882,21 @@ static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const cha
       (*tree_index)++;
    }
 
-   if (tree != NULL) {
-      (*pdf_index) = HTS_Tree_search_node(tree, string);
+   if (i < model->ntree) {
+      (*pdf_index) = HTS_Tree_search_node(model, &model->tree[i], string, context);
    } else {
-      (*pdf_index) = HTS_Tree_search_node(model->tree, string);
+      /* PDF index of the first tree must not be used with the offset of a tree past the last one */
+      (*tree_index) = 2;
+      (*pdf_index) = HTS_Tree_search_node(model, &model->tree[0], string, context);
    }
 }
 
+/* HTS_Model_get_pdf: get PDF for given tree and PDF index */
+static const float *HTS_Model_get_pdf(HTS_Model * model, size_t tree_index, size_t pdf_index)
+{
+   return &model->pdf[(model->pdf_offset[tree_index - 2] + pdf_index - 1) * model->pdf_length];
+}
+
 /* HTS_ModelSet_initialize: initialize model set */
 void HTS_ModelSet_initialize(HTS_ModelSet * ms)
 {
@@ -807,12 +916,23 @@ void HTS_ModelSet_initialize(HTS_ModelSet * ms)
    ms->window = NULL;
    ms->stream = NULL;
    ms->gv = NULL;
+
+   ms->image = NULL;
+   ms->image_size = NULL;
+
+   ms->context_format = NULL;
+   ms->context_string = FALSE;
 }
 
 /* HTS_ModelSet_clear: free model set */
 void HTS_ModelSet_clear(HTS_ModelSet * ms)
 {
    size_t i, j;
+   /* arrays of a memory-mapped image belong to the mapping */
+   HTS_Boolean owned = ms->image == NULL ? TRUE : FALSE;
+
+   /* compiled patterns are owned even for a memory-mapped image */
+   HTS_ModelSet_set_context_format(ms, NULL);
 
    if (ms->hts_voice_version != NULL)
       free(ms->hts_voice_version);
@@ -823,7 +943,8 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms)
    if (ms->fullcontext_version != NULL)
       free(ms->fullcontext_version);
    if (ms->gv_off_context != NULL) {
-      HTS_Question_clear(ms->gv_off_context);
+      if (owned)
+         HTS_Model_clear(ms->gv_off_context);
       free(ms->gv_off_context);
    }
    if (ms->option != NULL) {
@@ -834,31 +955,42 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms)
    }
 
    if (ms->duration != NULL) {
-      for (i = 0; i < ms->num_voices; i++)
-         HTS_Model_clear(&ms->duration[i]);
+      if (owned)
+         for (i = 0; i < ms->num_voices; i++)
+            HTS_Model_clear(&ms->duration[i]);
       free(ms->duration);
    }
    if (ms->window != NULL) {
-      for (i = 0; i < ms->num_streams; i++)
-         HTS_Window_clear(&ms->window[i]);
+      if (owned)
+         for (i = 0; i < ms->num_streams; i++)
+            HTS_Window_clear(&ms->window[i]);
       free(ms->window);
    }
    if (ms->stream != NULL) {
       for (i = 0; i < ms->num_voices; i++) {
-         for (j = 0; j < ms->num_streams; j++)
-            HTS_Model_clear(&ms->stream[i][j]);
+         if (owned)
+            for (j = 0; j < ms->num_streams; j++)
+               HTS_Model_clear(&ms->stream[i][j]);
          free(ms->stream[i]);
       }
       HTS_free(ms->stream);
    }
    if (ms->gv != NULL) {
       for (i = 0; i < ms->num_voices; i++) {
-         for (j = 0; j < ms->num_streams; j++)
-            HTS_Model_clear(&ms->gv[i][j]);
+         if (owned)
+            for (j = 0; j < ms->num_streams; j++)
+               HTS_Model_clear(&ms->gv[i][j]);
          free(ms->gv[i]);
       }
       free(ms->gv);
    }
+   if (ms->image != NULL) {
+      for (i = 0; i < ms->num_voices; i++)
+         if (ms->image[i] != NULL)
+            HTS_munmap(ms->image[i], ms->image_size[i]);
+      free(ms->image);
+      free(ms->image_size);
+   }
    HTS_ModelSet_initialize(ms);
 }
 
@@ -939,6 +1071,7 @@ HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voice
    HTS_File *tree_fp = NULL;
    HTS_File **win_fp = NULL;
    HTS_File *gv_off_context_fp = NULL;
+   HTS_ModelBuffer gv_off_context_buffer;
 
    HTS_ModelSet_clear(ms);
 
@@ -1470,9 +1603,10 @@ HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voice
    if (gv_off_context != NULL) {
       sprintf(buff1, "GV-Off { %s }", gv_off_context);
       gv_off_context_fp = HTS_fopen_from_data((void *) buff1, strlen(buff1) + 1);
-      ms->gv_off_context = (HTS_Question *) HTS_calloc(1, sizeof(HTS_Question));
-      HTS_Question_initialize(ms->gv_off_context);
-      HTS_Question_load(ms->gv_off_context, gv_off_context_fp);
+      ms->gv_off_context = (HTS_Model *) HTS_calloc(1, sizeof(HTS_Model));
+      HTS_Model_initialize(ms->gv_off_context);
+      memset(&gv_off_context_buffer, 0, sizeof(gv_off_context_buffer));
+      HTS_Question_load(ms->gv_off_context, &gv_off_context_buffer, gv_off_context_fp);
       HTS_fclose(gv_off_context_fp);
       free(gv_off_context);
    }
@@ -1496,6 +1630,628 @@ HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voice
    return !error;
 }
 
+/* HTS_ImageHeader: header of precompiled voice image */
+typedef struct _HTS_ImageHeader {
+   char magic[8];               /* HTS_IMAGE_MAGIC */
+   uint32_t version;            /* HTS_IMAGE_VERSION */
+   uint32_t byte_order;         /* HTS_IMAGE_BYTE_ORDER in native byte order */
+   uint64_t source_size;        /* size of source .htsvoice */
+   uint64_t source_checksum;    /* FNV-1a checksum of source .htsvoice */
+   uint64_t image_checksum;     /* FNV-1a checksum of image after header */
+} HTS_ImageHeader;
+
+/* HTS_ImageWriter: output stream for voice image */
+typedef struct _HTS_ImageWriter {
+   FILE *fp;
+   size_t index;
+   uint64_t checksum;
+   HTS_Boolean error;
+} HTS_ImageWriter;
+
+/* HTS_ImageReader: input stream over memory-mapped voice image */
+typedef struct _HTS_ImageReader {
+   const unsigned char *data;
+   size_t size;
+   size_t index;
+   HTS_Boolean error;
+} HTS_ImageReader;
+
+/* HTS_update_checksum: add data to FNV-1a checksum */
+static uint64_t HTS_update_checksum(uint64_t h, const void *data, size_t size)
+{
+   const unsigned char *p = (const unsigned char *) data;
+   size_t i;
+
+   for (i = 0; i < size; i++) {
+      h ^= p[i];
+      h *= 1099511628211ULL;
+   }
+
+   return h;
+}
+
+/* HTS_get_checksum_fp: get FNV-1a checksum and size of rest of file */
+static void HTS_get_checksum_fp(FILE * fp, uint64_t * checksum, uint64_t * size)
+{
+   unsigned char buff[HTS_MAXBUFLEN];
+   size_t n;
+
+   *checksum = HTS_CHECKSUM_BASIS;
+   *size = 0;
+   while ((n = fread(buff, 1, sizeof(buff), fp)) > 0) {
+      *checksum = HTS_update_checksum(*checksum, buff, n);
+      *size += n;
+   }
+}
+
+/* HTS_get_checksum: get FNV-1a checksum and size of file */
+static HTS_Boolean HTS_get_checksum(const char *fn, uint64_t * checksum, uint64_t * size)
+{
+   FILE *fp = fopen(fn, "rb");
+
+   if (fp == NULL) {
+      HTS_error(0, "HTS_get_checksum: Cannot open %s.\n", fn);
+      return FALSE;
+   }
+   HTS_get_checksum_fp(fp, checksum, size);
+   fclose(fp);
+
+   return TRUE;
+}
+
+/* HTS_ImageWriter_write: write raw data */
+static void HTS_ImageWriter_write(HTS_ImageWriter * w, const void *data, size_t size)
+{
+   if (size > 0 && fwrite(data, 1, size, w->fp) != size)
+      w->error = TRUE;
+   w->checksum = HTS_update_checksum(w->checksum, data, size);
+   w->index += size;
+}
+
+/* HTS_ImageWriter_pad: write zeros up to given alignment */
+static void HTS_ImageWriter_pad(HTS_ImageWriter * w, size_t alignment)
+{
+   static const char zero[HTS_IMAGE_ALIGNMENT] = { 0 };
+
+   HTS_ImageWriter_write(w, zero, (alignment - w->index % alignment) % alignment);
+}
+
+/* HTS_ImageWriter_write_size: write size value as 64-bit integer */
+static void HTS_ImageWriter_write_size(HTS_ImageWriter * w, size_t value)
+{
+   uint64_t v = (uint64_t) value;
+
+   HTS_ImageWriter_write(w, &v, sizeof(v));
+}
+
+/* HTS_ImageWriter_write_block: write array, aligned so that it can be used in place when mapped */
+static void HTS_ImageWriter_write_block(HTS_ImageWriter * w, const void *data, size_t size)
+{
+   HTS_ImageWriter_write_size(w, size);
+   HTS_ImageWriter_pad(w, HTS_IMAGE_ALIGNMENT);
+   HTS_ImageWriter_write(w, data, size);
+   HTS_ImageWriter_pad(w, sizeof(uint64_t));
+}
+
+/* HTS_ImageWriter_write_string: write string (NULL is allowed) */
+static void HTS_ImageWriter_write_string(HTS_ImageWriter * w, const char *string)
+{
+   HTS_ImageWriter_write_block(w, string, string != NULL ? strlen(string) + 1 : 0);
+}
+
+/* HTS_ImageReader_read_size: read size value */
+static size_t HTS_ImageReader_read_size(HTS_ImageReader * r)
+{
+   uint64_t v;
+
+   if (r->error == TRUE || r->index + sizeof(v) > r->size) {
+      r->error = TRUE;
+      return 0;
+   }
+   memcpy(&v, &r->data[r->index], sizeof(v));
+   r->index += sizeof(v);
+
+   return (size_t) v;
+}
+
+/* HTS_ImageReader_read_block: get pointer to array of given number of elements in the image */
+static void *HTS_ImageReader_read_block(HTS_ImageReader * r, size_t element_size, size_t count)
+{
+   size_t size = HTS_ImageReader_read_size(r);
+   const unsigned char *p;
+
+   if (r->error == TRUE || (element_size > 0 && count > r->size / element_size) || size != element_size * count) {
+      r->error = TRUE;
+      return NULL;
+   }
+   r->index += (HTS_IMAGE_ALIGNMENT - r->index % HTS_IMAGE_ALIGNMENT) % HTS_IMAGE_ALIGNMENT;
+   if (r->index > r->size || size > r->size - r->index) {
+      r->error = TRUE;
+      return NULL;
+   }
+   p = size > 0 ? &r->data[r->index] : NULL;
+   r->index += size;
+   r->index += (sizeof(uint64_t) - r->index % sizeof(uint64_t)) % sizeof(uint64_t);
+
+   return (void *) p;
+}
+
+/* HTS_ImageReader_read_string: read string and return a copy (NULL if not given) */
+static char *HTS_ImageReader_read_string(HTS_ImageReader * r)
+{
+   size_t size;
+   size_t index = r->index;
+   const char *string;
+
+   size = HTS_ImageReader_read_size(r);
+   r->index = index;
+   string = (const char *) HTS_ImageReader_read_block(r, 1, size);
+   if (string == NULL)
+      return NULL;
+   if (string[size - 1] != '\0') {
+      r->error = TRUE;
+      return NULL;
+   }
+
+   return HTS_strdup(string);
+}
+
+/* HTS_Model_save_image: write model to voice image */
+static void HTS_Model_save_image(HTS_Model * model, HTS_ImageWriter * w)
+{
+   size_t i;
+   size_t npdf = model->npdf != NULL ? model->ntree : 0;
+   size_t ntree = model->tree != NULL ? model->ntree : 0;
+   size_t total = 0;
+
+   for (i = 0; i < npdf; i++)
+      total += model->npdf[i];
+
+   HTS_ImageWriter_write_size(w, model->vector_length);
+   HTS_ImageWriter_write_size(w, model->num_windows);
+   HTS_ImageWriter_write_size(w, model->is_msd);
+   HTS_ImageWriter_write_size(w, model->ntree);
+   HTS_ImageWriter_write_size(w, model->pdf_length);
+   HTS_ImageWriter_write_size(w, npdf);
+   HTS_ImageWriter_write_size(w, total);
+   HTS_ImageWriter_write_size(w, ntree);
+   HTS_ImageWriter_write_size(w, model->nnode);
+   HTS_ImageWriter_write_size(w, model->nquestion);
+   HTS_ImageWriter_write_size(w, model->npattern);
+   HTS_ImageWriter_write_size(w, model->string_size);
+
+   HTS_ImageWriter_write_block(w, model->npdf, npdf * sizeof(unsigned int));
+   HTS_ImageWriter_write_block(w, model->pdf_offset, npdf * sizeof(unsigned int));
+   HTS_ImageWriter_write_block(w, model->pdf, total * model->pdf_length * sizeof(float));
+   HTS_ImageWriter_write_block(w, model->tree, ntree * sizeof(HTS_Tree));
+   HTS_ImageWriter_write_block(w, model->node, model->nnode * sizeof(HTS_Node));
+   HTS_ImageWriter_write_block(w, model->question, model->nquestion * sizeof(HTS_Question));
+   HTS_ImageWriter_write_block(w, model->pattern, model->npattern * sizeof(HTS_Pattern));
+   HTS_ImageWriter_write_block(w, model->string, model->string_size);
+}
+
+/* HTS_Model_load_image: set model to point into voice image */
+static HTS_Boolean HTS_Model_load_image(HTS_Model * model, HTS_ImageReader * r)
+{
+   size_t i, j;
+   size_t npdf, total, ntree;
+   size_t first, last;
+   const HTS_Node *node;
+
+   HTS_Model_initialize(model);
+
+   model->vector_length = HTS_ImageReader_read_size(r);
+   model->num_windows = HTS_ImageReader_read_size(r);
+   model->is_msd = HTS_ImageReader_read_size(r) != 0 ? TRUE : FALSE;
+   model->ntree = HTS_ImageReader_read_size(r);
+   model->pdf_length = HTS_ImageReader_read_size(r);
+   npdf = HTS_ImageReader_read_size(r);
+   total = HTS_ImageReader_read_size(r);
+   ntree = HTS_ImageReader_read_size(r);
+   model->nnode = HTS_ImageReader_read_size(r);
+   model->nquestion = HTS_ImageReader_read_size(r);
+   model->npattern = HTS_ImageReader_read_size(r);
+   model->string_size = HTS_ImageReader_read_size(r);
+
+   /* PDFs are laid out as HTS_Model_load_pdf builds them, and sizes are bounded before they are multiplied */
+   if (r->error == TRUE || model->vector_length > HTS_MAXBUFLEN || model->num_windows > HTS_MAXBUFLEN)
+      return FALSE;
+   if (model->pdf_length != model->vector_length * model->num_windows * 2 + (model->is_msd == TRUE ? 1 : 0) || (model->pdf_length > 0 && total > r->size / model->pdf_length))
+      return FALSE;
+
+   model->npdf = (unsigned int *) HTS_ImageReader_read_block(r, sizeof(unsigned int), npdf);
+   model->pdf_offset = (unsigned int *) HTS_ImageReader_read_block(r, sizeof(unsigned int), npdf);
+   model->pdf = (float *) HTS_ImageReader_read_block(r, sizeof(float), total * model->pdf_length);
+   model->tree = (HTS_Tree *) HTS_ImageReader_read_block(r, sizeof(HTS_Tree), ntree);
+   model->node = (HTS_Node *) HTS_ImageReader_read_block(r, sizeof(HTS_Node), model->nnode);
+   model->question = (HTS_Question *) HTS_ImageReader_read_block(r, sizeof(HTS_Question), model->nquestion);
+   model->pattern = (HTS_Pattern *) HTS_ImageReader_read_block(r, sizeof(HTS_Pattern), model->npattern);
+   model->string = (char *) HTS_ImageReader_read_block(r, sizeof(char), model->string_size);
+   if (r->error == TRUE)
+      return FALSE;
+
+   /* check indices, so that a broken image cannot make tree search go astray */
+   if ((npdf != 0 && npdf != model->ntree) || (ntree != 0 && ntree != model->ntree))
+      return FALSE;
+   for (i = 0; i < npdf; i++)
+      if (model->npdf[i] == 0 || (size_t) model->pdf_offset[i] + model->npdf[i] > total)
+         return FALSE;
+   if (model->string_size > 0 && model->string[model->string_size - 1] != '\0')
+      return FALSE;
+   for (i = 0; i < model->npattern; i++)
+      if (model->pattern[i].string >= model->string_size)
+         return FALSE;
+   for (i = 0; i < model->nquestion; i++)
+      if (model->question[i].string >= model->string_size || (size_t) model->question[i].head + model->question[i].npattern > model->npattern)
+         return FALSE;
+   /* the nodes of each tree follow its root and children follow their parent, as HTS_Tree_load adds them, so every search ends at a leaf of the tree */
+   for (i = 0; i < ntree; i++) {
+      first = model->tree[i].root;
+      last = i + 1 < ntree ? model->tree[i + 1].root : model->nnode;
+      if (first >= last || last > model->nnode || (size_t) model->tree[i].head + model->tree[i].npattern > model->npattern)
+         return FALSE;
+      for (j = first; j < last; j++) {
+         node = &model->node[j];
+         if (node->quest >= (int) model->nquestion)
+            return FALSE;
+         if (node->quest >= 0 && (node->yes <= j || node->yes >= last || node->no <= j || node->no >= last))
+            return FALSE;
+         if (node->quest < 0 && npdf != 0 && (node->pdf < 1 || node->pdf > model->npdf[i]))
+            return FALSE;
+      }
+   }
+
+   return TRUE;
+}
+
+/* HTS_Window_save_image: write dynamic windows to voice image */
+static void HTS_Window_save_image(HTS_Window * win, HTS_ImageWriter * w)
+{
+   size_t i;
+   size_t ncoefficient = 0;
+
+   for (i = 0; i < win->size; i++)
+      if (ncoefficient < (size_t) ((int) win->center[i] + win->r_width[i] + 1))
+         ncoefficient = (size_t) ((int) win->center[i] + win->r_width[i] + 1);
+
+   HTS_ImageWriter_write_size(w, win->size);
+   HTS_ImageWriter_write_size(w, win->max_width);
+   HTS_ImageWriter_write_size(w, ncoefficient);
+   HTS_ImageWriter_write_block(w, win->l_width, win->size * sizeof(int));
+   HTS_ImageWriter_write_block(w, win->r_width, win->size * sizeof(int));
+   HTS_ImageWriter_write_block(w, win->center, win->size * sizeof(unsigned int));
+   HTS_ImageWriter_write_block(w, win->coefficient, ncoefficient * sizeof(double));
+}
+
+/* HTS_Window_load_image: set dynamic windows to point into voice image */
+static HTS_Boolean HTS_Window_load_image(HTS_Window * win, HTS_ImageReader * r)
+{
+   size_t i;
+   size_t ncoefficient;
+   size_t max_width = 0;
+   int64_t l_width, r_width, center;
+
+   HTS_Window_initialize(win);
+
+   win->size = HTS_ImageReader_read_size(r);
+   win->max_width = HTS_ImageReader_read_size(r);
+   ncoefficient = HTS_ImageReader_read_size(r);
+   win->l_width = (int *) HTS_ImageReader_read_block(r, sizeof(int), win->size);
+   win->r_width = (int *) HTS_ImageReader_read_block(r, sizeof(int), win->size);
+   win->center = (unsigned int *) HTS_ImageReader_read_block(r, sizeof(unsigned int), win->size);
+   win->coefficient = (double *) HTS_ImageReader_read_block(r, sizeof(double), ncoefficient);
+   if (r->error == TRUE || win->size == 0 || win->size > HTS_MAXBUFLEN)
+      return FALSE;
+
+   /* widths as HTS_Window_load sets them, centered on coefficients inside the image */
+   for (i = 0; i < win->size; i++) {
+      l_width = win->l_width[i];
+      r_width = win->r_width[i];
+      center = win->center[i];
+      if (l_width > 0 || (r_width != -l_width && (l_width == 0 || r_width != -l_width - 1)))
+         return FALSE;
+      if (center + l_width < 0 || (uint64_t) (center + r_width) >= ncoefficient)
+         return FALSE;
+      if (max_width < (size_t) -l_width)
+         max_width = (size_t) -l_width;
+   }
+   if (win->max_width != max_width)
+      return FALSE;
+
+   return TRUE;
+}
+
+/* HTS_ModelSet_save_image: save model set as precompiled voice image */
+HTS_Boolean HTS_ModelSet_save_image(HTS_ModelSet * ms, const char *fn, const char *voice)
+{
+   size_t i;
+   HTS_ImageHeader header;
+   HTS_ImageWriter w;
+
+   if (ms == NULL || ms->num_voices != 1) {
+      HTS_error(0, "HTS_ModelSet_save_image: Voice image must be built from a single voice.\n");
+      return FALSE;
+   }
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, HTS_IMAGE_MAGIC, sizeof(HTS_IMAGE_MAGIC));
+   header.version = HTS_IMAGE_VERSION;
+   header.byte_order = HTS_IMAGE_BYTE_ORDER;
+   if (HTS_get_checksum(voice, &header.source_checksum, &header.source_size) != TRUE)
+      return FALSE;
+
+   w.fp = fopen(fn, "wb");
+   w.index = 0;
+   w.checksum = HTS_CHECKSUM_BASIS;
+   w.error = FALSE;
+   if (w.fp == NULL) {
+      HTS_error(0, "HTS_ModelSet_save_image: Cannot open %s.\n", fn);
+      return FALSE;
+   }
+
+   HTS_ImageWriter_write(&w, &header, sizeof(header));
+   w.checksum = HTS_CHECKSUM_BASIS;
+
+   /* global */
+   HTS_ImageWriter_write_size(&w, ms->sampling_frequency);
+   HTS_ImageWriter_write_size(&w, ms->frame_period);
+   HTS_ImageWriter_write_size(&w, ms->num_states);
+   HTS_ImageWriter_write_size(&w, ms->num_streams);
+   HTS_ImageWriter_write_string(&w, ms->hts_voice_version);
+   HTS_ImageWriter_write_string(&w, ms->stream_type);
+   HTS_ImageWriter_write_string(&w, ms->fullcontext_format);
+   HTS_ImageWriter_write_string(&w, ms->fullcontext_version);
+   for (i = 0; i < ms->num_streams; i++)
+      HTS_ImageWriter_write_string(&w, ms->option[i]);
+   HTS_ImageWriter_write_size(&w, ms->gv_off_context != NULL ? 1 : 0);
+   if (ms->gv_off_context != NULL)
+      HTS_Model_save_image(ms->gv_off_context, &w);
+
+   /* models */
+   HTS_Model_save_image(&ms->duration[0], &w);
+   for (i = 0; i < ms->num_streams; i++)
+      HTS_Window_save_image(&ms->window[i], &w);
+   for (i = 0; i < ms->num_streams; i++)
+      HTS_Model_save_image(&ms->stream[0][i], &w);
+   for (i = 0; i < ms->num_streams; i++)
+      HTS_Model_save_image(&ms->gv[0][i], &w);
+
+   /* header is written again, now that the checksum of the rest is known */
+   header.image_checksum = w.checksum;
+   if (fseek(w.fp, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, w.fp) != 1)
+      w.error = TRUE;
+   if (fclose(w.fp) != 0)
+      w.error = TRUE;
+   if (w.error == TRUE) {
+      HTS_error(0, "HTS_ModelSet_save_image: Cannot write %s.\n", fn);
+      remove(fn);
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
+/* HTS_ModelSet_load_voice_image: map voice image as given voice of model set */
+static HTS_Boolean HTS_ModelSet_load_voice_image(HTS_ModelSet * ms, size_t voice, const char *fn)
+{
+   size_t i;
+   HTS_ImageHeader header;
+   HTS_ImageReader r;
+   HTS_Window win;
+   HTS_Model gv_off_context;
+   HTS_Boolean result = TRUE;
+   size_t sampling_frequency, frame_period, num_states, num_streams;
+   char *hts_voice_version, *stream_type, *fullcontext_format, *fullcontext_version;
+   char **option;
+
+   ms->image[voice] = HTS_mmap(fn, &ms->image_size[voice]);
+   if (ms->image[voice] == NULL)
+      return FALSE;
+
+   r.data = (const unsigned char *) ms->image[voice];
+   r.size = ms->image_size[voice];
+   r.index = sizeof(header);
+   r.error = FALSE;
+
+   if (r.size < sizeof(header)) {
+      HTS_error(0, "HTS_ModelSet_load_images: %s is not a voice image.\n", fn);
+      return FALSE;
+   }
+   memcpy(&header, r.data, sizeof(header));
+   if (memcmp(header.magic, HTS_IMAGE_MAGIC, sizeof(HTS_IMAGE_MAGIC)) != 0 || header.version != HTS_IMAGE_VERSION || header.byte_order != HTS_IMAGE_BYTE_ORDER) {
+      HTS_error(0, "HTS_ModelSet_load_images: %s is not a compatible voice image.\n", fn);
+      return FALSE;
+   }
+
+   /* global */
+   sampling_frequency = HTS_ImageReader_read_size(&r);
+   frame_period = HTS_ImageReader_read_size(&r);
+   num_states = HTS_ImageReader_read_size(&r);
+   num_streams = HTS_ImageReader_read_size(&r);
+   if (r.error == TRUE || sampling_frequency == 0 || frame_period == 0 || frame_period > HTS_MAXBUFLEN || num_states == 0 || num_states > HTS_MAXBUFLEN || num_streams == 0 || num_streams > HTS_MAXBUFLEN) {
+      HTS_error(0, "HTS_ModelSet_load_images: Broken voice image %s.\n", fn);
+      return FALSE;
+   }
+   hts_voice_version = HTS_ImageReader_read_string(&r);
+   stream_type = HTS_ImageReader_read_string(&r);
+   fullcontext_format = HTS_ImageReader_read_string(&r);
+   fullcontext_version = HTS_ImageReader_read_string(&r);
+   option = (char **) HTS_calloc(num_streams, sizeof(char *));
+   for (i = 0; i < num_streams; i++)
+      option[i] = HTS_ImageReader_read_string(&r);
+
+   if (voice == 0) {
+      ms->sampling_frequency = sampling_frequency;
+      ms->frame_period = frame_period;
+      ms->num_states = num_states;
+      ms->num_streams = num_streams;
+      ms->hts_voice_version = hts_voice_version;
+      ms->stream_type = stream_type;
+      ms->fullcontext_format = fullcontext_format;
+      ms->fullcontext_version = fullcontext_version;
+      ms->option = option;
+      if (HTS_ImageReader_read_size(&r) != 0) {
+         ms->gv_off_context = (HTS_Model *) HTS_calloc(1, sizeof(HTS_Model));
+         if (HTS_Model_load_image(ms->gv_off_context, &r) != TRUE)
+            result = FALSE;
+      }
+      /* prepare memory */
+      ms->duration = (HTS_Model *) HTS_calloc(ms->num_voices, sizeof(HTS_Model));
+      ms->window = (HTS_Window *) HTS_calloc(ms->num_streams, sizeof(HTS_Window));
+      ms->stream = (HTS_Model **) HTS_calloc(ms->num_voices, sizeof(HTS_Model *));
+      ms->gv = (HTS_Model **) HTS_calloc(ms->num_voices, sizeof(HTS_Model *));
+      for (i = 0; i < ms->num_voices; i++) {
+         ms->stream[i] = (HTS_Model *) HTS_calloc(ms->num_streams, sizeof(HTS_Model));
+         ms->gv[i] = (HTS_Model *) HTS_calloc(ms->num_streams, sizeof(HTS_Model));
+      }
+   } else {
+      /* voices are interpolated, so they must share the same structure */
+      if (ms->sampling_frequency != sampling_frequency || ms->frame_period != frame_period || ms->num_states != num_states || ms->num_streams != num_streams)
+         result = FALSE;
+      if (HTS_strequal(ms->hts_voice_version, hts_voice_version) != TRUE || HTS_strequal(ms->stream_type, stream_type) != TRUE)
+         result = FALSE;
+      if (HTS_strequal(ms->fullcontext_format, fullcontext_format) != TRUE || HTS_strequal(ms->fullcontext_version, fullcontext_version) != TRUE)
+         result = FALSE;
+      for (i = 0; i < num_streams && result == TRUE; i++)
+         if (HTS_strequal(ms->option[i], option[i]) != TRUE)
+            result = FALSE;
+      if (hts_voice_version != NULL)
+         free(hts_voice_version);
+      if (stream_type != NULL)
+         free(stream_type);
+      if (fullcontext_format != NULL)
+         free(fullcontext_format);
+      if (fullcontext_version != NULL)
+         free(fullcontext_version);
+      for (i = 0; i < num_streams; i++)
+         if (option[i] != NULL)
+            free(option[i]);
+      free(option);
+      if (result != TRUE) {
+         HTS_error(0, "HTS_ModelSet_load_images: Voice image %s does not match the first voice.\n", fn);
+         return FALSE;
+      }
+      /* the first voice decides where GV is switched off */
+      if ((HTS_ImageReader_read_size(&r) != 0) != (ms->gv_off_context != NULL) || (ms->gv_off_context != NULL && HTS_Model_load_image(&gv_off_context, &r) != TRUE))
+         result = FALSE;
+   }
+
+   /* models, with the shapes HTS_ModelSet_load gives them, as parameters are read by those shapes */
+   if (result == TRUE && HTS_Model_load_image(&ms->duration[voice], &r) != TRUE)
+      result = FALSE;
+   else if (result == TRUE && (ms->duration[voice].npdf == NULL || ms->duration[voice].vector_length != ms->num_states || ms->duration[voice].num_windows != 1 || ms->duration[voice].is_msd == TRUE))
+      result = FALSE;
+   for (i = 0; i < ms->num_streams && result == TRUE; i++) {
+      /* windows are shared, those of later voices only have to match */
+      if (HTS_Window_load_image(voice == 0 ? &ms->window[i] : &win, &r) != TRUE)
+         result = FALSE;
+      else if (voice != 0 && win.size != ms->window[i].size)
+         result = FALSE;
+   }
+   for (i = 0; i < ms->num_streams && result == TRUE; i++)
+      if (HTS_Model_load_image(&ms->stream[voice][i], &r) != TRUE || ms->stream[voice][i].npdf == NULL || ms->stream[voice][i].vector_length == 0 || ms->stream[voice][i].num_windows != ms->window[i].size)
+         result = FALSE;
+   for (i = 0; i < ms->num_streams && result == TRUE; i++) {
+      if (HTS_Model_load_image(&ms->gv[voice][i], &r) != TRUE)
+         result = FALSE;
+      else if (ms->gv[voice][i].vector_length != 0 && (ms->gv[voice][i].npdf == NULL || ms->gv[voice][i].vector_length != ms->stream[voice][i].vector_length || ms->gv[voice][i].num_windows != 1 || ms->gv[voice][i].is_msd == TRUE))
+         result = FALSE;
+   }
+   if (voice != 0)
+      for (i = 0; i < ms->num_streams && result == TRUE; i++)
+         if (ms->stream[voice][i].vector_length != ms->stream[0][i].vector_length || ms->stream[voice][i].is_msd != ms->stream[0][i].is_msd || ms->gv[voice][i].vector_length != ms->gv[0][i].vector_length)
+            result = FALSE;
+
+   if (result != TRUE || r.error == TRUE || ms->option[0] == NULL) {
+      HTS_error(0, "HTS_ModelSet_load_images: Broken voice image %s.\n", fn);
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
+/* HTS_ModelSet_load_images: load precompiled voice images, one per voice */
+HTS_Boolean HTS_ModelSet_load_images(HTS_ModelSet * ms, char **fn, size_t num_images)
+{
+   size_t i;
+
+   if (ms == NULL || fn == NULL || num_images < 1)
+      return FALSE;
+
+   HTS_ModelSet_clear(ms);
+
+   ms->num_voices = num_images;
+   ms->image = (void **) HTS_calloc(num_images, sizeof(void *));
+   ms->image_size = (size_t *) HTS_calloc(num_images, sizeof(size_t));
+   for (i = 0; i < num_images; i++) {
+      if (fn[i] == NULL || HTS_ModelSet_load_voice_image(ms, i, fn[i]) != TRUE) {
+         HTS_ModelSet_clear(ms);
+         return FALSE;
+      }
+   }
+
+   return TRUE;
+}
+
+/* HTS_ModelSet_check_image: check checksums of source voice and image body recorded in image */
+HTS_Boolean HTS_ModelSet_check_image(const char *fn, const char *voice)
+{
+   HTS_ImageHeader header;
+   uint64_t checksum, size;
+   FILE *fp = fopen(fn, "rb");
+
+   if (fp == NULL) {
+      HTS_error(0, "HTS_ModelSet_check_image: Cannot open %s.\n", fn);
+      return FALSE;
+   }
+   if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, HTS_IMAGE_MAGIC, sizeof(HTS_IMAGE_MAGIC)) != 0 || header.version != HTS_IMAGE_VERSION || header.byte_order != HTS_IMAGE_BYTE_ORDER) {
+      fclose(fp);
+      return FALSE;
+   }
+   /* loading only checks structure, so a damaged image must be rebuilt instead */
+   HTS_get_checksum_fp(fp, &checksum, &size);
+   fclose(fp);
+   if (header.image_checksum != checksum)
+      return FALSE;
+
+   if (HTS_get_checksum(voice, &checksum, &size) != TRUE)
+      return FALSE;
+
+   return header.source_size == size && header.source_checksum == checksum ? TRUE : FALSE;
+}
+
+/* HTS_ModelSet_set_context_format: compile patterns for structured labels */
+HTS_Boolean HTS_ModelSet_set_context_format(HTS_ModelSet * ms, const HTS_ContextFormat * format)
+{
+   size_t i, j;
+   size_t nstring = 0;
+
+   if (ms->gv_off_context != NULL)
+      nstring += HTS_Model_set_context_format(ms->gv_off_context, format);
+   for (i = 0; i < ms->num_voices; i++) {
+      if (ms->duration != NULL)
+         nstring += HTS_Model_set_context_format(&ms->duration[i], format);
+      for (j = 0; j < ms->num_streams; j++) {
+         if (ms->stream != NULL && ms->stream[i] != NULL)
+            nstring += HTS_Model_set_context_format(&ms->stream[i][j], format);
+         if (ms->gv != NULL && ms->gv[i] != NULL)
+            nstring += HTS_Model_set_context_format(&ms->gv[i][j], format);
+      }
+   }
+   ms->context_format = format;
+   ms->context_string = nstring > 0 ? TRUE : FALSE;
+
+   return ms->context_string == TRUE ? FALSE : TRUE;
+}
+
+/* HTS_ModelSet_use_context: check given structured label can be matched without its string form */
+HTS_Boolean HTS_ModelSet_use_context(HTS_ModelSet * ms, const HTS_ContextValue * context)
+{
+   if (context == NULL || ms->context_format == NULL || ms->context_string == TRUE)
+      return FALSE;
+   return TRUE;
+}
+
 /* HTS_ModelSet_get_sampling_frequency: get sampling frequency of HTS voices */
 size_t HTS_ModelSet_get_sampling_frequency(HTS_ModelSet * ms)
 {
@@ -1515,11 +2271,11 @@ const char *HTS_ModelSet_get_option(HTS_ModelSet * ms, size_t stream_index)
 }
 
 /* HTS_ModelSet_get_gv_flag: get GV flag */
-HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string)
+HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string, const HTS_ContextValue * context)
 {
-   if (ms->gv_off_context == NULL)
+   if (ms->gv_off_context == NULL || ms->gv_off_context->nquestion == 0)
       return TRUE;
-   else if (HTS_Question_match(ms->gv_off_context, string) == TRUE)
+   else if (HTS_Question_match(ms->gv_off_context, &ms->gv_off_context->question[0], string, context) == TRUE)
       return FALSE;
    else
       return TRUE;
@@ -1588,7 +2344,7 @@ int HTS_ModelSet_get_window_right_width(HTS_ModelSet * ms, size_t stream_index,
 /* HTS_ModelSet_get_window_coefficient: get coefficient of dynamic window */
 double HTS_ModelSet_get_window_coefficient(HTS_ModelSet * ms, size_t stream_index, size_t window_index, size_t coefficient_index)
 {
-   return ms->window[stream_index].coefficient[window_index][coefficient_index];
+   return ms->window[stream_index].coefficient[(int) ms->window[stream_index].center[window_index] + (int) coefficient_index];
 }
 
 /* HTS_ModelSet_get_window_max_width: get max width of dynamic window */
@@ -1607,29 +2363,31 @@ HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, size_t stream_index)
 }
 
 /* HTS_Model_add_parameter: get parameter using interpolation weight */
-static void HTS_Model_add_parameter(HTS_Model * model, size_t state_index, const char *string, double *mean, double *vari, double *msd, double weight)
+static void HTS_Model_add_parameter(HTS_Model * model, size_t state_index, const char *string, const HTS_ContextValue * context, double *mean, double *vari, double *msd, double weight)
 {
    size_t i;
    size_t tree_index, pdf_index;
    size_t len = model->vector_length * model->num_windows;
+   const float *pdf;
 
-   HTS_Model_get_index(model, state_index, string, &tree_index, &pdf_index);
+   HTS_Model_get_index(model, state_index, string, context, &tree_index, &pdf_index);
+   pdf = HTS_Model_get_pdf(model, tree_index, pdf_index);
    for (i = 0; i < len; i++) {
-      mean[i] += weight * model->pdf[tree_index][pdf_index][i];
-      vari[i] += weight * model->pdf[tree_index][pdf_index][i + len];
+      mean[i] += weight * pdf[i];
+      vari[i] += weight * pdf[i + len];
    }
    if (msd != NULL && model->is_msd == TRUE)
-      *msd += weight * model->pdf[tree_index][pdf_index][len + len];
+      *msd += weight * pdf[len + len];
 }
 
 /* HTS_ModelSet_get_duration_index: get duration PDF & tree index */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->duration[voice_index], 2, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->duration[voice_index], 2, string, context, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const double *iw, double *mean, double *vari)
+void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const HTS_ContextValue * context, const double *iw, double *mean, double *vari)
 {
    size_t i;
    size_t len = ms->num_states;
@@ -1640,17 +2398,17 @@ void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const doub
    }
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i] != 0.0)
-         HTS_Model_add_parameter(&ms->duration[i], 2, string, mean, vari, NULL, iw[i]);
+         HTS_Model_add_parameter(&ms->duration[i], 2, string, context, mean, vari, NULL, iw[i]);
 }
 
 /* HTS_ModelSet_get_parameter_index: get paramter PDF & tree index */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->stream[voice_index][stream_index], state_index, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->stream[voice_index][stream_index], state_index, string, context, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const double *const *iw, double *mean, double *vari, double *msd)
+void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const HTS_ContextValue * context, const double *const *iw, double *mean, double *vari, double *msd)
 {
    size_t i;
    size_t len = ms->stream[0][stream_index].vector_length * ms->stream[0][stream_index].num_windows;
@@ -1664,17 +2422,17 @@ void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t s
 
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i][stream_index] != 0.0)
-         HTS_Model_add_parameter(&ms->stream[i][stream_index], state_index, string, mean, vari, msd, iw[i][stream_index]);
+         HTS_Model_add_parameter(&ms->stream[i][stream_index], state_index, string, context, mean, vari, msd, iw[i][stream_index]);
 }
 
 /* HTS_ModelSet_get_gv_index: get gv PDF & tree index */
-void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, const HTS_ContextValue * context, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->gv[voice_index][stream_index], 2, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->gv[voice_index][stream_index], 2, string, context, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const double *const *iw, double *mean, double *vari)
+void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const HTS_ContextValue * context, const double *const *iw, double *mean, double *vari)
 {
    size_t i;
    size_t len = ms->stream[0][stream_index].vector_length;
@@ -1685,7 +2443,7 @@ void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *str
    }
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i][stream_index] != 0.0)
-         HTS_Model_add_parameter(&ms->gv[i][stream_index], 2, string, mean, vari, NULL, iw[i][stream_index]);
+         HTS_Model_add_parameter(&ms->gv[i][stream_index], 2, string, context, mean, vari, NULL, iw[i][stream_index]);
 }
 
 HTS_MODEL_C_END;
@@ -272,7 +272,7 @@ void HTS_PStreamSet_initialize(HTS_PStreamSet * pss)
 }
 
 /* HTS_PStreamSet_create: parameter generation using GV weight */
-HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight)
+HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight, HTS_Arena * arena)
 {
    size_t i, j, k, l, m;
    int shift;
@@ -288,7 +288,7 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
 
    /* initialize */
    pss->nstream = HTS_SStreamSet_get_nstream(sss);
-   pss->pstream = (HTS_PStream *) HTS_calloc(pss->nstream, sizeof(HTS_PStream));
+   pss->pstream = (HTS_PStream *) HTS_Arena_calloc(arena, pss->nstream, sizeof(HTS_PStream));
    pss->total_frame = HTS_SStreamSet_get_total_frame(sss);
 
    /* create */
@@ -299,7 +299,7 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
          for (state = 0; state < HTS_SStreamSet_get_total_state(sss); state++)
             if (HTS_SStreamSet_get_msd(sss, i, state) > msd_threshold[i])
                pst->length += HTS_SStreamSet_get_duration(sss, state);
-         pst->msd_flag = (HTS_Boolean *) HTS_calloc(pss->total_frame, sizeof(HTS_Boolean));
+         pst->msd_flag = (HTS_Boolean *) HTS_Arena_calloc(arena, pss->total_frame, sizeof(HTS_Boolean));
          for (state = 0, frame = 0; state < HTS_SStreamSet_get_total_state(sss); state++) {
             if (HTS_SStreamSet_get_msd(sss, i, state) > msd_threshold[i]) {
                for (j = 0; j < HTS_SStreamSet_get_duration(sss, state); j++) {
@@ -321,39 +321,39 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
       pst->width = HTS_SStreamSet_get_window_max_width(sss, i) * 2 + 1; /* band width of R */
       pst->win_size = HTS_SStreamSet_get_window_size(sss, i);
       if (pst->length > 0) {
-         pst->sm.mean = HTS_alloc_matrix(pst->length, pst->vector_length * pst->win_size);
-         pst->sm.ivar = HTS_alloc_matrix(pst->length, pst->vector_length * pst->win_size);
-         pst->sm.wum = (double *) HTS_calloc(pst->length, sizeof(double));
-         pst->sm.wuw = HTS_alloc_matrix(pst->length, pst->width);
-         pst->sm.g = (double *) HTS_calloc(pst->length, sizeof(double));
-         pst->par = HTS_alloc_matrix(pst->length, pst->vector_length);
+         pst->sm.mean = HTS_Arena_alloc_matrix(arena, pst->length, pst->vector_length * pst->win_size);
+         pst->sm.ivar = HTS_Arena_alloc_matrix(arena, pst->length, pst->vector_length * pst->win_size);
+         pst->sm.wum = (double *) HTS_Arena_calloc(arena, pst->length, sizeof(double));
+         pst->sm.wuw = HTS_Arena_alloc_matrix(arena, pst->length, pst->width);
+         pst->sm.g = (double *) HTS_Arena_calloc(arena, pst->length, sizeof(double));
+         pst->par = HTS_Arena_alloc_matrix(arena, pst->length, pst->vector_length);
       }
       /* copy dynamic window */
-      pst->win_l_width = (int *) HTS_calloc(pst->win_size, sizeof(int));
-      pst->win_r_width = (int *) HTS_calloc(pst->win_size, sizeof(int));
-      pst->win_coefficient = (double **) HTS_calloc(pst->win_size, sizeof(double));
+      pst->win_l_width = (int *) HTS_Arena_calloc(arena, pst->win_size, sizeof(int));
+      pst->win_r_width = (int *) HTS_Arena_calloc(arena, pst->win_size, sizeof(int));
+      pst->win_coefficient = (double **) HTS_Arena_calloc(arena, pst->win_size, sizeof(double));
       for (j = 0; j < pst->win_size; j++) {
          pst->win_l_width[j] = HTS_SStreamSet_get_window_left_width(sss, i, j);
          pst->win_r_width[j] = HTS_SStreamSet_get_window_right_width(sss, i, j);
          if (pst->win_l_width[j] + pst->win_r_width[j] == 0)
             pst->win_coefficient[j] = (double *)
-                HTS_calloc(-2 * pst->win_l_width[j] + 1, sizeof(double));
+                HTS_Arena_calloc(arena, -2 * pst->win_l_width[j] + 1, sizeof(double));
          else
             pst->win_coefficient[j] = (double *)
-                HTS_calloc(-2 * pst->win_l_width[j], sizeof(double));
+                HTS_Arena_calloc(arena, -2 * pst->win_l_width[j], sizeof(double));
          pst->win_coefficient[j] -= pst->win_l_width[j];
          for (shift = pst->win_l_width[j]; shift <= pst->win_r_width[j]; shift++)
             pst->win_coefficient[j][shift] = HTS_SStreamSet_get_window_coefficient(sss, i, j, shift);
       }
       /* copy GV */
-      if (HTS_SStreamSet_use_gv(sss, i)) {
-         pst->gv_mean = (double *) HTS_calloc(pst->vector_length, sizeof(double));
-         pst->gv_vari = (double *) HTS_calloc(pst->vector_length, sizeof(double));
+      if (HTS_SStreamSet_use_gv(sss, i) && gv_weight[i] > 0.0) {
+         pst->gv_mean = (double *) HTS_Arena_calloc(arena, pst->vector_length, sizeof(double));
+         pst->gv_vari = (double *) HTS_Arena_calloc(arena, pst->vector_length, sizeof(double));
          for (j = 0; j < pst->vector_length; j++) {
             pst->gv_mean[j] = HTS_SStreamSet_get_gv_mean(sss, i, j) * gv_weight[i];
             pst->gv_vari[j] = HTS_SStreamSet_get_gv_vari(sss, i, j);
          }
-         pst->gv_switch = (HTS_Boolean *) HTS_calloc(pst->length, sizeof(HTS_Boolean));
+         pst->gv_switch = (HTS_Boolean *) HTS_Arena_calloc(arena, pst->length, sizeof(HTS_Boolean));
          if (HTS_SStreamSet_is_msd(sss, i) == TRUE) {   /* for MSD */
             for (state = 0, frame = 0, msd_frame = 0; state < HTS_SStreamSet_get_total_state(sss); state++)
                for (j = 0; j < HTS_SStreamSet_get_duration(sss, state); j++, frame++)
@@ -472,50 +472,9 @@ HTS_Boolean HTS_PStreamSet_is_msd(HTS_PStreamSet * pss, size_t stream_index)
    return pss->pstream[stream_index].msd_flag ? TRUE : FALSE;
 }
 
-/* HTS_PStreamSet_clear: free parameter stream set */
+/* HTS_PStreamSet_clear: free parameter stream set (memory is owned by the arena) */
 void HTS_PStreamSet_clear(HTS_PStreamSet * pss)
 {
-   size_t i, j;
-   HTS_PStream *pstream;
-
-   if (pss->pstream) {
-      for (i = 0; i < pss->nstream; i++) {
-         pstream = &pss->pstream[i];
-         if (pstream->sm.wum)
-            HTS_free(pstream->sm.wum);
-         if (pstream->sm.g)
-            HTS_free(pstream->sm.g);
-         if (pstream->sm.wuw)
-            HTS_free_matrix(pstream->sm.wuw, pstream->length);
-         if (pstream->sm.ivar)
-            HTS_free_matrix(pstream->sm.ivar, pstream->length);
-         if (pstream->sm.mean)
-            HTS_free_matrix(pstream->sm.mean, pstream->length);
-         if (pstream->par)
-            HTS_free_matrix(pstream->par, pstream->length);
-         if (pstream->msd_flag)
-            HTS_free(pstream->msd_flag);
-         if (pstream->win_coefficient) {
-            for (j = 0; j < pstream->win_size; j++) {
-               pstream->win_coefficient[j] += pstream->win_l_width[j];
-               HTS_free(pstream->win_coefficient[j]);
-            }
-         }
-         if (pstream->gv_mean)
-            HTS_free(pstream->gv_mean);
-         if (pstream->gv_vari)
-            HTS_free(pstream->gv_vari);
-         if (pstream->win_coefficient)
-            HTS_free(pstream->win_coefficient);
-         if (pstream->win_l_width)
-            HTS_free(pstream->win_l_width);
-         if (pstream->win_r_width)
-            HTS_free(pstream->win_r_width);
-         if (pstream->gv_switch)
-            HTS_free(pstream->gv_switch);
-      }
-      HTS_free(pss->pstream);
-   }
    HTS_PStreamSet_initialize(pss);
 }
 
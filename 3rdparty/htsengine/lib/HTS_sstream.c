@@ -164,12 +164,22 @@ void HTS_SStreamSet_initialize(HTS_SStreamSet * sss)
    sss->nstate = 0;
    sss->sstream = NULL;
    sss->duration = NULL;
+   sss->duration_mean = NULL;
+   sss->duration_vari = NULL;
    sss->total_state = 0;
    sss->total_frame = 0;
 }
 
+/* HTS_get_label_string: get label string, NULL if fields of structured label are enough */
+static const char *HTS_get_label_string(HTS_ModelSet * ms, HTS_Label * label, size_t index)
+{
+   if (HTS_ModelSet_use_context(ms, HTS_Label_get_context(label, index)) == TRUE)
+      return NULL;
+   return HTS_Label_get_string(label, index);
+}
+
 /* HTS_SStreamSet_create: parse label and determine state duration */
-HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, HTS_Boolean phoneme_alignment_flag, double speed, double *duration_iw, double **parameter_iw, double **gv_iw)
+HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, HTS_Boolean phoneme_alignment_flag, double speed, double *duration_iw, double **parameter_iw, double **gv_iw, HTS_Arena * arena)
 {
    size_t i, j, k;
    double temp;
@@ -177,7 +187,6 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    size_t state;
    HTS_SStream *sst;
    double *duration_mean, *duration_vari;
-   double frame_length;
    size_t next_time;
    size_t next_state;
 
@@ -222,23 +231,19 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    sss->nstream = HTS_ModelSet_get_nstream(ms);
    sss->total_frame = 0;
    sss->total_state = HTS_Label_get_size(label) * sss->nstate;
-   sss->duration = (size_t *) HTS_calloc(sss->total_state, sizeof(size_t));
-   sss->sstream = (HTS_SStream *) HTS_calloc(sss->nstream, sizeof(HTS_SStream));
+   sss->duration = (size_t *) HTS_Arena_calloc(arena, sss->total_state, sizeof(size_t));
+   sss->sstream = (HTS_SStream *) HTS_Arena_calloc(arena, sss->nstream, sizeof(HTS_SStream));
    for (i = 0; i < sss->nstream; i++) {
       sst = &sss->sstream[i];
       sst->vector_length = HTS_ModelSet_get_vector_length(ms, i);
-      sst->mean = (double **) HTS_calloc(sss->total_state, sizeof(double *));
-      sst->vari = (double **) HTS_calloc(sss->total_state, sizeof(double *));
+      sst->mean = HTS_Arena_alloc_matrix(arena, sss->total_state, sst->vector_length * HTS_ModelSet_get_window_size(ms, i));
+      sst->vari = HTS_Arena_alloc_matrix(arena, sss->total_state, sst->vector_length * HTS_ModelSet_get_window_size(ms, i));
       if (HTS_ModelSet_is_msd(ms, i))
-         sst->msd = (double *) HTS_calloc(sss->total_state, sizeof(double));
+         sst->msd = (double *) HTS_Arena_calloc(arena, sss->total_state, sizeof(double));
       else
          sst->msd = NULL;
-      for (j = 0; j < sss->total_state; j++) {
-         sst->mean[j] = (double *) HTS_calloc(sst->vector_length * HTS_ModelSet_get_window_size(ms, i), sizeof(double));
-         sst->vari[j] = (double *) HTS_calloc(sst->vector_length * HTS_ModelSet_get_window_size(ms, i), sizeof(double));
-      }
       if (HTS_ModelSet_use_gv(ms, i)) {
-         sst->gv_switch = (HTS_Boolean *) HTS_calloc(sss->total_state, sizeof(HTS_Boolean));
+         sst->gv_switch = (HTS_Boolean *) HTS_Arena_calloc(arena, sss->total_state, sizeof(HTS_Boolean));
          for (j = 0; j < sss->total_state; j++)
             sst->gv_switch[j] = TRUE;
       } else {
@@ -247,10 +252,10 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    }
 
    /* determine state duration */
-   duration_mean = (double *) HTS_calloc(sss->total_state, sizeof(double));
-   duration_vari = (double *) HTS_calloc(sss->total_state, sizeof(double));
+   duration_mean = sss->duration_mean = (double *) HTS_Arena_calloc(arena, sss->total_state, sizeof(double));
+   duration_vari = sss->duration_vari = (double *) HTS_Arena_calloc(arena, sss->total_state, sizeof(double));
    for (i = 0; i < HTS_Label_get_size(label); i++)
-      HTS_ModelSet_get_duration(ms, HTS_Label_get_string(label, i), duration_iw, &duration_mean[i * sss->nstate], &duration_vari[i * sss->nstate]);
+      HTS_ModelSet_get_duration(ms, HTS_get_label_string(ms, label, i), HTS_Label_get_context(label, i), duration_iw, &duration_mean[i * sss->nstate], &duration_vari[i * sss->nstate]);
    if (phoneme_alignment_flag == TRUE) {
       /* use duration set by user */
       next_time = 0;
@@ -267,32 +272,21 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
          }
          state += sss->nstate;
       }
+      for (i = 0; i < sss->total_state; i++)
+         sss->total_frame += sss->duration[i];
    } else {
-      /* determine frame length */
-      if (speed != 1.0) {
-         temp = 0.0;
-         for (i = 0; i < sss->total_state; i++) {
-            temp += duration_mean[i];
-         }
-         frame_length = temp / speed;
-         HTS_set_specified_duration(sss->duration, duration_mean, duration_vari, sss->total_state, frame_length);
-      } else {
-         HTS_set_default_duration(sss->duration, duration_mean, duration_vari, sss->total_state);
-      }
+      HTS_SStreamSet_set_speed(sss, speed);
    }
-   HTS_free(duration_mean);
-   HTS_free(duration_vari);
 
    /* get parameter */
    for (i = 0, state = 0; i < HTS_Label_get_size(label); i++) {
       for (j = 2; j <= sss->nstate + 1; j++) {
-         sss->total_frame += sss->duration[state];
          for (k = 0; k < sss->nstream; k++) {
             sst = &sss->sstream[k];
             if (sst->msd)
-               HTS_ModelSet_get_parameter(ms, k, j, HTS_Label_get_string(label, i), (const double *const *) parameter_iw, sst->mean[state], sst->vari[state], &sst->msd[state]);
+               HTS_ModelSet_get_parameter(ms, k, j, HTS_get_label_string(ms, label, i), HTS_Label_get_context(label, i), (const double *const *) parameter_iw, sst->mean[state], sst->vari[state], &sst->msd[state]);
             else
-               HTS_ModelSet_get_parameter(ms, k, j, HTS_Label_get_string(label, i), (const double *const *) parameter_iw, sst->mean[state], sst->vari[state], NULL);
+               HTS_ModelSet_get_parameter(ms, k, j, HTS_get_label_string(ms, label, i), HTS_Label_get_context(label, i), (const double *const *) parameter_iw, sst->mean[state], sst->vari[state], NULL);
          }
          state++;
       }
@@ -303,16 +297,16 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
       sst = &sss->sstream[i];
       sst->win_size = HTS_ModelSet_get_window_size(ms, i);
       sst->win_max_width = HTS_ModelSet_get_window_max_width(ms, i);
-      sst->win_l_width = (int *) HTS_calloc(sst->win_size, sizeof(int));
-      sst->win_r_width = (int *) HTS_calloc(sst->win_size, sizeof(int));
-      sst->win_coefficient = (double **) HTS_calloc(sst->win_size, sizeof(double));
+      sst->win_l_width = (int *) HTS_Arena_calloc(arena, sst->win_size, sizeof(int));
+      sst->win_r_width = (int *) HTS_Arena_calloc(arena, sst->win_size, sizeof(int));
+      sst->win_coefficient = (double **) HTS_Arena_calloc(arena, sst->win_size, sizeof(double));
       for (j = 0; j < sst->win_size; j++) {
          sst->win_l_width[j] = HTS_ModelSet_get_window_left_width(ms, i, j);
          sst->win_r_width[j] = HTS_ModelSet_get_window_right_width(ms, i, j);
          if (sst->win_l_width[j] + sst->win_r_width[j] == 0)
-            sst->win_coefficient[j] = (double *) HTS_calloc(-2 * sst->win_l_width[j] + 1, sizeof(double));
+            sst->win_coefficient[j] = (double *) HTS_Arena_calloc(arena, -2 * sst->win_l_width[j] + 1, sizeof(double));
          else
-            sst->win_coefficient[j] = (double *) HTS_calloc(-2 * sst->win_l_width[j], sizeof(double));
+            sst->win_coefficient[j] = (double *) HTS_Arena_calloc(arena, -2 * sst->win_l_width[j], sizeof(double));
          sst->win_coefficient[j] -= sst->win_l_width[j];
          for (shift = sst->win_l_width[j]; shift <= sst->win_r_width[j]; shift++)
             sst->win_coefficient[j][shift] = HTS_ModelSet_get_window_coefficient(ms, i, j, shift);
@@ -323,9 +317,9 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    for (i = 0; i < sss->nstream; i++) {
       sst = &sss->sstream[i];
       if (HTS_ModelSet_use_gv(ms, i)) {
-         sst->gv_mean = (double *) HTS_calloc(sst->vector_length, sizeof(double));
-         sst->gv_vari = (double *) HTS_calloc(sst->vector_length, sizeof(double));
-         HTS_ModelSet_get_gv(ms, i, HTS_Label_get_string(label, 0), (const double *const *) gv_iw, sst->gv_mean, sst->gv_vari);
+         sst->gv_mean = (double *) HTS_Arena_calloc(arena, sst->vector_length, sizeof(double));
+         sst->gv_vari = (double *) HTS_Arena_calloc(arena, sst->vector_length, sizeof(double));
+         HTS_ModelSet_get_gv(ms, i, HTS_get_label_string(ms, label, 0), HTS_Label_get_context(label, 0), (const double *const *) gv_iw, sst->gv_mean, sst->gv_vari);
       } else {
          sst->gv_mean = NULL;
          sst->gv_vari = NULL;
@@ -333,7 +327,7 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    }
 
    for (i = 0; i < HTS_Label_get_size(label); i++)
-      if (HTS_ModelSet_get_gv_flag(ms, HTS_Label_get_string(label, i)) == FALSE)
+      if (HTS_ModelSet_get_gv_flag(ms, HTS_get_label_string(ms, label, i), HTS_Label_get_context(label, i)) == FALSE)
          for (j = 0; j < sss->nstream; j++)
             if (HTS_ModelSet_use_gv(ms, j) == TRUE)
                for (k = 0; k < sss->nstate; k++)
@@ -342,6 +336,28 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
    return TRUE;
 }
 
+/* HTS_SStreamSet_set_speed: determine state duration for speech speed */
+void HTS_SStreamSet_set_speed(HTS_SStreamSet * sss, double speed)
+{
+   size_t i;
+   double temp;
+
+   /* determine frame length */
+   if (speed != 1.0) {
+      temp = 0.0;
+      for (i = 0; i < sss->total_state; i++) {
+         temp += sss->duration_mean[i];
+      }
+      HTS_set_specified_duration(sss->duration, sss->duration_mean, sss->duration_vari, sss->total_state, temp / speed);
+   } else {
+      HTS_set_default_duration(sss->duration, sss->duration_mean, sss->duration_vari, sss->total_state);
+   }
+
+   sss->total_frame = 0;
+   for (i = 0; i < sss->total_state; i++)
+      sss->total_frame += sss->duration[i];
+}
+
 /* HTS_SStreamSet_get_nstream: get number of stream */
 size_t HTS_SStreamSet_get_nstream(HTS_SStreamSet * sss)
 {
@@ -468,42 +484,9 @@ HTS_Boolean HTS_SStreamSet_get_gv_switch(HTS_SStreamSet * sss, size_t stream_ind
    return sss->sstream[stream_index].gv_switch[state_index];
 }
 
-/* HTS_SStreamSet_clear: free state stream set */
+/* HTS_SStreamSet_clear: free state stream set (memory is owned by the arena) */
 void HTS_SStreamSet_clear(HTS_SStreamSet * sss)
 {
-   size_t i, j;
-   HTS_SStream *sst;
-
-   if (sss->sstream) {
-      for (i = 0; i < sss->nstream; i++) {
-         sst = &sss->sstream[i];
-         for (j = 0; j < sss->total_state; j++) {
-            HTS_free(sst->mean[j]);
-            HTS_free(sst->vari[j]);
-         }
-         if (sst->msd)
-            HTS_free(sst->msd);
-         HTS_free(sst->mean);
-         HTS_free(sst->vari);
-         for (j = 0; j < sst->win_size; j++) {
-            sst->win_coefficient[j] += sst->win_l_width[j];
-            HTS_free(sst->win_coefficient[j]);
-         }
-         HTS_free(sst->win_coefficient);
-         HTS_free(sst->win_l_width);
-         HTS_free(sst->win_r_width);
-         if (sst->gv_mean)
-            HTS_free(sst->gv_mean);
-         if (sst->gv_vari)
-            HTS_free(sst->gv_vari);
-         if (sst->gv_switch)
-            HTS_free(sst->gv_switch);
-      }
-      HTS_free(sss->sstream);
-   }
-   if (sss->duration)
-      HTS_free(sss->duration);
-
    HTS_SStreamSet_initialize(sss);
 }
 
@@ -56,6 +56,7 @@
 HTS_VOCODER_C_START;
 
 #include <math.h>               /* for sqrt(),log(),exp(),pow(),cos() */
+#include <string.h>             /* for memmove() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -648,17 +649,12 @@ static void HTS_Vocoder_initialize_excitation(HTS_Vocoder * v, double pitch, siz
    v->pitch_of_curr_point = pitch;
    v->pitch_counter = pitch;
    v->pitch_inc_per_point = 0.0;
-   if (nlpf > 0) {
-      v->excite_buff_size = nlpf;
-      v->excite_ring_buff = (double *) HTS_calloc(v->excite_buff_size, sizeof(double));
-      for (i = 0; i < v->excite_buff_size; i++)
-         v->excite_ring_buff[i] = 0.0;
-      v->excite_buff_index = 0;
-   } else {
-      v->excite_buff_size = 0;
-      v->excite_ring_buff = NULL;
-      v->excite_buff_index = 0;
-   }
+   /* one frame of excitation followed by the part of the low-pass filtered pulses and noise that spills into the next frame */
+   v->excite_buff_size = nlpf;
+   v->excite_tail_size = nlpf > 0 ? nlpf - 1 : 0;
+   v->excite_buff = (double *) HTS_calloc(v->fprd + v->excite_tail_size, sizeof(double));
+   for (i = 0; i < v->fprd + v->excite_tail_size; i++)
+      v->excite_buff[i] = 0.0;
 }
 
 /* HTS_Vocoder_start_excitation: start excitation of each frame */
@@ -673,80 +669,149 @@ static void HTS_Vocoder_start_excitation(HTS_Vocoder * v, double pitch)
    }
 }
 
-/* HTS_Vocoder_excite_unvoiced_frame: ping noise to ring buffer */
-static void HTS_Vocoder_excite_unvoiced_frame(HTS_Vocoder * v, double noise)
+/* HTS_Vocoder_excite_unvoiced_point: add noise of a point to excitation */
+static void HTS_Vocoder_excite_unvoiced_point(HTS_Vocoder * v, double noise, double *excite)
 {
-   size_t center = (v->excite_buff_size - 1) / 2;
-   v->excite_ring_buff[(v->excite_buff_index + center) % v->excite_buff_size] += noise;
+   excite[(v->excite_buff_size - 1) / 2] += noise;
 }
 
-/* HTS_Vocoder_excite_vooiced_frame: ping noise and pulse to ring buffer */
-static void HTS_Vocoder_excite_voiced_frame(HTS_Vocoder * v, double noise, double pulse, const double *lpf)
+/* HTS_Vocoder_excite_voiced_point: add low-pass filtered pulse and high-pass filtered noise of a point to excitation */
+static void HTS_Vocoder_excite_voiced_point(HTS_Vocoder * v, double noise, double pulse, const double *lpf, double *excite)
 {
    size_t i;
    size_t center = (v->excite_buff_size - 1) / 2;
 
    if (noise != 0.0) {
-      for (i = 0; i < v->excite_buff_size; i++) {
-         if (i == center)
-            v->excite_ring_buff[(v->excite_buff_index + i) % v->excite_buff_size] += noise * (1.0 - lpf[i]);
-         else
-            v->excite_ring_buff[(v->excite_buff_index + i) % v->excite_buff_size] += noise * (0.0 - lpf[i]);
-      }
+      for (i = 0; i < center; i++)
+         excite[i] += noise * (0.0 - lpf[i]);
+      excite[center] += noise * (1.0 - lpf[center]);
+      for (i = center + 1; i < v->excite_buff_size; i++)
+         excite[i] += noise * (0.0 - lpf[i]);
    }
    if (pulse != 0.0) {
       for (i = 0; i < v->excite_buff_size; i++)
-         v->excite_ring_buff[(v->excite_buff_index + i) % v->excite_buff_size] += pulse * lpf[i];
+         excite[i] += pulse * lpf[i];
    }
 }
 
-/* HTS_Vocoder_get_excitation: get excitation of each sample */
-static double HTS_Vocoder_get_excitation(HTS_Vocoder * v, const double *lpf)
+/* HTS_Vocoder_get_excitation: get excitation of each frame */
+static void HTS_Vocoder_get_excitation(HTS_Vocoder * v, const double *lpf)
 {
-   double x;
-   double noise, pulse = 0.0;
+   size_t i;
+   double noise, pulse;
+   double *excite = v->excite_buff;
 
    if (v->excite_buff_size > 0) {
-      noise = HTS_white_noise(v);
-      pulse = 0.0;
-      if (v->pitch_of_curr_point == 0.0) {
-         HTS_Vocoder_excite_unvoiced_frame(v, noise);
-      } else {
-         v->pitch_counter += 1.0;
-         if (v->pitch_counter >= v->pitch_of_curr_point) {
-            pulse = sqrt(v->pitch_of_curr_point);
-            v->pitch_counter -= v->pitch_of_curr_point;
+      for (i = 0; i < v->fprd; i++) {
+         noise = HTS_white_noise(v);
+         if (v->pitch_of_curr_point == 0.0) {
+            HTS_Vocoder_excite_unvoiced_point(v, noise, &excite[i]);
+         } else {
+            pulse = 0.0;
+            v->pitch_counter += 1.0;
+            if (v->pitch_counter >= v->pitch_of_curr_point) {
+               pulse = sqrt(v->pitch_of_curr_point);
+               v->pitch_counter -= v->pitch_of_curr_point;
+            }
+            HTS_Vocoder_excite_voiced_point(v, noise, pulse, lpf, &excite[i]);
+            v->pitch_of_curr_point += v->pitch_inc_per_point;
          }
-         HTS_Vocoder_excite_voiced_frame(v, noise, pulse, lpf);
-         v->pitch_of_curr_point += v->pitch_inc_per_point;
       }
-      x = v->excite_ring_buff[v->excite_buff_index];
-      v->excite_ring_buff[v->excite_buff_index] = 0.0;
-      v->excite_buff_index++;
-      if (v->excite_buff_index >= v->excite_buff_size)
-         v->excite_buff_index = 0;
+   } else if (v->pitch_of_curr_point == 0.0) {
+      for (i = 0; i < v->fprd; i++)
+         excite[i] = HTS_white_noise(v);
    } else {
-      if (v->pitch_of_curr_point == 0.0) {
-         x = HTS_white_noise(v);
-      } else {
+      for (i = 0; i < v->fprd; i++) {
          v->pitch_counter += 1.0;
          if (v->pitch_counter >= v->pitch_of_curr_point) {
-            x = sqrt(v->pitch_of_curr_point);
+            excite[i] = sqrt(v->pitch_of_curr_point);
             v->pitch_counter -= v->pitch_of_curr_point;
          } else {
-            x = 0.0;
+            excite[i] = 0.0;
          }
          v->pitch_of_curr_point += v->pitch_inc_per_point;
       }
    }
-
-   return x;
 }
 
 /* HTS_Vocoder_end_excitation: end excitation of each frame */
 static void HTS_Vocoder_end_excitation(HTS_Vocoder * v, double pitch)
 {
+   size_t i;
+
    v->pitch_of_curr_point = pitch;
+   /* carry the tail over to the beginning of the next frame */
+   if (v->excite_tail_size > 0) {
+      memmove(v->excite_buff, v->excite_buff + v->fprd, v->excite_tail_size * sizeof(double));
+      for (i = v->excite_tail_size; i < v->fprd + v->excite_tail_size; i++)
+         v->excite_buff[i] = 0.0;
+   }
+}
+
+/* HTS_warp: frequency warping of the all-pass filter, the inverse of a is -a */
+static double HTS_warp(double w, const double a)
+{
+   return w + 2.0 * atan2(a * sin(w), 1.0 - a * cos(w));
+}
+
+/* HTS_sinc: normalized sinc function */
+static double HTS_sinc(double x)
+{
+   if (x == 0.0)
+      return 1.0;
+   return sin(PI * x) / (PI * x);
+}
+
+/* HTS_Vocoder_initialize_band: prepare conversion of mel-cepstrum and low-pass filter from the voice band to the output band */
+static void HTS_Vocoder_initialize_band(HTS_Vocoder * v, size_t m, size_t nlpf, double alpha)
+{
+   size_t i, j, k;
+   const double q = v->rate / v->voice_rate;
+   const size_t nsample = 8 * (m + 1);
+   const size_t center = nlpf > 0 ? (nlpf - 1) / 2 : 0;
+   double wo, wi, bi, band;
+
+   /* both are linear in the parameters: the log spectrum of the output band is sampled on the warped axis
+      and transformed back to mel-cepstrum, the low-pass filter is resampled as a band-limited impulse response */
+   v->band_buff = (double *) HTS_calloc(m + 1 + nlpf, sizeof(double));
+   v->band_mcp = (double *) HTS_calloc((m + 1) * (m + 1), sizeof(double));
+   for (i = 0; i < (m + 1) * (m + 1); i++)
+      v->band_mcp[i] = 0.0;
+   for (k = 0; k < nsample; k++) {
+      wo = HTS_warp(PI * (k + 0.5) / nsample, -alpha);
+      wi = wo * q;
+      if (wi > PI)
+         wi = PI;
+      bi = HTS_warp(wi, alpha);
+      for (i = 0; i <= m; i++)
+         for (j = 0; j <= m; j++)
+            v->band_mcp[i * (m + 1) + j] += cos(i * PI * (k + 0.5) / nsample) * cos(j * bi);
+   }
+   for (i = 0; i <= m; i++)
+      for (j = 0; j <= m; j++)
+         v->band_mcp[i * (m + 1) + j] *= (i == 0 ? 1.0 : 2.0) / nsample;
+   /* excitation has unit power per sample, keep the power per Hz of the voice */
+   v->band_gain = 0.5 * log(q);
+
+   if (nlpf > 0) {
+      band = q > 1.0 ? 1.0 / q : 1.0;
+      v->band_lpf = (double *) HTS_calloc(nlpf * nlpf, sizeof(double));
+      for (i = 0; i < nlpf; i++)
+         for (j = 0; j < nlpf; j++)
+            v->band_lpf[i * nlpf + j] = band * HTS_sinc(band * (((double) i - center) - q * ((double) j - center)));
+   }
+}
+
+/* HTS_Vocoder_convert_band: convert vector of the voice band to the output band */
+static void HTS_Vocoder_convert_band(const double *band, const double *in, double *out, size_t n)
+{
+   size_t i, j;
+
+   for (i = 0; i < n; i++) {
+      out[i] = 0.0;
+      for (j = 0; j < n; j++)
+         out[i] += band[i * n + j] * in[j];
+   }
 }
 
 /* HTS_Vocoder_postfilter_mcp: postfilter for MCP */
@@ -816,11 +881,12 @@ static void HTS_Vocoder_postfilter_lsp(HTS_Vocoder * v, double *lsp, size_t m, d
 }
 
 /* HTS_Vocoder_initialize: initialize vocoder */
-void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, HTS_Boolean use_log_gain, size_t rate, size_t fperiod)
+void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, size_t pade_order, HTS_Boolean use_log_gain, size_t rate, size_t voice_rate, size_t fperiod)
 {
    /* set parameter */
    v->is_first = TRUE;
    v->stage = stage;
+   v->pade_order = pade_order;
    if (stage != 0)
       v->gamma = -1.0 / v->stage;
    else
@@ -830,12 +896,13 @@ void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, HTS_Boolean
    v->next = SEED;
    v->gauss = GAUSS;
    v->rate = rate;
+   v->voice_rate = voice_rate;
    v->pitch_of_curr_point = 0.0;
    v->pitch_counter = 0.0;
    v->pitch_inc_per_point = 0.0;
-   v->excite_ring_buff = NULL;
+   v->excite_buff = NULL;
    v->excite_buff_size = 0;
-   v->excite_buff_index = 0;
+   v->excite_tail_size = 0;
    v->sw = 0;
    v->x = 0x55555555;
    /* init buffer */
@@ -849,6 +916,10 @@ void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, HTS_Boolean
    v->postfilter_size = 0;
    v->spectrum2en_buff = NULL;
    v->spectrum2en_size = 0;
+   v->band_mcp = NULL;
+   v->band_lpf = NULL;
+   v->band_buff = NULL;
+   v->band_gain = 0.0;
    if (v->stage == 0) {         /* for MCP */
       v->c = (double *) HTS_calloc(m * (3 + PADEORDER) + 5 * PADEORDER + 6, sizeof(double));
       v->cc = v->c + m + 1;
@@ -881,6 +952,19 @@ void HTS_Vocoder_synthesize(HTS_Vocoder * v, size_t m, double lf0, double *spect
    else
       p = v->rate / exp(lf0);
 
+   /* synthesizing at another rate than the voice: MCP and low-pass filter describe the band of the voice */
+   if (v->is_first == TRUE && v->stage == 0 && v->voice_rate > 0.0 && v->rate != v->voice_rate)
+      HTS_Vocoder_initialize_band(v, m, nlpf, alpha);
+   if (v->band_mcp != NULL) {
+      HTS_Vocoder_convert_band(v->band_mcp, spectrum, v->band_buff, m + 1);
+      v->band_buff[0] += v->band_gain;
+      spectrum = v->band_buff;
+   }
+   if (v->band_lpf != NULL && lpf != NULL) {
+      HTS_Vocoder_convert_band(v->band_lpf, lpf, v->band_buff + m + 1, nlpf);
+      lpf = v->band_buff + m + 1;
+   }
+
    /* first time */
    if (v->is_first == TRUE) {
       HTS_Vocoder_initialize_excitation(v, p, nlpf);
@@ -915,12 +999,13 @@ void HTS_Vocoder_synthesize(HTS_Vocoder * v, size_t m, double lf0, double *spect
          v->cinc[i] = (v->cc[i] - v->c[i]) / v->fprd;
    }
 
+   HTS_Vocoder_get_excitation(v, lpf);
    for (j = 0; j < v->fprd; j++) {
-      x = HTS_Vocoder_get_excitation(v, lpf);
+      x = v->excite_buff[j];
       if (v->stage == 0) {      /* for MCP */
          if (x != 0.0)
             x *= exp(v->c[0]);
-         x = HTS_mlsadf(x, v->c, m, alpha, PADEORDER, v->d1);
+         x = HTS_mlsadf(x, v->c, m, alpha, v->pade_order, v->d1);
       } else {                  /* for LSP */
          if (!NGAIN)
             x *= v->c[0];
@@ -983,11 +1068,23 @@ void HTS_Vocoder_clear(HTS_Vocoder * v)
          HTS_free(v->c);
          v->c = NULL;
       }
+      if (v->band_mcp != NULL) {
+         HTS_free(v->band_mcp);
+         v->band_mcp = NULL;
+      }
+      if (v->band_lpf != NULL) {
+         HTS_free(v->band_lpf);
+         v->band_lpf = NULL;
+      }
+      if (v->band_buff != NULL) {
+         HTS_free(v->band_buff);
+         v->band_buff = NULL;
+      }
       v->excite_buff_size = 0;
-      v->excite_buff_index = 0;
-      if (v->excite_ring_buff != NULL) {
-         HTS_free(v->excite_ring_buff);
-         v->excite_ring_buff = NULL;
+      v->excite_tail_size = 0;
+      if (v->excite_buff != NULL) {
+         HTS_free(v->excite_buff);
+         v->excite_buff = NULL;
       }
    }
 }
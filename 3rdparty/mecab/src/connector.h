@@ -45,6 +45,11 @@ class Connector {
     return matrix_[lNode->rcAttr + lsize_ * rNode->lcAttr] + rNode->wcost;
   }
 
+  // costs from every rcAttr to lcAttr, contiguous in rcAttr
+  inline const short *transition_costs(unsigned short lcAttr) const {
+    return matrix_ + lsize_ * lcAttr;
+  }
+
   // access to raw matrix
   short *mutable_matrix() { return &matrix_[0]; }
   const short *matrix() const { return &matrix_[0]; }
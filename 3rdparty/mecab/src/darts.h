@@ -424,12 +424,16 @@ class DoubleArrayImpl {
   }
 
   template <class T>
+  // *depth is set to the number of bytes of key the result depends on,
+  // or 0 if the walk reached the end of key
   size_t commonPrefixSearch(const key_type *key,
                             T* result,
                             size_t result_len,
                             size_t len = 0,
-                            size_t node_pos = 0) const {
+                            size_t node_pos = 0,
+                            size_t *depth = 0) const {
     if (!len) len = length_func_()(key);
+    if (depth) *depth = 0;
 
     register array_type_  b   = array_[node_pos].base;
     register size_t     num = 0;
@@ -446,10 +450,12 @@ class DoubleArrayImpl {
       }
 
       p = b +(node_u_type_)(key[i]) + 1;
-      if ((array_u_type_) b == array_[p].check)
+      if ((array_u_type_) b == array_[p].check) {
         b = array_[p].base;
-      else
+      } else {
+        if (depth) *depth = i + 1;
         return num;
+      }
     }
 
     p = b;
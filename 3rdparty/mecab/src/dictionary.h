@@ -33,8 +33,8 @@ class Dictionary {
 
   size_t commonPrefixSearch(const char* key, size_t len,
                             result_type *result,
-                            size_t rlen) const {
-    return da_.commonPrefixSearch(key, result, rlen, len);
+                            size_t rlen, size_t *depth = 0) const {
+    return da_.commonPrefixSearch(key, result, rlen, len, 0, depth);
   }
 
   result_type exactMatchSearch(const char* key) const {
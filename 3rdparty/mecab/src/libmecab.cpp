@@ -194,6 +194,14 @@ void mecab_set_theta(mecab_t *tagger, float theta) {
   reinterpret_cast<MeCab::Tagger *>(tagger)->set_theta(theta);
 }
 
+size_t mecab_get_beam_width(mecab_t *tagger) {
+  return reinterpret_cast<MeCab::Tagger *>(tagger)->beam_width();
+}
+
+void mecab_set_beam_width(mecab_t *tagger, size_t beam_width) {
+  reinterpret_cast<MeCab::Tagger *>(tagger)->set_beam_width(beam_width);
+}
+
 int  mecab_get_lattice_level(mecab_t *tagger) {
   return reinterpret_cast<MeCab::Tagger *>(tagger)->lattice_level();
 }
@@ -380,6 +388,14 @@ void mecab_lattice_set_theta(mecab_lattice_t *lattice, double theta) {
   reinterpret_cast<MeCab::Lattice *>(lattice)->set_theta(theta);
 }
 
+size_t mecab_lattice_get_beam_width(mecab_lattice_t *lattice) {
+  return reinterpret_cast<MeCab::Lattice *>(lattice)->beam_width();
+}
+
+void mecab_lattice_set_beam_width(mecab_lattice_t *lattice, size_t beam_width) {
+  reinterpret_cast<MeCab::Lattice *>(lattice)->set_beam_width(beam_width);
+}
+
 int mecab_lattice_next(mecab_lattice_t *lattice) {
   return static_cast<int>(
       reinterpret_cast<MeCab::Lattice *>(lattice)->next());
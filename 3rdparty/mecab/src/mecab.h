@@ -458,6 +458,16 @@ extern "C" {
    */
   MECAB_DLL_EXTERN void          mecab_set_theta(mecab_t *mecab, float theta);
 
+  /**
+   * C wrapper of MeCab::Tagger::beam_width()
+   */
+  MECAB_DLL_EXTERN size_t        mecab_get_beam_width(mecab_t *mecab);
+
+  /**
+   * C wrapper of  MeCab::Tagger::set_beam_width()
+   */
+  MECAB_DLL_EXTERN void          mecab_set_beam_width(mecab_t *mecab, size_t beam_width);
+
   /**
    * C wrapper of MeCab::Tagger::lattice_level()
    */
@@ -656,6 +666,16 @@ extern "C" {
 
   MECAB_DLL_EXTERN void             mecab_lattice_set_theta(mecab_lattice_t *lattice, double theta);
 
+  /**
+   * C wrapper of MeCab::Lattice::beam_width()
+   */
+  MECAB_DLL_EXTERN size_t           mecab_lattice_get_beam_width(mecab_lattice_t *lattice);
+
+  /**
+   * C wrapper of MeCab::Lattice::set_beam_width()
+   */
+  MECAB_DLL_EXTERN void             mecab_lattice_set_beam_width(mecab_lattice_t *lattice, size_t beam_width);
+
   /**
    * C wrapper of MeCab::Lattice::next()
    */
@@ -935,6 +955,21 @@ public:
    */
   virtual float theta() const          = 0;
 
+  /**
+   * Set beam width of 1-best search.
+   * Only the |beam_width| left nodes with the lowest cost are connected at each position,
+   * which bounds the search on long inputs. The result may differ from the full search.
+   * 0 disables pruning. NBEST and MARGINAL_PROB modes always use the full search.
+   * @param beam_width beam width
+   */
+  virtual void   set_beam_width(size_t beam_width) = 0;
+
+  /**
+   * Return beam width of 1-best search.
+   * @return beam width
+   */
+  virtual size_t beam_width() const                = 0;
+
   /**
    * Obtain next-best result. The internal linked list structure is updated.
    * You should set MECAB_NBEST reques_type in advance.
@@ -1446,6 +1481,18 @@ public:
    */
   virtual float theta() const                               = 0;
 
+  /**
+   * Set beam width of 1-best search, see Lattice::set_beam_width().
+   * @param beam_width beam width
+   */
+  virtual void  set_beam_width(size_t beam_width)           = 0;
+
+  /**
+   * Return beam width of 1-best search.
+   * @return beam width
+   */
+  virtual size_t beam_width() const                         = 0;
+
   /**
    * Return DictionaryInfo linked list.
    * @return DictionaryInfo linked list
@@ -1581,23 +1628,56 @@ MECAB_H_START;
 #define FALSE 0
 #endif
 
+/* token of the last analysis, valid until the next analysis or refresh */
+typedef struct _MecabToken{
+   const char *surface;         /* not null-terminated */
+   int length;                  /* length of surface in bytes */
+   const char *feature;         /* dictionary feature (comma separated) */
+} MecabToken;
+
 typedef struct _Mecab{
    char **feature;
    int size;
-   void *model;
+   MecabToken *token;
+   int capacity;
+   void *model;                 /* shared by all Mecab loaded from the same dictionary */
    void *tagger;
    void *lattice;
 } Mecab;
 
+/* tokens of many sentences in input order, sentence i owns token[offset[i]] to token[offset[i + 1] - 1];
+   surfaces point into the input strings, so those must outlive the results */
+typedef struct _MecabBatch{
+   size_t size;                 /* number of sentences */
+   size_t *offset;              /* size + 1 entries */
+   MecabToken *token;
+   size_t capacity;             /* allocated tokens */
+   size_t offset_capacity;      /* allocated offsets */
+   void *model;                 /* model the lattices were created from */
+   void **lattice;              /* one per worker thread, kept between batches */
+   size_t nlattice;
+} MecabBatch;
+
 BOOL Mecab_initialize(Mecab *m);
 BOOL Mecab_load(Mecab *m, const char *dicdir);
+BOOL Mecab_set_beam_width(Mecab *m, size_t beam_width);
+BOOL Mecab_set_lookup_cache(Mecab *m, BOOL enable);
+BOOL Mecab_get_lookup_cache_stats(Mecab *m, size_t *hits, size_t *misses);
 BOOL Mecab_analysis(Mecab *m, const char *str);
 BOOL Mecab_print(Mecab *m);
 int Mecab_get_size(Mecab *m);
+const MecabToken *Mecab_get_token(Mecab *m);
 char **Mecab_get_feature(Mecab *m);
 BOOL Mecab_refresh(Mecab *m);
 BOOL Mecab_clear(Mecab *m);
 
+BOOL MecabBatch_initialize(MecabBatch *b);
+BOOL Mecab_analysis_batch(Mecab *m, MecabBatch *b, const char **str, size_t size, size_t nthread);
+size_t MecabBatch_get_size(MecabBatch *b);
+int MecabBatch_get_token_size(MecabBatch *b, size_t i);
+const MecabToken *MecabBatch_get_token(MecabBatch *b, size_t i);
+BOOL MecabBatch_clear(MecabBatch *b);
+
 MECAB_H_END;
 
 #endif                          /* !MECAB_H */
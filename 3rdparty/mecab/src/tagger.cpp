@@ -70,6 +70,8 @@ const MeCab::Option long_options[] = {
     "set temparature parameter theta (default 0.75)"  },
   { "cost-factor",        'c',  "700",  "INT",
     "set cost factor (default 700)"  },
+  { "beam-width",        'w',  "0",  "INT",
+    "keep INT best left nodes per position in 1-best mode (default 0, no pruning)"  },
   { "output",        'o',  0,    "FILE",  "set the output file name" },
   { "version",        'v',  0, 0,     "show the version and exit." },
   { "help",          'h',  0, 0,     "show this help and exit." },
@@ -99,6 +101,10 @@ class ModelImpl: public Model {
     return theta_;
   }
 
+  size_t beam_width() const {
+    return beam_width_;
+  }
+
   const DictionaryInfo *dictionary_info() const {
     return viterbi_->tokenizer() ?
         viterbi_->tokenizer()->dictionary_info() : 0;
@@ -146,6 +152,7 @@ class ModelImpl: public Model {
   scoped_ptr<Writer>  writer_;
   int                 request_type_;
   double              theta_;
+  size_t              beam_width_;
 
 #ifdef HAVE_ATOMIC_OPS
   mutable read_write_mutex      mutex_;
@@ -187,6 +194,8 @@ class TaggerImpl: public Tagger {
   bool                  partial() const;
   void                  set_theta(float theta);
   float                 theta() const;
+  void                  set_beam_width(size_t beam_width);
+  size_t                beam_width() const;
   void                  set_lattice_level(int level);
   int                   lattice_level() const;
   void                  set_all_morphs(bool all_morphs);
@@ -207,6 +216,7 @@ class TaggerImpl: public Tagger {
   void initRequestType() {
     mutable_lattice()->set_request_type(request_type_);
     mutable_lattice()->set_theta(theta_);
+    mutable_lattice()->set_beam_width(beam_width_);
   }
 
   Lattice *mutable_lattice() {
@@ -221,6 +231,7 @@ class TaggerImpl: public Tagger {
   scoped_ptr<Lattice>       lattice_;
   int                       request_type_;
   double                    theta_;
+  size_t                    beam_width_;
   std::string               what_;
 };
 
@@ -260,6 +271,9 @@ class LatticeImpl : public Lattice {
   float theta() const { return theta_; }
   void  set_theta(float theta) { theta_ = theta; }
 
+  size_t beam_width() const { return beam_width_; }
+  void   set_beam_width(size_t beam_width) { beam_width_ = beam_width; }
+
   int request_type() const { return request_type_; }
 
   void set_request_type(int request_type) {
@@ -315,6 +329,7 @@ class LatticeImpl : public Lattice {
   double                      theta_;
   double                      Z_;
   int                         request_type_;
+  size_t                      beam_width_;
   std::string                 what_;
   std::vector<Node *>         end_nodes_;
   std::vector<Node *>         begin_nodes_;
@@ -338,7 +353,7 @@ class LatticeImpl : public Lattice {
 
 ModelImpl::ModelImpl()
     : viterbi_(new Viterbi), writer_(new Writer),
-      request_type_(MECAB_ONE_BEST), theta_(0.0) {}
+      request_type_(MECAB_ONE_BEST), theta_(0.0), beam_width_(0) {}
 
 ModelImpl::~ModelImpl() {
   delete viterbi_;
@@ -378,6 +393,7 @@ bool ModelImpl::open(const Param &param) {
 
   request_type_ = load_request_type(param);
   theta_ = param.get<double>("theta");
+  beam_width_ = param.get<size_t>("beam-width");
 
   return is_available();
 }
@@ -410,6 +426,7 @@ bool ModelImpl::swap(Model *model) {
     viterbi_      = m->take_viterbi();
     request_type_ = m->request_type();
     theta_        = m->theta();
+    beam_width_   = m->beam_width();
   }
 
   delete current_viterbi;
@@ -430,6 +447,7 @@ Tagger *ModelImpl::createTagger() const {
     return 0;
   }
   tagger->set_theta(theta_);
+  tagger->set_beam_width(beam_width_);
   tagger->set_request_type(request_type_);
   return tagger;
 }
@@ -444,7 +462,8 @@ Lattice *ModelImpl::createLattice() const {
 
 TaggerImpl::TaggerImpl()
     : current_model_(0),
-      request_type_(MECAB_ONE_BEST), theta_(kDefaultTheta) {}
+      request_type_(MECAB_ONE_BEST), theta_(kDefaultTheta),
+      beam_width_(0) {}
 
 TaggerImpl::~TaggerImpl() {}
 
@@ -461,6 +480,7 @@ bool TaggerImpl::open(int argc, char **argv) {
   current_model_ = model_.get();
   request_type_ = model()->request_type();
   theta_        = model()->theta();
+  beam_width_   = model()->beam_width();
   return true;
 }
 
@@ -473,6 +493,7 @@ bool TaggerImpl::open(const char *arg) {
   current_model_ = model_.get();
   request_type_ = model()->request_type();
   theta_        = model()->theta();
+  beam_width_   = model()->beam_width();
   return true;
 }
 
@@ -484,6 +505,7 @@ bool TaggerImpl::open(const ModelImpl &model) {
   current_model_ = &model;
   request_type_ = current_model_->request_type();
   theta_        = current_model_->theta();
+  beam_width_   = current_model_->beam_width();
   return true;
 }
 
@@ -515,6 +537,14 @@ float TaggerImpl::theta() const {
   return theta_;
 }
 
+void TaggerImpl::set_beam_width(size_t beam_width) {
+  beam_width_ = beam_width;
+}
+
+size_t TaggerImpl::beam_width() const {
+  return beam_width_;
+}
+
 void TaggerImpl::set_lattice_level(int level) {
   switch (level) {
     case 0: request_type_ |= MECAB_ONE_BEST;
@@ -732,7 +762,7 @@ const DictionaryInfo *TaggerImpl::dictionary_info() const {
 
 LatticeImpl::LatticeImpl(const Writer *writer)
     : sentence_(0), size_(0), theta_(kDefaultTheta), Z_(0.0),
-      request_type_(MECAB_ONE_BEST),
+      request_type_(MECAB_ONE_BEST), beam_width_(0),
       writer_(writer),
       ostrs_(0),
       allocator_(new Allocator<Node, Path>) {
@@ -742,6 +772,8 @@ LatticeImpl::LatticeImpl(const Writer *writer)
 
 LatticeImpl::~LatticeImpl() {}
 
+// Keeps every buffer at its high-water mark, so once the lattice has seen
+// a sentence of a given size, parsing another one does not allocate.
 void LatticeImpl::clear() {
   allocator_->free();
   if (ostrs_.get()) {
@@ -3,6 +3,7 @@
 //
 //  Copyright(C) 2001-2011 Taku Kudo <taku@chasen.org>
 //  Copyright(C) 2004-2006 Nippon Telegraph and Telephone Corporation
+#include <atomic>
 #include "common.h"
 #include "connector.h"
 #include "darts.h"
@@ -70,11 +71,17 @@ template LearnerNode *Tokenizer<LearnerNode, LearnerPath>::lookup<false>(
     Allocator<LearnerNode, LearnerPath> *, Lattice *) const;
 template bool Tokenizer<LearnerNode, LearnerPath>::open(const Param &);
 
+namespace {
+// ids of opened tokenizers, lookup cache entries of a closed one never match
+std::atomic<size_t> tokenizer_cache_id(0);
+}
+
 template <typename N, typename P>
 Tokenizer<N, P>::Tokenizer()
     : dictionary_info_freelist_(4),
       dictionary_info_(0),
-      max_grouping_size_(0) {}
+      max_grouping_size_(0),
+      cache_id_(0) {}
 
 template <typename N, typename P>
 N *Tokenizer<N, P>::getBOSNode(Allocator<N, P> *allocator) const {
@@ -176,6 +183,8 @@ bool Tokenizer<N, P>::open(const Param &param) {
     max_grouping_size_ = DEFAULT_MAX_GROUPING_SIZE;
   }
 
+  cache_id_ = ++tokenizer_cache_id;
+
   return true;
 }
 
@@ -270,31 +279,67 @@ N *Tokenizer<N, P>::lookup(const char *begin, const char *end,
 
   Dictionary::result_type *daresults = allocator->mutable_results();
   const size_t results_size = allocator->results_size();
+  const size_t len = static_cast<size_t>(end - begin2);
+
+  // skip the double-array walks for surfaces seen recently; partial
+  // parsing and empty keys (searched up to '\0') are not cached
+  LookupCache *cache = (!isPartial && len > 0 &&
+                        allocator->lookup_cache()->enabled()) ?
+      allocator->lookup_cache() : 0;
+  const LookupCache::Entry *cached = cache ?
+      cache->find(cache_id_, begin2, len) : 0;
+
+  const std::vector<LookupCache::Result> *results =
+      cached ? &cached->results : 0;
+  if (!cached) {
+    LookupCache::Entry *entry = cache ? cache->add(cache_id_, begin2, len) : 0;
+    std::vector<LookupCache::Result> *walked =
+        entry ? &entry->results : allocator->lookup_results();
+    size_t key_depth = 0;
+    bool cacheable = entry != 0;
+    walked->clear();
+    for (size_t d = 0; d < dic_.size(); ++d) {
+      size_t depth = 0;
+      const size_t n = std::min(
+          dic_[d]->commonPrefixSearch(begin2, len, daresults, results_size,
+                                      &depth),
+          results_size);
+      if (depth == 0) {
+        cacheable = false;
+      }
+      key_depth = std::max(key_depth, depth);
+      for (size_t i = 0; i < n; ++i) {
+        LookupCache::Result result;
+        result.dic = d;
+        result.token = dic_[d]->token(daresults[i]);
+        result.size = dic_[d]->token_size(daresults[i]);
+        result.length = daresults[i].length;
+        walked->push_back(result);
+      }
+    }
+    if (cacheable) {
+      entry->owner = cache_id_;
+      entry->key.assign(begin2, key_depth);
+    }
+    results = walked;
+  }
 
-  for (std::vector<Dictionary *>::const_iterator it = dic_.begin();
-       it != dic_.end(); ++it) {
-    const size_t n = (*it)->commonPrefixSearch(
-        begin2,
-        static_cast<size_t>(end - begin2),
-        daresults, results_size);
-
-    for (size_t i = 0; i < n; ++i) {
-      size_t size = (*it)->token_size(daresults[i]);
-      const Token *token = (*it)->token(daresults[i]);
-      for (size_t j = 0; j < size; ++j) {
-        N *new_node = allocator->newNode();
-        read_node_info(**it, *(token + j), &new_node);
-        new_node->length = daresults[i].length;
-        new_node->rlength = begin2 - begin + new_node->length;
-        new_node->surface = begin2;
-        new_node->stat = MECAB_NOR_NODE;
-        new_node->char_type = cinfo.default_type;
-        if (isPartial && !is_valid_node(lattice, new_node)) {
-          continue;
-        }
-        new_node->bnext = result_node;
-        result_node = new_node;
+  for (size_t i = 0; i < results->size(); ++i) {
+    const LookupCache::Result &result = (*results)[i];
+    const Dictionary &dic = *dic_[result.dic];
+    for (size_t j = 0; j < result.size; ++j) {
+      N *new_node = allocator->newNode();
+      read_node_info(dic, *(result.token + j), &new_node);
+      new_node->length = result.length;
+      new_node->rlength = begin2 - begin + new_node->length;
+      new_node->surface = begin2;
+      new_node->stat = MECAB_NOR_NODE;
+      new_node->char_type = cinfo.default_type;
+      if (isPartial && !is_valid_node(lattice, new_node)) {
+        continue;
       }
+      new_node->bnext = result_node;
+      result_node = new_node;
     }
   }
 
@@ -6,6 +6,10 @@
 #ifndef MECAB_TOKENIZER_H_
 #define MECAB_TOKENIZER_H_
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "mecab.h"
 #include "freelist.h"
 #include "dictionary.h"
@@ -18,6 +22,93 @@ namespace MeCab {
 class Param;
 class NBestGenerator;
 
+// dictionary matches of recently seen surfaces, see Tokenizer::lookup().
+// An entry is keyed by the bytes the double-array walks read, so it is
+// reused only where the walks would give the same result. Entries are
+// found by their first bytes in a small set-associative table. Probing
+// costs about as much as a walk through a warm double array, so the cache
+// is disabled by default.
+class LookupCache {
+ public:
+  struct Result {
+    size_t       dic;
+    const Token *token;
+    size_t       size;
+    size_t       length;
+  };
+
+  struct Entry {
+    size_t               owner;
+    std::string          key;
+    std::vector<Result>  results;
+  };
+
+  // entry for the surface at key, NULL if it is not cached
+  const Entry *find(size_t owner, const char *key, size_t len) {
+    if (!entries_.empty()) {
+      const Entry *entry = &entries_[set(owner, key, len) * kWays];
+      for (size_t i = 0; i < kWays; ++i, ++entry) {
+        if (entry->owner == owner && entry->key.size() <= len &&
+            std::memcmp(entry->key.data(), key, entry->key.size()) == 0) {
+          ++hits_;
+          return entry;
+        }
+      }
+    }
+    ++misses_;
+    return 0;
+  }
+
+  // empty entry in the set of key, to be filled and given an owner and the
+  // bytes it depends on by the caller
+  Entry *add(size_t owner, const char *key, size_t len) {
+    if (entries_.empty()) {
+      entries_.resize(kSets * kWays);
+      victims_.resize(kSets);
+    }
+    const size_t s = set(owner, key, len);
+    Entry &entry = entries_[s * kWays + victims_[s]];
+    victims_[s] = (victims_[s] + 1) % kWays;
+    entry.owner = 0;
+    entry.key.clear();
+    entry.results.clear();
+    return &entry;
+  }
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) {
+    enabled_ = enabled;
+    if (!enabled) {
+      entries_.clear();
+      victims_.clear();
+    }
+  }
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+  LookupCache(): enabled_(false), hits_(0), misses_(0) {}
+
+ private:
+  static const size_t kSets = 1024;
+  static const size_t kWays = 4;
+  static const size_t kHashSize = 6;  // two characters of UTF-8 kana or kanji
+  std::vector<Entry> entries_;
+  std::vector<unsigned char> victims_;
+  bool enabled_;
+  size_t hits_;
+  size_t misses_;
+
+  static size_t set(size_t owner, const char *key, size_t len) {
+    size_t h = owner;
+    const size_t n = len < kHashSize ? len : kHashSize;
+    for (size_t i = 0; i < n; ++i) {
+      h = (h ^ static_cast<unsigned char>(key[i])) * 16777619;
+    }
+    return h % kSets;
+  }
+};
+
 template <typename N, typename P>
 class Allocator {
  public:
@@ -64,10 +155,78 @@ class Allocator {
     return &partial_buffer_[0];
   }
 
+  // the rebuilt sentence and the token list of a partial parse
+  char *partial_sentence_buffer(size_t size) {
+    partial_sentence_.resize(size);
+    return &partial_sentence_[0];
+  }
+
+  std::vector<char *> *partial_lines() {
+    partial_lines_.clear();
+    return &partial_lines_;
+  }
+
+  std::vector<std::pair<char *, char *> > *partial_tokens() {
+    partial_tokens_.clear();
+    return &partial_tokens_;
+  }
+
+  // copy of a feature split into columns by Writer for %F and %f
+  char *feature_buffer(size_t size) {
+    if (feature_buffer_.size() < size) {
+      feature_buffer_.resize(size);
+    }
+    return &feature_buffer_[0];
+  }
+
+  char **feature_column_buffer(size_t size) {
+    if (feature_columns_.size() < size) {
+      feature_columns_.resize(size);
+    }
+    return &feature_columns_[0];
+  }
+
+  // contiguous copies of the nodes ending at one position, see Viterbi
+  N **left_node_buffer(size_t size) {
+    if (left_node_.size() < size) {
+      left_node_.resize(size);
+    }
+    return &left_node_[0];
+  }
+
+  long *left_cost_buffer(size_t size) {
+    if (left_cost_.size() < size) {
+      left_cost_.resize(size);
+    }
+    return &left_cost_[0];
+  }
+
+  unsigned short *left_rcattr_buffer(size_t size) {
+    if (left_rcattr_.size() < size) {
+      left_rcattr_.resize(size);
+    }
+    return &left_rcattr_[0];
+  }
+
+  long *beam_cost_buffer(size_t size) {
+    if (beam_cost_.size() < size) {
+      beam_cost_.resize(size);
+    }
+    return &beam_cost_[0];
+  }
+
   size_t results_size() const {
     return kResultsSize;
   }
 
+  LookupCache *lookup_cache() {
+    return &lookup_cache_;
+  }
+
+  std::vector<LookupCache::Result> *lookup_results() {
+    return &lookup_results_;
+  }
+
   void free() {
     id_ = 0;
     node_freelist_->free();
@@ -96,6 +255,17 @@ class Allocator {
   scoped_ptr<ChunkFreeList<char>  >  char_freelist_;
   scoped_ptr<NBestGenerator>  nbest_generator_;
   std::vector<char> partial_buffer_;
+  std::vector<char> partial_sentence_;
+  std::vector<char *> partial_lines_;
+  std::vector<std::pair<char *, char *> > partial_tokens_;
+  std::vector<char> feature_buffer_;
+  std::vector<char *> feature_columns_;
+  std::vector<N *> left_node_;
+  std::vector<long> left_cost_;
+  std::vector<unsigned short> left_rcattr_;
+  std::vector<long> beam_cost_;
+  LookupCache lookup_cache_;
+  std::vector<LookupCache::Result> lookup_results_;
   scoped_array<Dictionary::result_type>  results_;
 };
 
@@ -112,6 +282,7 @@ class Tokenizer {
   CharInfo                               space_;
   CharProperty                           property_;
   size_t                                 max_grouping_size_;
+  size_t                                 cache_id_;  // unique per open()
   whatlog                                what_;
 
  public:
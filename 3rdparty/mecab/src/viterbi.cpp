@@ -260,15 +260,16 @@ bool Viterbi::initPartial(Lattice *lattice) {
   char *str = allocator->partial_buffer(lattice->size() + 1);
   strncpy(str, lattice->sentence(), lattice->size() + 1);
 
-  std::vector<char *> lines;
+  std::vector<char *> &lines = *allocator->partial_lines();
   const size_t lsize = tokenize(str, "\n",
                                 std::back_inserter(lines),
                                 lattice->size() + 1);
   char* column[2];
-  scoped_array<char> buf(new char[lattice->size() + 1]);
-  StringBuffer os(buf.get(), lattice->size() + 1);
+  char *buf = allocator->partial_sentence_buffer(lattice->size() + 1);
+  StringBuffer os(buf, lattice->size() + 1);
 
-  std::vector<std::pair<char *, char *> > tokens;
+  std::vector<std::pair<char *, char *> > &tokens =
+      *allocator->partial_tokens();
   tokens.reserve(lsize);
 
   size_t pos = 0;
@@ -316,46 +317,100 @@ template <bool IsAllPath> bool connect(size_t pos, Node *rnode,
                                        Node **begin_node_list,
                                        Node **end_node_list,
                                        const Connector *connector,
-                                       Allocator<Node, Path> *allocator) {
-  for (;rnode; rnode = rnode->bnext) {
-    register long best_cost = 2147483647;
-    Node* best_node = 0;
-    for (Node *lnode = end_node_list[pos]; lnode; lnode = lnode->enext) {
-      register int lcost = connector->cost(lnode, rnode);  // local cost
-      register long cost = lnode->cost + lcost;
-
-      if (cost < best_cost) {
-        best_node  = lnode;
-        best_cost  = cost;
+                                       Allocator<Node, Path> *allocator,
+                                       size_t beam_width) {
+  // gather the left nodes once, so that every right node scans contiguous
+  // costs and rcAttrs instead of chasing enext pointers
+  size_t lsize = 0;
+  for (Node *lnode = end_node_list[pos]; lnode; lnode = lnode->enext) {
+    ++lsize;
+  }
+  Node **lnodes = allocator->left_node_buffer(lsize);
+  long *lcosts = allocator->left_cost_buffer(lsize);
+  unsigned short *lrcattrs = allocator->left_rcattr_buffer(lsize);
+  size_t i = 0;
+  for (Node *lnode = end_node_list[pos]; lnode; lnode = lnode->enext, ++i) {
+    lnodes[i] = lnode;
+    lcosts[i] = lnode->cost;
+    lrcattrs[i] = lnode->rcAttr;
+  }
+
+  // beam search: keep the beam_width cheapest left nodes, in list order
+  if (!IsAllPath && beam_width > 0 && lsize > beam_width) {
+    long *sorted = allocator->beam_cost_buffer(lsize);
+    std::copy(lcosts, lcosts + lsize, sorted);
+    std::nth_element(sorted, sorted + beam_width - 1, sorted + lsize);
+    const long threshold = sorted[beam_width - 1];
+    size_t below = 0;
+    for (i = 0; i < lsize; ++i) {
+      if (lcosts[i] < threshold) {
+        ++below;
+      }
+    }
+    size_t ties = beam_width - below;
+    size_t n = 0;
+    for (i = 0; i < lsize; ++i) {
+      if (lcosts[i] < threshold || (lcosts[i] == threshold && ties > 0)) {
+        if (lcosts[i] == threshold) {
+          --ties;
+        }
+        lnodes[n] = lnodes[i];
+        lcosts[n] = lcosts[i];
+        lrcattrs[n] = lrcattrs[i];
+        ++n;
+      }
+    }
+    lsize = n;
   }
 
-      if (IsAllPath) {
+  // the best left node depends only on lcAttr, rnode->wcost is added to it
+  // afterwards; homographs often share lcAttr, so the last search is reused
+  const short *matrix = 0;
+  long best_cost = 0;
+  size_t best = 0;
+  for (;rnode; rnode = rnode->bnext) {
+    const short *rmatrix = connector->transition_costs(rnode->lcAttr);
+    if (rmatrix != matrix) {
+      matrix = rmatrix;
+      best = 0;
+      best_cost = lsize ? lcosts[0] + matrix[lrcattrs[0]] : 0;
+      for (i = 1; i < lsize; ++i) {
+        const long cost = lcosts[i] + matrix[lrcattrs[i]];
+        if (cost < best_cost) {
+          best = i;
+          best_cost = cost;
+        }
+      }
+    }
+
+    if (IsAllPath) {
+      for (i = 0; i < lsize; ++i) {
         Path *path   = allocator->newPath();
-        path->cost   = lcost;
+        path->cost   = matrix[lrcattrs[i]] + rnode->wcost;
         path->rnode  = rnode;
-        path->lnode  = lnode;
+        path->lnode  = lnodes[i];
         path->lnext  = rnode->lpath;
         rnode->lpath = path;
-        path->rnext  = lnode->rpath;
-        lnode->rpath = path;
+        path->rnext  = lnodes[i]->rpath;
+        lnodes[i]->rpath = path;
       }
     }
 
     // overflow check 2003/03/09
-    if (!best_node) {
+    if (lsize == 0 || best_cost + rnode->wcost >= 2147483647) {
       return false;
-  }
+    }
 
-    rnode->prev = best_node;
+    rnode->prev = lnodes[best];
     rnode->next = 0;
-    rnode->cost = best_cost;
+    rnode->cost = best_cost + rnode->wcost;
     const size_t x = rnode->rlength + pos;
     rnode->enext = end_node_list[x];
     end_node_list[x] = rnode;
   }
 
   return true;
-  }
+}
 }  // namespace
 
 template <bool IsAllPath, bool IsPartial>
@@ -380,7 +435,8 @@ bool Viterbi::viterbi(Lattice *lattice) const {
                               begin_node_list,
                               end_node_list,
                               connector_.get(),
-                              allocator)) {
+                              allocator,
+                              lattice->beam_width())) {
         lattice->set_what("too long sentence.");
         return false;
       }
@@ -397,7 +453,8 @@ bool Viterbi::viterbi(Lattice *lattice) const {
                               begin_node_list,
                               end_node_list,
                               connector_.get(),
-                              allocator)) {
+                              allocator,
+                              lattice->beam_width())) {
         lattice->set_what("too long sentence.");
         return false;
       }
@@ -10,11 +10,16 @@
 #include "common.h"
 #include "param.h"
 #include "string_buffer.h"
+#include "tokenizer.h"
 #include "utils.h"
 #include "writer.h"
 
 namespace MeCab {
 
+namespace {
+const size_t kMaxFeatureColumns = 64;
+}
+
 Writer::Writer() : write_(&Writer::writeLattice) {}
 Writer::~Writer() {}
 
@@ -237,8 +242,8 @@ bool Writer::writeNode(Lattice *lattice,
                        const char *p,
                        const Node *node,
                        StringBuffer *os) const {
-  scoped_fixed_array<char, BUF_SIZE> buf;
-  scoped_fixed_array<char *, 64> ptr;
+  char *buf = 0;
+  char **ptr = 0;
   size_t psize = 0;
 
   for (; *p; p++) {
@@ -349,8 +354,12 @@ bool Writer::writeNode(Lattice *lattice,
               return false;
             }
             if (!psize) {
-              std::strncpy(buf.get(), node->feature, buf.size());
-              psize = tokenizeCSV(buf.get(), ptr.get(), ptr.size());
+              // scratch is owned by the lattice, not allocated per node
+              Allocator<Node, Path> *allocator = lattice->allocator();
+              buf = allocator->feature_buffer(BUF_SIZE);
+              ptr = allocator->feature_column_buffer(kMaxFeatureColumns);
+              std::strncpy(buf, node->feature, BUF_SIZE);
+              psize = tokenizeCSV(buf, ptr, kMaxFeatureColumns);
             }
 
             // separator
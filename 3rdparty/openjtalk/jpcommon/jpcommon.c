@@ -62,6 +62,13 @@ void JPCommon_initialize(JPCommon * jpcommon)
    jpcommon->head = NULL;
    jpcommon->tail = NULL;
    jpcommon->label = NULL;
+   jpcommon->arena = NULL;
+}
+
+void JPCommon_set_arena(JPCommon * jpcommon, OJTArena * arena)
+{
+   JPCommon_clear(jpcommon);
+   jpcommon->arena = arena;
 }
 
 void JPCommon_push(JPCommon * jpcommon, JPCommonNode * node)
@@ -83,8 +90,10 @@ void JPCommon_make_label(JPCommon * jpcommon)
    if (jpcommon->label != NULL)
       JPCommonLabel_clear(jpcommon->label);
    else
-      jpcommon->label = (JPCommonLabel *) calloc(1, sizeof(JPCommonLabel));
+      jpcommon->label = (JPCommonLabel *) OJTArena_calloc(jpcommon->arena, 1,
+                                                          sizeof(JPCommonLabel));
    JPCommonLabel_initialize(jpcommon->label);
+   jpcommon->label->arena = jpcommon->arena;
    /* push word */
    for (node = jpcommon->head; node != NULL; node = node->next)
       JPCommonLabel_push_word(jpcommon->label, JPCommonNode_get_pron(node),
@@ -104,6 +113,14 @@ int JPCommon_get_label_size(JPCommon * jpcommon)
       return 0;
 }
 
+JPCommonLabelValue *JPCommon_get_label_context(JPCommon * jpcommon)
+{
+   if (jpcommon->label != NULL)
+      return JPCommonLabel_get_context(jpcommon->label);
+   else
+      return NULL;
+}
+
 char **JPCommon_get_label_feature(JPCommon * jpcommon)
 {
    if (jpcommon->label != NULL)
@@ -128,7 +145,6 @@ void JPCommon_fprint(JPCommon * jpcommon, FILE * fp)
 void JPCommon_refresh(JPCommon * jpcommon)
 {
    JPCommon_clear(jpcommon);
-   JPCommon_initialize(jpcommon);
 }
 
 void JPCommon_clear(JPCommon * jpcommon)
@@ -137,15 +153,14 @@ void JPCommon_clear(JPCommon * jpcommon)
 
    while (jpcommon->head != NULL) {
       node = jpcommon->head->next;
-      JPCommonNode_clear(jpcommon->head);
-      free(jpcommon->head);
+      JPCommonNode_delete(jpcommon->head);
       jpcommon->head = node;
    }
    jpcommon->tail = NULL;
 
    if (jpcommon->label != NULL) {
       JPCommonLabel_clear(jpcommon->label);
-      free(jpcommon->label);
+      OJTArena_free(jpcommon->arena, jpcommon->label);
    }
    jpcommon->label = NULL;
 }
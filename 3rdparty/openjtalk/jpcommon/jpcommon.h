@@ -51,6 +51,47 @@
 
 JPCOMMON_H_START;
 
+#include <limits.h>
+
+#include "ojt_arena.h"
+
+/* JPCommonLabelField: fields of structured full-context label, in order of the string form */
+
+typedef enum _JPCommonLabelField {
+   JPCOMMON_LABEL_P1 = 0, JPCOMMON_LABEL_P2, JPCOMMON_LABEL_P3, JPCOMMON_LABEL_P4,
+   JPCOMMON_LABEL_P5,
+   JPCOMMON_LABEL_A1, JPCOMMON_LABEL_A2, JPCOMMON_LABEL_A3,
+   JPCOMMON_LABEL_B1, JPCOMMON_LABEL_B2, JPCOMMON_LABEL_B3,
+   JPCOMMON_LABEL_C1, JPCOMMON_LABEL_C2, JPCOMMON_LABEL_C3,
+   JPCOMMON_LABEL_D1, JPCOMMON_LABEL_D2, JPCOMMON_LABEL_D3,
+   JPCOMMON_LABEL_E1, JPCOMMON_LABEL_E2, JPCOMMON_LABEL_E3, JPCOMMON_LABEL_E4,
+   JPCOMMON_LABEL_E5,
+   JPCOMMON_LABEL_F1, JPCOMMON_LABEL_F2, JPCOMMON_LABEL_F3, JPCOMMON_LABEL_F4,
+   JPCOMMON_LABEL_F5, JPCOMMON_LABEL_F6, JPCOMMON_LABEL_F7, JPCOMMON_LABEL_F8,
+   JPCOMMON_LABEL_G1, JPCOMMON_LABEL_G2, JPCOMMON_LABEL_G3, JPCOMMON_LABEL_G4,
+   JPCOMMON_LABEL_G5,
+   JPCOMMON_LABEL_H1, JPCOMMON_LABEL_H2,
+   JPCOMMON_LABEL_I1, JPCOMMON_LABEL_I2, JPCOMMON_LABEL_I3, JPCOMMON_LABEL_I4,
+   JPCOMMON_LABEL_I5, JPCOMMON_LABEL_I6, JPCOMMON_LABEL_I7, JPCOMMON_LABEL_I8,
+   JPCOMMON_LABEL_J1, JPCOMMON_LABEL_J2,
+   JPCOMMON_LABEL_K1, JPCOMMON_LABEL_K2, JPCOMMON_LABEL_K3,
+   JPCOMMON_LABEL_FIELD_SIZE
+} JPCommonLabelField;
+
+#define JPCOMMON_LABEL_TYPE_STRING  0   /* phoneme, part of speech, ... */
+#define JPCOMMON_LABEL_TYPE_INTEGER 1   /* non-negative count or position */
+#define JPCOMMON_LABEL_TYPE_SIGNED  2   /* integer which may be negative */
+
+#define JPCOMMON_LABEL_UNDEFINED INT_MIN        /* integer written as "xx" */
+
+typedef union _JPCommonLabelValue {
+   int integer;
+   const char *string;
+} JPCommonLabelValue;
+
+const char *JPCommonLabelField_get_prefix(JPCommonLabelField field);
+int JPCommonLabelField_get_type(JPCommonLabelField field);
+
 /* JPCommonLabel */
 
 struct _JPCommonLabelPhoneme;
@@ -73,6 +114,7 @@ typedef struct _JPCommonLabelMora {
    struct _JPCommonLabelMora *prev;
    struct _JPCommonLabelMora *next;
    struct _JPCommonLabelWord *up;
+   int index;                   /* position in utterance (set by JPCommonLabel_make) */
 } JPCommonLabelMora;
 
 typedef struct _JPCommonLabelWord {
@@ -95,6 +137,7 @@ typedef struct _JPCommonLabelAccentPhrase {
    struct _JPCommonLabelAccentPhrase *prev;
    struct _JPCommonLabelAccentPhrase *next;
    struct _JPCommonLabelBreathGroup *up;
+   int index;                   /* position in utterance (set by JPCommonLabel_make) */
 } JPCommonLabelAccentPhrase;
 
 typedef struct _JPCommonLabelBreathGroup {
@@ -102,11 +145,13 @@ typedef struct _JPCommonLabelBreathGroup {
    struct _JPCommonLabelAccentPhrase *tail;
    struct _JPCommonLabelBreathGroup *prev;
    struct _JPCommonLabelBreathGroup *next;
+   int index;                   /* position in utterance (set by JPCommonLabel_make) */
 } JPCommonLabelBreathGroup;
 
 typedef struct _JPCommonLabel {
    int size;
-   char **feature;
+   char **feature;              /* string form of context (made on demand) */
+   JPCommonLabelValue *context; /* JPCOMMON_LABEL_FIELD_SIZE fields for each label */
    JPCommonLabelBreathGroup *breath_head;
    JPCommonLabelBreathGroup *breath_tail;
    JPCommonLabelAccentPhrase *accent_head;
@@ -118,6 +163,7 @@ typedef struct _JPCommonLabel {
    JPCommonLabelPhoneme *phoneme_head;
    JPCommonLabelPhoneme *phoneme_tail;
    int short_pause_flag;
+   OJTArena *arena;             /* owner of all label data (NULL for heap) */
 } JPCommonLabel;
 
 void JPCommonLabel_initialize(JPCommonLabel * label);
@@ -125,6 +171,7 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
                              const char *ctype, const char *cform, int acc, int chain_flag);
 void JPCommonLabel_make(JPCommonLabel * label);
 int JPCommonLabel_get_size(JPCommonLabel * label);
+JPCommonLabelValue *JPCommonLabel_get_context(JPCommonLabel * label);
 char **JPCommonLabel_get_feature(JPCommonLabel * label);
 void JPCommonLabel_print(JPCommonLabel * label);
 void JPCommonLabel_fprint(JPCommonLabel * label, FILE * fp);
@@ -141,9 +188,12 @@ typedef struct _JPCommonNode {
    int chain_flag;              /* chain flag */
    struct _JPCommonNode *prev;
    struct _JPCommonNode *next;
+   OJTArena *arena;             /* owner of node and strings (NULL for heap) */
 } JPCommonNode;
 
 void JPCommonNode_initialize(JPCommonNode * node);
+JPCommonNode *JPCommonNode_new(OJTArena * arena);
+void JPCommonNode_delete(JPCommonNode * node);
 void JPCommonNode_set_pron(JPCommonNode * node, const char *str);
 void JPCommonNode_set_pos(JPCommonNode * node, const char *str);
 void JPCommonNode_set_ctype(JPCommonNode * node, const char *str);
@@ -166,12 +216,15 @@ typedef struct _JPCommon {
    JPCommonNode *head;
    JPCommonNode *tail;
    JPCommonLabel *label;
+   OJTArena *arena;             /* allocator for nodes and label (NULL for heap) */
 } JPCommon;
 
 void JPCommon_initialize(JPCommon * jpcommon);
+void JPCommon_set_arena(JPCommon * jpcommon, OJTArena * arena);
 void JPCommon_push(JPCommon * jpcommon, JPCommonNode * node);
 void JPCommon_make_label(JPCommon * jpcommon);
 int JPCommon_get_label_size(JPCommon * jpcommon);
+JPCommonLabelValue *JPCommon_get_label_context(JPCommon * jpcommon);
 char **JPCommon_get_label_feature(JPCommon * jpcommon);
 void JPCommon_print(JPCommon * jpcommon);
 void JPCommon_fprint(JPCommon * jpcommon, FILE * fp);
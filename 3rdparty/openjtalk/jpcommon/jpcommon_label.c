@@ -85,6 +85,8 @@ JPCOMMON_LABEL_C_START;
 #define MAX_L     99
 #define MAX_LL    199
 
+#define JPCOMMON_LABEL_UNKNOWN "xx"
+
 static int strtopcmp(const char *str, const char *pattern)
 {
    int i;
@@ -108,24 +110,25 @@ static int limit(int in, int min, int max)
    return in;
 }
 
-static void JPCommonLabelPhoneme_initialize(JPCommonLabelPhoneme * p, const char *phoneme,
+static void JPCommonLabelPhoneme_initialize(OJTArena * arena, JPCommonLabelPhoneme * p,
+                                            const char *phoneme,
                                             JPCommonLabelPhoneme * prev,
                                             JPCommonLabelPhoneme * next, JPCommonLabelMora * up)
 {
-   p->phoneme = strdup(phoneme);
+   p->phoneme = OJTArena_strdup(arena, phoneme);
    p->prev = prev;
    p->next = next;
    p->up = up;
 }
 
-static void JPCommonLabelPhoneme_convert_unvoice(JPCommonLabelPhoneme * p)
+static void JPCommonLabelPhoneme_convert_unvoice(OJTArena * arena, JPCommonLabelPhoneme * p)
 {
    int i;
 
    for (i = 0; jpcommon_unvoice_list[i] != NULL; i += 2) {
       if (strcmp(jpcommon_unvoice_list[i], p->phoneme) == 0) {
-         free(p->phoneme);
-         p->phoneme = strdup(jpcommon_unvoice_list[i + 1]);
+         OJTArena_free(arena, p->phoneme);
+         p->phoneme = OJTArena_strdup(arena, jpcommon_unvoice_list[i + 1]);
          return;
       }
    }
@@ -135,17 +138,17 @@ static void JPCommonLabelPhoneme_convert_unvoice(JPCommonLabelPhoneme * p)
            p->phoneme);
 }
 
-static void JPCommonLabelPhoneme_clear(JPCommonLabelPhoneme * p)
+static void JPCommonLabelPhoneme_clear(OJTArena * arena, JPCommonLabelPhoneme * p)
 {
-   free(p->phoneme);
+   OJTArena_free(arena, p->phoneme);
 }
 
-static void JPCommonLabelMora_initialize(JPCommonLabelMora * m, const char *mora,
+static void JPCommonLabelMora_initialize(OJTArena * arena, JPCommonLabelMora * m, const char *mora,
                                          JPCommonLabelPhoneme * head, JPCommonLabelPhoneme * tail,
                                          JPCommonLabelMora * prev, JPCommonLabelMora * next,
                                          JPCommonLabelWord * up)
 {
-   m->mora = strdup(mora);
+   m->mora = OJTArena_strdup(arena, mora);
    m->head = head;
    m->tail = tail;
    m->prev = prev;
@@ -153,19 +156,20 @@ static void JPCommonLabelMora_initialize(JPCommonLabelMora * m, const char *mora
    m->up = up;
 }
 
-static void JPCommonLabelMora_clear(JPCommonLabelMora * m)
+static void JPCommonLabelMora_clear(OJTArena * arena, JPCommonLabelMora * m)
 {
-   free(m->mora);
+   OJTArena_free(arena, m->mora);
 }
 
-static void JPCommonLabelWord_initialize(JPCommonLabelWord * w, const char *pron, const char *pos,
+static void JPCommonLabelWord_initialize(OJTArena * arena, JPCommonLabelWord * w, const char *pron,
+                                         const char *pos,
                                          const char *ctype, const char *cform,
                                          JPCommonLabelMora * head, JPCommonLabelMora * tail,
                                          JPCommonLabelWord * prev, JPCommonLabelWord * next)
 {
    int i, find;
 
-   w->pron = strdup(pron);
+   w->pron = OJTArena_strdup(arena, pron);
    for (i = 0, find = 0; jpcommon_pos_list[i] != NULL; i += 2) {
       if (strcmp(jpcommon_pos_list[i], pos) == 0) {
          find = 1;
@@ -178,7 +182,7 @@ static void JPCommonLabelWord_initialize(JPCommonLabelWord * w, const char *pron
               pos);
       i = 0;
    }
-   w->pos = strdup(jpcommon_pos_list[i + 1]);
+   w->pos = OJTArena_strdup(arena, jpcommon_pos_list[i + 1]);
    for (i = 0, find = 0; jpcommon_ctype_list[i] != NULL; i += 2) {
       if (strcmp(jpcommon_ctype_list[i], ctype) == 0) {
          find = 1;
@@ -191,7 +195,7 @@ static void JPCommonLabelWord_initialize(JPCommonLabelWord * w, const char *pron
               ctype);
       i = 0;
    }
-   w->ctype = strdup(jpcommon_ctype_list[i + 1]);
+   w->ctype = OJTArena_strdup(arena, jpcommon_ctype_list[i + 1]);
    for (i = 0, find = 0; jpcommon_cform_list[i] != NULL; i += 2) {
       if (strcmp(jpcommon_cform_list[i], cform) == 0) {
          find = 1;
@@ -204,22 +208,23 @@ static void JPCommonLabelWord_initialize(JPCommonLabelWord * w, const char *pron
               cform);
       i = 0;
    }
-   w->cform = strdup(jpcommon_cform_list[i + 1]);
+   w->cform = OJTArena_strdup(arena, jpcommon_cform_list[i + 1]);
    w->head = head;
    w->tail = tail;
    w->prev = prev;
    w->next = next;
 }
 
-static void JPCommonLabelWord_clear(JPCommonLabelWord * w)
+static void JPCommonLabelWord_clear(OJTArena * arena, JPCommonLabelWord * w)
 {
-   free(w->pron);
-   free(w->pos);
-   free(w->ctype);
-   free(w->cform);
+   OJTArena_free(arena, w->pron);
+   OJTArena_free(arena, w->pos);
+   OJTArena_free(arena, w->ctype);
+   OJTArena_free(arena, w->cform);
 }
 
-static void JPCommonLabelAccentPhrase_initialize(JPCommonLabelAccentPhrase * a, int acc,
+static void JPCommonLabelAccentPhrase_initialize(OJTArena * arena, JPCommonLabelAccentPhrase * a,
+                                                 int acc,
                                                  const char *emotion, JPCommonLabelWord * head,
                                                  JPCommonLabelWord * tail,
                                                  JPCommonLabelAccentPhrase * prev,
@@ -228,7 +233,7 @@ static void JPCommonLabelAccentPhrase_initialize(JPCommonLabelAccentPhrase * a,
 {
    a->accent = acc;
    if (emotion != NULL)
-      a->emotion = strdup(emotion);
+      a->emotion = OJTArena_strdup(arena, emotion);
    else
       a->emotion = NULL;
    a->head = head;
@@ -238,10 +243,10 @@ static void JPCommonLabelAccentPhrase_initialize(JPCommonLabelAccentPhrase * a,
    a->up = up;
 }
 
-static void JPCommonLabelAccentPhrase_clear(JPCommonLabelAccentPhrase * a)
+static void JPCommonLabelAccentPhrase_clear(OJTArena * arena, JPCommonLabelAccentPhrase * a)
 {
    if (a->emotion != NULL)
-      free(a->emotion);
+      OJTArena_free(arena, a->emotion);
 }
 
 static void JPCommonLabelBreathGroup_initialize(JPCommonLabelBreathGroup * b,
@@ -260,142 +265,50 @@ static void JPCommonLabelBreathGroup_clear(JPCommonLabelBreathGroup * b)
 {
 }
 
-static int index_mora_in_accent_phrase(JPCommonLabelMora * m)
+/* number mora, accent phrase and breath group lists from 1 in one pass each */
+static void JPCommonLabel_set_index(JPCommonLabel * label)
 {
    int i;
-   JPCommonLabelMora *index;
+   JPCommonLabelMora *m;
+   JPCommonLabelAccentPhrase *a;
+   JPCommonLabelBreathGroup *b;
 
-   for (i = 0, index = m->up->up->head->head; index != NULL; index = index->next) {
-      i++;
-      if (index == m)
-         break;
-   }
-   return i;
+   for (i = 1, m = label->mora_head; m != NULL; m = m->next)
+      m->index = i++;
+   for (i = 1, a = label->accent_head; a != NULL; a = a->next)
+      a->index = i++;
+   for (i = 1, b = label->breath_head; b != NULL; b = b->next)
+      b->index = i++;
 }
 
-static int count_mora_in_accent_phrase(JPCommonLabelMora * m)
+static int index_mora_in_accent_phrase(JPCommonLabelMora * m)
 {
-   int i;
-   JPCommonLabelMora *index;
+   return m->index - m->up->up->head->head->index + 1;
+}
 
-   for (i = 0, index = m->up->up->head->head; index != NULL; index = index->next) {
-      i++;
-      if (index == m->up->up->tail->tail)
-         break;
-   }
-   return i;
+static int count_mora_in_accent_phrase(JPCommonLabelMora * m)
+{
+   return m->up->up->tail->tail->index - m->up->up->head->head->index + 1;
 }
 
 static int index_accent_phrase_in_breath_group(JPCommonLabelAccentPhrase * a)
 {
-   int i;
-   JPCommonLabelAccentPhrase *index;
-
-   for (i = 0, index = a->up->head; index != NULL; index = index->next) {
-      i++;
-      if (index == a)
-         break;
-   }
-   return i;
+   return a->index - a->up->head->index + 1;
 }
 
 static int count_accent_phrase_in_breath_group(JPCommonLabelAccentPhrase * a)
 {
-   int i;
-   JPCommonLabelAccentPhrase *index;
-
-   for (i = 0, index = a->up->head; index != NULL; index = index->next) {
-      i++;
-      if (index == a->up->tail)
-         break;
-   }
-   return i;
+   return a->up->tail->index - a->up->head->index + 1;
 }
 
 static int index_mora_in_breath_group(JPCommonLabelMora * m)
 {
-   int i;
-   JPCommonLabelMora *index;
-
-   for (i = 0, index = m->up->up->up->head->head->head; index != NULL; index = index->next) {
-      i++;
-      if (index == m)
-         break;
-   }
-   return i;
+   return m->index - m->up->up->up->head->head->head->index + 1;
 }
 
 static int count_mora_in_breath_group(JPCommonLabelMora * m)
 {
-   int i;
-   JPCommonLabelMora *index;
-
-   for (i = 0, index = m->up->up->up->head->head->head; index != NULL; index = index->next) {
-      i++;
-      if (index == m->up->up->up->tail->tail->tail)
-         break;
-   }
-   return i;
-}
-
-static int index_breath_group_in_utterance(JPCommonLabelBreathGroup * b)
-{
-   int i;
-   JPCommonLabelBreathGroup *index;
-
-   for (i = 0, index = b; index != NULL; index = index->prev)
-      i++;
-   return i;
-}
-
-static int count_breath_group_in_utterance(JPCommonLabelBreathGroup * b)
-{
-   int i;
-   JPCommonLabelBreathGroup *index;
-
-   for (i = 0, index = b->next; index != NULL; index = index->next)
-      i++;
-   return index_breath_group_in_utterance(b) + i;
-}
-
-static int index_accent_phrase_in_utterance(JPCommonLabelAccentPhrase * a)
-{
-   int i;
-   JPCommonLabelAccentPhrase *index;
-
-   for (i = 0, index = a; index != NULL; index = index->prev)
-      i++;
-   return i;
-}
-
-static int count_accent_phrase_in_utterance(JPCommonLabelAccentPhrase * a)
-{
-   int i;
-   JPCommonLabelAccentPhrase *index;
-
-   for (i = 0, index = a->next; index != NULL; index = index->next)
-      i++;
-   return index_accent_phrase_in_utterance(a) + i;
-}
-
-static int index_mora_in_utterance(JPCommonLabelMora * m)
-{
-   int i;
-   JPCommonLabelMora *index;
-
-   for (i = 0, index = m; index != NULL; index = index->prev)
-      i++;
-   return i;
-}
-
-static int count_mora_in_utterance(JPCommonLabelMora * m)
-{
-   int i;
-   JPCommonLabelMora *index;
-
-   for (i = 0, index = m->next; index != NULL; index = index->next)
-      i++;
-   return index_mora_in_utterance(m) + i;
+   return m->up->up->up->tail->tail->tail->index - m->up->up->up->head->head->head->index + 1;
 }
 
 void JPCommonLabel_initialize(JPCommonLabel * label)
@@ -414,6 +327,7 @@ void JPCommonLabel_initialize(JPCommonLabel * label)
 
    label->size = 0;
    label->feature = NULL;
+   label->context = NULL;
 }
 
 static void JPCommonLabel_insert_pause(JPCommonLabel * label)
@@ -427,8 +341,10 @@ static void JPCommonLabel_insert_pause(JPCommonLabel * label)
             return;
          }
          label->phoneme_tail->next =
-             (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
-         JPCommonLabelPhoneme_initialize(label->phoneme_tail->next, JPCOMMON_PHONEME_SHORT_PAUSE,
+             (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                      sizeof(JPCommonLabelPhoneme));
+         JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail->next,
+                                         JPCOMMON_PHONEME_SHORT_PAUSE,
                                          label->phoneme_tail, NULL, NULL);
          label->phoneme_tail = label->phoneme_tail->next;
       } else {
@@ -456,10 +372,12 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
       if (label->phoneme_tail != NULL) {
          if (strcmp(label->phoneme_tail->phoneme, JPCOMMON_PHONEME_SHORT_PAUSE) == 0) {
             if (label->phoneme_tail->prev->up->up->up->emotion == NULL)
-               label->phoneme_tail->prev->up->up->up->emotion = strdup(JPCOMMON_FLAG_QUESTION);
+               label->phoneme_tail->prev->up->up->up->emotion = OJTArena_strdup(label->arena,
+                                                                                JPCOMMON_FLAG_QUESTION);
          } else {
             if (label->phoneme_tail->up->up->up->emotion == NULL)
-               label->phoneme_tail->up->up->up->emotion = strdup(JPCOMMON_FLAG_QUESTION);
+               label->phoneme_tail->up->up->up->emotion = OJTArena_strdup(label->arena,
+                                                                          JPCOMMON_FLAG_QUESTION);
          }
       } else {
          fprintf(stderr,
@@ -477,11 +395,15 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
          if (label->phoneme_tail != NULL && label->short_pause_flag == 0) {
             JPCommonLabel_insert_pause(label);
             label->phoneme_tail->next =
-                (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
-            label->mora_tail->next = (JPCommonLabelMora *) calloc(1, sizeof(JPCommonLabelMora));
-            JPCommonLabelPhoneme_initialize(label->phoneme_tail->next, label->phoneme_tail->phoneme,
+                (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                         sizeof(JPCommonLabelPhoneme));
+            label->mora_tail->next = (JPCommonLabelMora *) OJTArena_calloc(label->arena, 1,
+                                                                           sizeof(JPCommonLabelMora));
+            JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail->next,
+                                            label->phoneme_tail->phoneme,
                                             label->phoneme_tail, NULL, label->mora_tail->next);
-            JPCommonLabelMora_initialize(label->mora_tail->next, JPCOMMON_MORA_LONG_VOWEL,
+            JPCommonLabelMora_initialize(label->arena, label->mora_tail->next,
+                                         JPCOMMON_MORA_LONG_VOWEL,
                                          label->phoneme_tail->next, label->phoneme_tail->next,
                                          label->mora_tail, NULL, label->mora_tail->up);
             label->phoneme_tail = label->phoneme_tail->next;
@@ -497,7 +419,7 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
          if (find != -1) {
             /* for unvoice */
             if (label->phoneme_tail != NULL && is_first_word != 1)
-               JPCommonLabelPhoneme_convert_unvoice(label->phoneme_tail);
+               JPCommonLabelPhoneme_convert_unvoice(label->arena, label->phoneme_tail);
             else
                fprintf(stderr,
                        "WARNING: JPCommonLabel_push_word() in jpcommon_label.c: First mora should not be unvoice flag.\n");
@@ -513,15 +435,21 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
                if (label->phoneme_tail == NULL) {
                   JPCommonLabel_insert_pause(label);
                   label->phoneme_tail =
-                      (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
-                  label->mora_tail = (JPCommonLabelMora *) calloc(1, sizeof(JPCommonLabelMora));
-                  label->word_tail = (JPCommonLabelWord *) calloc(1, sizeof(JPCommonLabelWord));
-                  JPCommonLabelPhoneme_initialize(label->phoneme_tail, jpcommon_mora_list[i + 1],
+                      (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                               sizeof(JPCommonLabelPhoneme));
+                  label->mora_tail = (JPCommonLabelMora *) OJTArena_calloc(label->arena, 1,
+                                                                           sizeof(JPCommonLabelMora));
+                  label->word_tail = (JPCommonLabelWord *) OJTArena_calloc(label->arena, 1,
+                                                                           sizeof(JPCommonLabelWord));
+                  JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail,
+                                                  jpcommon_mora_list[i + 1],
                                                   NULL, NULL, label->mora_tail);
-                  JPCommonLabelMora_initialize(label->mora_tail, jpcommon_mora_list[i],
+                  JPCommonLabelMora_initialize(label->arena, label->mora_tail,
+                                               jpcommon_mora_list[i],
                                                label->phoneme_tail, label->phoneme_tail, NULL, NULL,
                                                label->word_tail);
-                  JPCommonLabelWord_initialize(label->word_tail, pron, pos, ctype, cform,
+                  JPCommonLabelWord_initialize(label->arena, label->word_tail, pron, pos, ctype,
+                                               cform,
                                                label->mora_tail, label->mora_tail, NULL, NULL);
                   label->phoneme_head = label->phoneme_tail;
                   label->mora_head = label->mora_tail;
@@ -531,19 +459,24 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
                   if (is_first_word == 1) {
                      JPCommonLabel_insert_pause(label);
                      label->phoneme_tail->next =
-                         (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
+                         (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                                  sizeof(JPCommonLabelPhoneme));
                      label->mora_tail->next =
-                         (JPCommonLabelMora *) calloc(1, sizeof(JPCommonLabelMora));
+                         (JPCommonLabelMora *) OJTArena_calloc(label->arena, 1,
+                                                               sizeof(JPCommonLabelMora));
                      label->word_tail->next =
-                         (JPCommonLabelWord *) calloc(1, sizeof(JPCommonLabelWord));
-                     JPCommonLabelPhoneme_initialize(label->phoneme_tail->next,
+                         (JPCommonLabelWord *) OJTArena_calloc(label->arena, 1,
+                                                               sizeof(JPCommonLabelWord));
+                     JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail->next,
                                                      jpcommon_mora_list[i + 1], label->phoneme_tail,
                                                      NULL, label->mora_tail->next);
-                     JPCommonLabelMora_initialize(label->mora_tail->next, jpcommon_mora_list[i],
+                     JPCommonLabelMora_initialize(label->arena, label->mora_tail->next,
+                                                  jpcommon_mora_list[i],
                                                   label->phoneme_tail->next,
                                                   label->phoneme_tail->next, label->mora_tail, NULL,
                                                   label->word_tail->next);
-                     JPCommonLabelWord_initialize(label->word_tail->next, pron, pos, ctype, cform,
+                     JPCommonLabelWord_initialize(label->arena, label->word_tail->next, pron, pos,
+                                                  ctype, cform,
                                                   label->mora_tail->next, label->mora_tail->next,
                                                   label->word_tail, NULL);
                      label->phoneme_tail = label->phoneme_tail->next;
@@ -553,13 +486,16 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
                   } else {
                      JPCommonLabel_insert_pause(label);
                      label->phoneme_tail->next =
-                         (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
+                         (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                                  sizeof(JPCommonLabelPhoneme));
                      label->mora_tail->next =
-                         (JPCommonLabelMora *) calloc(1, sizeof(JPCommonLabelMora));
-                     JPCommonLabelPhoneme_initialize(label->phoneme_tail->next,
+                         (JPCommonLabelMora *) OJTArena_calloc(label->arena, 1,
+                                                               sizeof(JPCommonLabelMora));
+                     JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail->next,
                                                      jpcommon_mora_list[i + 1], label->phoneme_tail,
                                                      NULL, label->mora_tail->next);
-                     JPCommonLabelMora_initialize(label->mora_tail->next, jpcommon_mora_list[i],
+                     JPCommonLabelMora_initialize(label->arena, label->mora_tail->next,
+                                                  jpcommon_mora_list[i],
                                                   label->phoneme_tail->next,
                                                   label->phoneme_tail->next, label->mora_tail, NULL,
                                                   label->mora_tail->up);
@@ -571,8 +507,9 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
                if (jpcommon_mora_list[i + 2] != NULL) {
                   JPCommonLabel_insert_pause(label);
                   label->phoneme_tail->next =
-                      (JPCommonLabelPhoneme *) calloc(1, sizeof(JPCommonLabelPhoneme));
-                  JPCommonLabelPhoneme_initialize(label->phoneme_tail->next,
+                      (JPCommonLabelPhoneme *) OJTArena_calloc(label->arena, 1,
+                                                               sizeof(JPCommonLabelPhoneme));
+                  JPCommonLabelPhoneme_initialize(label->arena, label->phoneme_tail->next,
                                                   jpcommon_mora_list[i + 2], label->phoneme_tail,
                                                   NULL, label->mora_tail);
                   label->phoneme_tail = label->phoneme_tail->next;
@@ -601,11 +538,14 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
    if (label->word_head == label->word_tail) {
       /* first word */
       label->accent_tail =
-          (JPCommonLabelAccentPhrase *) calloc(1, sizeof(JPCommonLabelAccentPhrase));
+          (JPCommonLabelAccentPhrase *) OJTArena_calloc(label->arena, 1,
+                                                        sizeof(JPCommonLabelAccentPhrase));
 
-      label->breath_tail = (JPCommonLabelBreathGroup *) calloc(1, sizeof(JPCommonLabelBreathGroup));
+      label->breath_tail = (JPCommonLabelBreathGroup *) OJTArena_calloc(label->arena, 1,
+                                                                        sizeof(JPCommonLabelBreathGroup));
       label->word_tail->up = label->accent_tail;
-      JPCommonLabelAccentPhrase_initialize(label->accent_tail, acc, NULL, label->word_tail,
+      JPCommonLabelAccentPhrase_initialize(label->arena, label->accent_tail, acc, NULL,
+                                           label->word_tail,
                                            label->word_tail, NULL, NULL, label->breath_tail);
       JPCommonLabelBreathGroup_initialize(label->breath_tail, label->accent_tail,
                                           label->accent_tail, NULL, NULL);
@@ -620,9 +560,11 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
            != 0) {
       /* different accent phrase && common phrase */
       label->accent_tail->next =
-          (JPCommonLabelAccentPhrase *) calloc(1, sizeof(JPCommonLabelAccentPhrase));
+          (JPCommonLabelAccentPhrase *) OJTArena_calloc(label->arena, 1,
+                                                        sizeof(JPCommonLabelAccentPhrase));
       label->word_tail->up = label->accent_tail->next;
-      JPCommonLabelAccentPhrase_initialize(label->accent_tail->next, acc, NULL, label->word_tail,
+      JPCommonLabelAccentPhrase_initialize(label->arena, label->accent_tail->next, acc, NULL,
+                                           label->word_tail,
                                            label->word_tail, label->accent_tail, NULL,
                                            label->breath_tail);
       label->breath_tail->tail = label->accent_tail->next;
@@ -630,11 +572,14 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
    } else {
       /* different accent phrase && different phrase */
       label->accent_tail->next =
-          (JPCommonLabelAccentPhrase *) calloc(1, sizeof(JPCommonLabelAccentPhrase));
+          (JPCommonLabelAccentPhrase *) OJTArena_calloc(label->arena, 1,
+                                                        sizeof(JPCommonLabelAccentPhrase));
       label->breath_tail->next =
-          (JPCommonLabelBreathGroup *) calloc(1, sizeof(JPCommonLabelBreathGroup));
+          (JPCommonLabelBreathGroup *) OJTArena_calloc(label->arena, 1,
+                                                       sizeof(JPCommonLabelBreathGroup));
       label->word_tail->up = label->accent_tail->next;
-      JPCommonLabelAccentPhrase_initialize(label->accent_tail->next, acc, NULL, label->word_tail,
+      JPCommonLabelAccentPhrase_initialize(label->arena, label->accent_tail->next, acc, NULL,
+                                           label->word_tail,
                                            label->word_tail, label->accent_tail, NULL,
                                            label->breath_tail->next);
       JPCommonLabelBreathGroup_initialize(label->breath_tail->next, label->accent_tail->next,
@@ -644,14 +589,102 @@ void JPCommonLabel_push_word(JPCommonLabel * label, const char *pron, const char
    }
 }
 
+static const struct {
+   const char *prefix;
+   int type;
+} jpcommon_label_field[JPCOMMON_LABEL_FIELD_SIZE] = {
+   {"", JPCOMMON_LABEL_TYPE_STRING}, {"^", JPCOMMON_LABEL_TYPE_STRING},
+   {"-", JPCOMMON_LABEL_TYPE_STRING}, {"+", JPCOMMON_LABEL_TYPE_STRING},
+   {"=", JPCOMMON_LABEL_TYPE_STRING},
+   {"/A:", JPCOMMON_LABEL_TYPE_SIGNED}, {"+", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"+", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/B:", JPCOMMON_LABEL_TYPE_STRING}, {"-", JPCOMMON_LABEL_TYPE_STRING},
+   {"_", JPCOMMON_LABEL_TYPE_STRING},
+   {"/C:", JPCOMMON_LABEL_TYPE_STRING}, {"_", JPCOMMON_LABEL_TYPE_STRING},
+   {"+", JPCOMMON_LABEL_TYPE_STRING},
+   {"/D:", JPCOMMON_LABEL_TYPE_STRING}, {"+", JPCOMMON_LABEL_TYPE_STRING},
+   {"_", JPCOMMON_LABEL_TYPE_STRING},
+   {"/E:", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"!", JPCOMMON_LABEL_TYPE_STRING}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"-", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/F:", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"#", JPCOMMON_LABEL_TYPE_STRING}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"@", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"|", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/G:", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"%", JPCOMMON_LABEL_TYPE_STRING}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/H:", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/I:", JPCOMMON_LABEL_TYPE_INTEGER}, {"-", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"@", JPCOMMON_LABEL_TYPE_INTEGER}, {"+", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"&", JPCOMMON_LABEL_TYPE_INTEGER}, {"-", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"|", JPCOMMON_LABEL_TYPE_INTEGER}, {"+", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/J:", JPCOMMON_LABEL_TYPE_INTEGER}, {"_", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"/K:", JPCOMMON_LABEL_TYPE_INTEGER}, {"+", JPCOMMON_LABEL_TYPE_INTEGER},
+   {"-", JPCOMMON_LABEL_TYPE_INTEGER}
+};
+
+const char *JPCommonLabelField_get_prefix(JPCommonLabelField field)
+{
+   return jpcommon_label_field[field].prefix;
+}
+
+int JPCommonLabelField_get_type(JPCommonLabelField field)
+{
+   return jpcommon_label_field[field].type;
+}
+
+/* set pos, ctype and cform of word (for B:, C: and D:) */
+static void set_word(JPCommonLabelValue * v, JPCommonLabelWord * w)
+{
+   if (w == NULL) {
+      v[0].string = JPCOMMON_LABEL_UNKNOWN;
+      v[1].string = JPCOMMON_LABEL_UNKNOWN;
+      v[2].string = JPCOMMON_LABEL_UNKNOWN;
+   } else {
+      v[0].string = w->pos;
+      v[1].string = w->ctype;
+      v[2].string = w->cform;
+   }
+}
+
+/* set mora count, accent type and emotion of accent phrase (for E:, F: and G:) */
+static void set_accent_phrase(JPCommonLabelValue * v, JPCommonLabelAccentPhrase * a)
+{
+   if (a == NULL) {
+      v[0].integer = JPCOMMON_LABEL_UNDEFINED;
+      v[1].integer = JPCOMMON_LABEL_UNDEFINED;
+      v[2].string = JPCOMMON_LABEL_UNKNOWN;
+   } else {
+      v[0].integer = limit(count_mora_in_accent_phrase(a->head->head), 1, MAX_M);
+      v[1].integer =
+          limit(a->accent == 0 ? count_mora_in_accent_phrase(a->head->head) : a->accent, 1, MAX_M);
+      v[2].string = a->emotion == NULL ? "0" : a->emotion;
+   }
+   v[3].integer = JPCOMMON_LABEL_UNDEFINED;
+}
+
+/* set accent phrase and mora counts of breath group (for H: and J:) */
+static void set_breath_group(JPCommonLabelValue * v, JPCommonLabelBreathGroup * b)
+{
+   if (b == NULL) {
+      v[0].integer = JPCOMMON_LABEL_UNDEFINED;
+      v[1].integer = JPCOMMON_LABEL_UNDEFINED;
+   } else {
+      v[0].integer = limit(count_accent_phrase_in_breath_group(b->head), 1, MAX_M);
+      v[1].integer = limit(count_mora_in_breath_group(b->head->head->head), 1, MAX_L);
+   }
+}
+
 void JPCommonLabel_make(JPCommonLabel * label)
 {
-   int i, tmp1, tmp2, tmp3;
-   char buff[MAXBUFLEN];
+   int i, j, tmp1, tmp2, tmp3;
+   int breath_size, accent_size, mora_size;
    JPCommonLabelPhoneme *p;
    JPCommonLabelWord *w;
    JPCommonLabelAccentPhrase *a;
    JPCommonLabelBreathGroup *b;
+   JPCommonLabelValue *v;
    char **phoneme_list;
    int short_pause_flag;
 
@@ -663,12 +696,18 @@ void JPCommonLabel_make(JPCommonLabel * label)
       return;
    }
    label->size += 2;
-   label->feature = (char **) calloc(label->size, sizeof(char *));
-   for (i = 0; i < label->size; i++)
-      label->feature[i] = (char *) calloc(MAXBUFLEN, sizeof(char));
+   label->context =
+       (JPCommonLabelValue *) OJTArena_calloc(label->arena, label->size * JPCOMMON_LABEL_FIELD_SIZE,
+                                              sizeof(JPCommonLabelValue));
+
+   /* positions in utterance */
+   JPCommonLabel_set_index(label);
+   breath_size = label->breath_tail->index;
+   accent_size = label->accent_tail->index;
+   mora_size = label->mora_tail->index;
 
    /* phoneme list */
-   phoneme_list = (char **) calloc(label->size + 4, sizeof(char *));
+   phoneme_list = (char **) OJTArena_calloc(label->arena, label->size + 4, sizeof(char *));
    phoneme_list[0] = JPCOMMON_PHONEME_UNKNOWN;
    phoneme_list[1] = JPCOMMON_PHONEME_UNKNOWN;
    phoneme_list[2] = JPCOMMON_PHONEME_SILENT;
@@ -679,26 +718,30 @@ void JPCommonLabel_make(JPCommonLabel * label)
       phoneme_list[i++] = p->phoneme;
 
    for (i = 0, p = label->phoneme_head; i < label->size; i++) {
+      v = &label->context[i * JPCOMMON_LABEL_FIELD_SIZE];
       if (strcmp(p->phoneme, JPCOMMON_PHONEME_SHORT_PAUSE) == 0)
          short_pause_flag = 1;
       else
          short_pause_flag = 0;
 
       /* for phoneme */
-      sprintf(label->feature[i], "%s^%s-%s+%s=%s", phoneme_list[i], phoneme_list[i + 1],
-              phoneme_list[i + 2], phoneme_list[i + 3], phoneme_list[i + 4]);
+      for (j = 0; j < 5; j++)
+         v[JPCOMMON_LABEL_P1 + j].string = phoneme_list[i + j];
       /* for A: */
-      if (i == 0 || i == label->size - 1 || short_pause_flag == 1)
-         sprintf(buff, "/A:xx+xx+xx");
-      else {
+      if (i == 0 || i == label->size - 1 || short_pause_flag == 1) {
+         v[JPCOMMON_LABEL_A1].integer = JPCOMMON_LABEL_UNDEFINED;
+         v[JPCOMMON_LABEL_A2].integer = JPCOMMON_LABEL_UNDEFINED;
+         v[JPCOMMON_LABEL_A3].integer = JPCOMMON_LABEL_UNDEFINED;
+      } else {
          tmp1 = index_mora_in_accent_phrase(p->up);
          tmp2 =
              p->up->up->up->accent ==
              0 ? count_mora_in_accent_phrase(p->up) : p->up->up->up->accent;
-         sprintf(buff, "/A:%d+%d+%d", limit(tmp1 - tmp2, -MAX_M, MAX_M), limit(tmp1, 1, MAX_M),
-                 limit(count_mora_in_accent_phrase(p->up) - tmp1 + 1, 1, MAX_M));
+         v[JPCOMMON_LABEL_A1].integer = limit(tmp1 - tmp2, -MAX_M, MAX_M);
+         v[JPCOMMON_LABEL_A2].integer = limit(tmp1, 1, MAX_M);
+         v[JPCOMMON_LABEL_A3].integer =
+             limit(count_mora_in_accent_phrase(p->up) - tmp1 + 1, 1, MAX_M);
       }
-      strcat(label->feature[i], buff);
       /* for B: */
       if (short_pause_flag == 1)
          w = p->prev->up->up;
@@ -708,17 +751,12 @@ void JPCommonLabel_make(JPCommonLabel * label)
          w = p->up->up;
       else
          w = p->up->up->prev;
-      if (w == NULL)
-         sprintf(buff, "/B:xx-xx_xx");
-      else
-         sprintf(buff, "/B:%s-%s_%s", w->pos, w->ctype, w->cform);
-      strcat(label->feature[i], buff);
+      set_word(&v[JPCOMMON_LABEL_B1], w);
       /* for C: */
       if (i == 0 || i == label->size - 1 || short_pause_flag)
-         sprintf(buff, "/C:xx_xx+xx");
+         set_word(&v[JPCOMMON_LABEL_C1], NULL);
       else
-         sprintf(buff, "/C:%s_%s+%s", p->up->up->pos, p->up->up->ctype, p->up->up->cform);
-      strcat(label->feature[i], buff);
+         set_word(&v[JPCOMMON_LABEL_C1], p->up->up);
       /* for D: */
       if (short_pause_flag == 1)
          w = p->next->up->up;
@@ -728,11 +766,7 @@ void JPCommonLabel_make(JPCommonLabel * label)
          w = p->up->up;
       else
          w = p->up->up->next;
-      if (w == NULL)
-         sprintf(buff, "/D:xx+xx_xx");
-      else
-         sprintf(buff, "/D:%s+%s_%s", w->pos, w->ctype, w->cform);
-      strcat(label->feature[i], buff);
+      set_word(&v[JPCOMMON_LABEL_D1], w);
       /* for E: */
       if (short_pause_flag == 1)
          a = p->prev->up->up->up;
@@ -740,40 +774,31 @@ void JPCommonLabel_make(JPCommonLabel * label)
          a = p->up->up->up;
       else
          a = p->up->up->up->prev;
-      if (a == NULL)
-         sprintf(buff, "/E:xx_xx!xx_xx");
-      else
-         sprintf(buff, "/E:%d_%d!%s_xx",
-                 limit(count_mora_in_accent_phrase(a->head->head), 1, MAX_M),
-                 limit(a->accent == 0 ? count_mora_in_accent_phrase(a->head->head) : a->accent, 1,
-                       MAX_M), a->emotion == NULL ? "0" : a->emotion);
-      strcat(label->feature[i], buff);
+      set_accent_phrase(&v[JPCOMMON_LABEL_E1], a);
       if (i == 0 || i == label->size - 1 || short_pause_flag == 1 || a == NULL)
-         sprintf(buff, "-xx");
+         v[JPCOMMON_LABEL_E5].integer = JPCOMMON_LABEL_UNDEFINED;
       else
-         sprintf(buff, "-%d",
-                 strcmp(a->tail->tail->tail->next->phoneme,
-                        JPCOMMON_PHONEME_SHORT_PAUSE) == 0 ? 0 : 1);
-      strcat(label->feature[i], buff);
+         v[JPCOMMON_LABEL_E5].integer =
+             strcmp(a->tail->tail->tail->next->phoneme, JPCOMMON_PHONEME_SHORT_PAUSE) == 0 ? 0 : 1;
       /* for F: */
       if (i == 0 || i == label->size - 1 || short_pause_flag == 1)
          a = NULL;
       else
          a = p->up->up->up;
-      if (a == NULL)
-         sprintf(buff, "/F:xx_xx#xx_xx@xx_xx|xx_xx");
-      else {
+      set_accent_phrase(&v[JPCOMMON_LABEL_F1], a);
+      if (a == NULL) {
+         for (j = JPCOMMON_LABEL_F5; j <= JPCOMMON_LABEL_F8; j++)
+            v[j].integer = JPCOMMON_LABEL_UNDEFINED;
+      } else {
          tmp1 = index_accent_phrase_in_breath_group(a);
          tmp2 = index_mora_in_breath_group(a->head->head);
-         sprintf(buff, "/F:%d_%d#%s_xx@%d_%d|%d_%d",
-                 limit(count_mora_in_accent_phrase(a->head->head), 1, MAX_M),
-                 limit(a->accent == 0 ? count_mora_in_accent_phrase(a->head->head) : a->accent, 1,
-                       MAX_M), a->emotion == NULL ? "0" : a->emotion, limit(tmp1, 1, MAX_M),
-                 limit(count_accent_phrase_in_breath_group(a) - tmp1 + 1, 1, MAX_M), limit(tmp2, 1,
-                                                                                           MAX_L),
-                 limit(count_mora_in_breath_group(a->head->head) - tmp2 + 1, 1, MAX_L));
+         v[JPCOMMON_LABEL_F5].integer = limit(tmp1, 1, MAX_M);
+         v[JPCOMMON_LABEL_F6].integer =
+             limit(count_accent_phrase_in_breath_group(a) - tmp1 + 1, 1, MAX_M);
+         v[JPCOMMON_LABEL_F7].integer = limit(tmp2, 1, MAX_L);
+         v[JPCOMMON_LABEL_F8].integer =
+             limit(count_mora_in_breath_group(a->head->head) - tmp2 + 1, 1, MAX_L);
       }
-      strcat(label->feature[i], buff);
       /* for G: */
       if (short_pause_flag == 1)
          a = p->next->up->up->up;
@@ -781,21 +806,12 @@ void JPCommonLabel_make(JPCommonLabel * label)
          a = p->up->up->up;
       else
          a = p->up->up->up->next;
-      if (a == NULL)
-         sprintf(buff, "/G:xx_xx%%xx_xx");
-      else
-         sprintf(buff, "/G:%d_%d%%%s_xx",
-                 limit(count_mora_in_accent_phrase(a->head->head), 1, MAX_M),
-                 limit(a->accent == 0 ? count_mora_in_accent_phrase(a->head->head) : a->accent, 1,
-                       MAX_M), a->emotion == NULL ? "0" : a->emotion);
-      strcat(label->feature[i], buff);
+      set_accent_phrase(&v[JPCOMMON_LABEL_G1], a);
       if (i == 0 || i == label->size - 1 || short_pause_flag == 1 || a == NULL)
-         sprintf(buff, "_xx");
+         v[JPCOMMON_LABEL_G5].integer = JPCOMMON_LABEL_UNDEFINED;
       else
-         sprintf(buff, "_%d",
-                 strcmp(a->head->head->head->prev->phoneme,
-                        JPCOMMON_PHONEME_SHORT_PAUSE) == 0 ? 0 : 1);
-      strcat(label->feature[i], buff);
+         v[JPCOMMON_LABEL_G5].integer =
+             strcmp(a->head->head->head->prev->phoneme, JPCOMMON_PHONEME_SHORT_PAUSE) == 0 ? 0 : 1;
       /* for H: */
       if (short_pause_flag == 1)
          b = p->prev->up->up->up->up;
@@ -803,35 +819,27 @@ void JPCommonLabel_make(JPCommonLabel * label)
          b = p->up->up->up->up;
       else
          b = p->up->up->up->up->prev;
-      if (b == NULL)
-         sprintf(buff, "/H:xx_xx");
-      else
-         sprintf(buff, "/H:%d_%d", limit(count_accent_phrase_in_breath_group(b->head), 1, MAX_M),
-                 limit(count_mora_in_breath_group(b->head->head->head), 1, MAX_L));
-      strcat(label->feature[i], buff);
+      set_breath_group(&v[JPCOMMON_LABEL_H1], b);
       /* for I: */
       if (i == 0 || i == label->size - 1 || short_pause_flag == 1)
          b = NULL;
       else
          b = p->up->up->up->up;
-      if (b == NULL)
-         sprintf(buff, "/I:xx-xx@xx+xx&xx-xx|xx+xx");
-      else {
-         tmp1 = index_breath_group_in_utterance(b);
-         tmp2 = index_accent_phrase_in_utterance(b->head);
-         tmp3 = index_mora_in_utterance(b->head->head->head);
-         sprintf(buff, "/I:%d-%d@%d+%d&%d-%d|%d+%d",
-                 limit(count_accent_phrase_in_breath_group(b->head), 1, MAX_M),
-                 limit(count_mora_in_breath_group(b->head->head->head), 1, MAX_L), limit(tmp1, 1,
-                                                                                         MAX_S),
-                 limit(count_breath_group_in_utterance(b) - tmp1 + 1, 1, MAX_S), limit(tmp2, 1,
-                                                                                       MAX_M),
-                 limit(count_accent_phrase_in_utterance(b->head) - tmp2 + 1, 1, MAX_M), limit(tmp3,
-                                                                                              1,
-                                                                                              MAX_LL),
-                 limit(count_mora_in_utterance(b->head->head->head) - tmp3 + 1, 1, MAX_LL));
+      set_breath_group(&v[JPCOMMON_LABEL_I1], b);
+      if (b == NULL) {
+         for (j = JPCOMMON_LABEL_I3; j <= JPCOMMON_LABEL_I8; j++)
+            v[j].integer = JPCOMMON_LABEL_UNDEFINED;
+      } else {
+         tmp1 = b->index;
+         tmp2 = b->head->index;
+         tmp3 = b->head->head->head->index;
+         v[JPCOMMON_LABEL_I3].integer = limit(tmp1, 1, MAX_S);
+         v[JPCOMMON_LABEL_I4].integer = limit(breath_size - tmp1 + 1, 1, MAX_S);
+         v[JPCOMMON_LABEL_I5].integer = limit(tmp2, 1, MAX_M);
+         v[JPCOMMON_LABEL_I6].integer = limit(accent_size - tmp2 + 1, 1, MAX_M);
+         v[JPCOMMON_LABEL_I7].integer = limit(tmp3, 1, MAX_LL);
+         v[JPCOMMON_LABEL_I8].integer = limit(mora_size - tmp3 + 1, 1, MAX_LL);
       }
-      strcat(label->feature[i], buff);
       /* for J: */
       if (short_pause_flag == 1)
          b = p->next->up->up->up->up;
@@ -839,25 +847,42 @@ void JPCommonLabel_make(JPCommonLabel * label)
          b = p->up->up->up->up;
       else
          b = p->up->up->up->up->next;
-      if (b == NULL)
-         sprintf(buff, "/J:xx_xx");
-      else
-         sprintf(buff, "/J:%d_%d", limit(count_accent_phrase_in_breath_group(b->head), 1, MAX_M),
-                 limit(count_mora_in_breath_group(b->head->head->head), 1, MAX_L));
-      strcat(label->feature[i], buff);
+      set_breath_group(&v[JPCOMMON_LABEL_J1], b);
       /* for K: */
-      sprintf(buff, "/K:%d+%d-%d",
-              limit(count_breath_group_in_utterance(label->breath_head), 1, MAX_S),
-              limit(count_accent_phrase_in_utterance(label->accent_head), 1, MAX_M),
-              limit(count_mora_in_utterance(label->mora_head), 1, MAX_LL));
-      strcat(label->feature[i], buff);
+      v[JPCOMMON_LABEL_K1].integer = limit(breath_size, 1, MAX_S);
+      v[JPCOMMON_LABEL_K2].integer = limit(accent_size, 1, MAX_M);
+      v[JPCOMMON_LABEL_K3].integer = limit(mora_size, 1, MAX_LL);
 
       if (0 < i && i < label->size - 2)
          p = p->next;
    }
 
    /* free */
-   free(phoneme_list);
+   OJTArena_free(label->arena, phoneme_list);
+}
+
+/* write string form of context, used only for output */
+static void JPCommonLabel_make_feature(JPCommonLabel * label)
+{
+   int i, j, length;
+   JPCommonLabelValue *v;
+
+   label->feature = (char **) OJTArena_calloc(label->arena, label->size, sizeof(char *));
+   for (i = 0; i < label->size; i++) {
+      label->feature[i] = (char *) OJTArena_calloc(label->arena, MAXBUFLEN, sizeof(char));
+      v = &label->context[i * JPCOMMON_LABEL_FIELD_SIZE];
+      for (j = 0, length = 0; j < JPCOMMON_LABEL_FIELD_SIZE; j++) {
+         if (jpcommon_label_field[j].type == JPCOMMON_LABEL_TYPE_STRING)
+            length += sprintf(&label->feature[i][length], "%s%s", jpcommon_label_field[j].prefix,
+                              v[j].string);
+         else if (v[j].integer == JPCOMMON_LABEL_UNDEFINED)
+            length += sprintf(&label->feature[i][length], "%s%s", jpcommon_label_field[j].prefix,
+                              JPCOMMON_LABEL_UNKNOWN);
+         else
+            length += sprintf(&label->feature[i][length], "%s%d", jpcommon_label_field[j].prefix,
+                              v[j].integer);
+      }
+   }
 }
 
 int JPCommonLabel_get_size(JPCommonLabel * label)
@@ -865,8 +890,15 @@ int JPCommonLabel_get_size(JPCommonLabel * label)
    return label->size;
 }
 
+JPCommonLabelValue *JPCommonLabel_get_context(JPCommonLabel * label)
+{
+   return label->context;
+}
+
 char **JPCommonLabel_get_feature(JPCommonLabel * label)
 {
+   if (label->feature == NULL && label->context != NULL)
+      JPCommonLabel_make_feature(label);
    return label->feature;
 }
 
@@ -919,36 +951,42 @@ void JPCommonLabel_clear(JPCommonLabel * label)
    JPCommonLabelAccentPhrase *a, *an;
    JPCommonLabelBreathGroup *b, *bn;
 
+   /* arena memory is released all at once by OJTArena_reset() */
+   if (label->arena != NULL)
+      return;
+
    for (p = label->phoneme_head; p != NULL; p = pn) {
       pn = p->next;
-      JPCommonLabelPhoneme_clear(p);
-      free(p);
+      JPCommonLabelPhoneme_clear(label->arena, p);
+      OJTArena_free(label->arena, p);
    }
    for (m = label->mora_head; m != NULL; m = mn) {
       mn = m->next;
-      JPCommonLabelMora_clear(m);
-      free(m);
+      JPCommonLabelMora_clear(label->arena, m);
+      OJTArena_free(label->arena, m);
    }
    for (w = label->word_head; w != NULL; w = wn) {
       wn = w->next;
-      JPCommonLabelWord_clear(w);
-      free(w);
+      JPCommonLabelWord_clear(label->arena, w);
+      OJTArena_free(label->arena, w);
    }
    for (a = label->accent_head; a != NULL; a = an) {
       an = a->next;
-      JPCommonLabelAccentPhrase_clear(a);
-      free(a);
+      JPCommonLabelAccentPhrase_clear(label->arena, a);
+      OJTArena_free(label->arena, a);
    }
    for (b = label->breath_head; b != NULL; b = bn) {
       bn = b->next;
       JPCommonLabelBreathGroup_clear(b);
-      free(b);
+      OJTArena_free(label->arena, b);
    }
    if (label->feature != NULL) {
       for (i = 0; i < label->size; i++)
-         free(label->feature[i]);
-      free(label->feature);
+         OJTArena_free(label->arena, label->feature[i]);
+      OJTArena_free(label->arena, label->feature);
    }
+   if (label->context != NULL)
+      OJTArena_free(label->arena, label->context);
 }
 
 JPCOMMON_LABEL_C_END;
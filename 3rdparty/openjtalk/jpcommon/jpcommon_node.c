@@ -67,34 +67,52 @@ void JPCommonNode_initialize(JPCommonNode * node)
    node->chain_flag = -1;
    node->prev = NULL;
    node->next = NULL;
+   node->arena = NULL;
+}
+
+JPCommonNode *JPCommonNode_new(OJTArena * arena)
+{
+   JPCommonNode *node = (JPCommonNode *) OJTArena_calloc(arena, 1, sizeof(JPCommonNode));
+
+   JPCommonNode_initialize(node);
+   node->arena = arena;
+   return node;
+}
+
+void JPCommonNode_delete(JPCommonNode * node)
+{
+   OJTArena *arena = node->arena;
+
+   JPCommonNode_clear(node);
+   OJTArena_free(arena, node);
 }
 
 void JPCommonNode_set_pron(JPCommonNode * node, const char *str)
 {
    if (node->pron != NULL)
-      free(node->pron);
-   node->pron = strdup(str);
+      OJTArena_free(node->arena, node->pron);
+   node->pron = OJTArena_strdup(node->arena, str);
 }
 
 void JPCommonNode_set_pos(JPCommonNode * node, const char *str)
 {
    if (node->pos != NULL)
-      free(node->pos);
-   node->pos = strdup(str);
+      OJTArena_free(node->arena, node->pos);
+   node->pos = OJTArena_strdup(node->arena, str);
 }
 
 void JPCommonNode_set_ctype(JPCommonNode * node, const char *str)
 {
    if (node->ctype != NULL)
-      free(node->ctype);
-   node->ctype = strdup(str);
+      OJTArena_free(node->arena, node->ctype);
+   node->ctype = OJTArena_strdup(node->arena, str);
 }
 
 void JPCommonNode_set_cform(JPCommonNode * node, const char *str)
 {
    if (node->cform != NULL)
-      free(node->cform);
-   node->cform = strdup(str);
+      OJTArena_free(node->arena, node->cform);
+   node->cform = OJTArena_strdup(node->arena, str);
 }
 
 void JPCommonNode_set_acc(JPCommonNode * node, int acc)
@@ -161,19 +179,19 @@ void JPCommonNode_fprint(JPCommonNode * node, FILE * fp)
 void JPCommonNode_clear(JPCommonNode * node)
 {
    if (node->pron != NULL) {
-      free(node->pron);
+      OJTArena_free(node->arena, node->pron);
       node->pron = NULL;
    }
    if (node->pos != NULL) {
-      free(node->pos);
+      OJTArena_free(node->arena, node->pos);
       node->pos = NULL;
    }
    if (node->ctype != NULL) {
-      free(node->ctype);
+      OJTArena_free(node->arena, node->ctype);
       node->ctype = NULL;
    }
    if (node->cform != NULL) {
-      free(node->cform);
+      OJTArena_free(node->arena, node->cform);
       node->cform = NULL;
    }
    node->acc = 0;
@@ -63,13 +63,21 @@ void mecab2njd(NJD * njd, char **feature, int size)
    NJDNode *node;
 
    for (i = 0; i < size; i++) {
-      node = (NJDNode *) calloc(1, sizeof(NJDNode));
-      NJDNode_initialize(node);
+      node = NJDNode_new(njd->arena);
       NJDNode_load(node, feature[i]);
       NJD_push_node(njd, node);
    }
 }
 
+/* push one token without building a "surface,feature" string */
+void mecab2njd_push_token(NJD * njd, const char *surface, int length, const char *feature)
+{
+   NJDNode *node = NJDNode_new(njd->arena);
+
+   NJDNode_load_feature(node, surface, length, feature);
+   NJD_push_node(njd, node);
+}
+
 MECAB2NJD_C_END;
 
 #endif                          /* !MECAB2NJD_C */
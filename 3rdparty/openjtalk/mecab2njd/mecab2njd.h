@@ -52,6 +52,7 @@
 MECAB2NJD_H_START;
 
 void mecab2njd(NJD * njd, char **feature, int size);
+void mecab2njd_push_token(NJD * njd, const char *surface, int length, const char *feature);
 
 MECAB2NJD_H_END;
 
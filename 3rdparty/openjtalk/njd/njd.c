@@ -125,6 +125,13 @@ void NJD_initialize(NJD * njd)
 {
    njd->head = NULL;
    njd->tail = NULL;
+   njd->arena = NULL;
+}
+
+void NJD_set_arena(NJD * njd, OJTArena * arena)
+{
+   NJD_clear(njd);
+   njd->arena = arena;
 }
 
 void NJD_load(NJD * njd, const char *str)
@@ -175,8 +182,7 @@ void NJD_load(NJD * njd, const char *str)
       get_token_from_string(str, &i, chain_rule, ',');
       if (get_token_from_string(str, &i, chain_flag, ',') <= 0)
          break;
-      node = (NJDNode *) calloc(1, sizeof(NJDNode));
-      NJDNode_initialize(node);
+      node = NJDNode_new(njd->arena);
       NJDNode_set_string(node, string);
       NJDNode_set_pos(node, pos);
       NJDNode_set_pos_group1(node, pos_group1);
@@ -242,8 +248,7 @@ void NJD_load_from_fp(NJD * njd, FILE * fp)
       get_token_from_fp(fp, chain_rule, ',');
       if (get_token_from_fp(fp, chain_flag, ',') <= 0)
          break;
-      node = (NJDNode *) calloc(1, sizeof(NJDNode));
-      NJDNode_initialize(node);
+      node = NJDNode_new(njd->arena);
       NJDNode_set_string(node, string);
       NJDNode_set_pos(node, pos);
       NJDNode_set_pos_group1(node, pos_group1);
@@ -307,8 +312,7 @@ NJDNode *NJD_remove_node(NJD * njd, NJDNode * node)
       node->next->prev = node->prev;
       next = node->next;
    }
-   NJDNode_clear(node);
-   free(node);
+   NJDNode_delete(node);
    return next;
 }
 
@@ -348,7 +352,8 @@ void NJD_sprint(NJD * njd, char *buff, const char *split_code)
 void NJD_refresh(NJD * njd)
 {
    NJD_clear(njd);
-   NJD_initialize(njd);
+   njd->head = NULL;
+   njd->tail = NULL;
 }
 
 void NJD_clear(NJD * njd)
@@ -357,8 +362,7 @@ void NJD_clear(NJD * njd)
 
    while (njd->head != NULL) {
       node = njd->head->next;
-      NJDNode_clear(njd->head);
-      free(njd->head);
+      NJDNode_delete(njd->head);
       njd->head = node;
    }
    njd->tail = NULL;
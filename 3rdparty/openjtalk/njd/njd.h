@@ -51,6 +51,40 @@
 
 NJD_H_START;
 
+#include "ojt_arena.h"
+
+/* NJDTag: part-of-speech strings referenced by the njd_set_* rules */
+
+typedef enum _NJDTag {
+   NJD_TAG_NONE = 0,            /* empty or not referenced by any rule */
+   NJD_TAG_MEISHI,
+   NJD_TAG_KEIYOUSHI,
+   NJD_TAG_DOUSHI,
+   NJD_TAG_FUKUSHI,
+   NJD_TAG_SETSUZOKUSHI,
+   NJD_TAG_RENTAISHI,
+   NJD_TAG_JODOUSHI,
+   NJD_TAG_JOSHI,
+   NJD_TAG_KANDOUSHI,
+   NJD_TAG_SETTOUSHI,
+   NJD_TAG_KIGOU,
+   NJD_TAG_FILLER,
+   NJD_TAG_KEIYOUDOUSHI_GOKAN,
+   NJD_TAG_FUKUSHI_KANOU,
+   NJD_TAG_SAHEN_SETSUZOKU,
+   NJD_TAG_SETSUBI,
+   NJD_TAG_HIJIRITSU,
+   NJD_TAG_SETSUZOKUJOSHI,
+   NJD_TAG_KAZU,
+   NJD_TAG_SUUSETSUZOKU,
+   NJD_TAG_JOSUUSHI,
+   NJD_TAG_SEI,
+   NJD_TAG_MEI,
+   NJD_TAG_SIZE
+} NJDTag;
+
+NJDTag NJDTag_find(const char *str, int length);
+
 /* NJDNode */
 
 typedef struct _NJDNode {
@@ -59,6 +93,10 @@ typedef struct _NJDNode {
    char *pos_group1;
    char *pos_group2;
    char *pos_group3;
+   NJDTag pos_tag;
+   NJDTag pos_group1_tag;
+   NJDTag pos_group2_tag;
+   NJDTag pos_group3_tag;
    char *ctype;                 /* conjugation type */
    char *cform;                 /* conjugation form */
    char *orig;                  /* genkei */
@@ -70,9 +108,12 @@ typedef struct _NJDNode {
    int chain_flag;
    struct _NJDNode *prev;
    struct _NJDNode *next;
+   OJTArena *arena;             /* owner of node and strings (NULL for heap) */
 } NJDNode;
 
 void NJDNode_initialize(NJDNode * node);
+NJDNode *NJDNode_new(OJTArena * arena);
+void NJDNode_delete(NJDNode * node);
 void NJDNode_set_string(NJDNode * node, const char *str);
 void NJDNode_set_pos(NJDNode * node, const char *str);
 void NJDNode_set_pos_group1(NJDNode * node, const char *str);
@@ -98,6 +139,10 @@ const char *NJDNode_get_pos(NJDNode * node);
 const char *NJDNode_get_pos_group1(NJDNode * node);
 const char *NJDNode_get_pos_group2(NJDNode * node);
 const char *NJDNode_get_pos_group3(NJDNode * node);
+NJDTag NJDNode_get_pos_tag(NJDNode * node);
+NJDTag NJDNode_get_pos_group1_tag(NJDNode * node);
+NJDTag NJDNode_get_pos_group2_tag(NJDNode * node);
+NJDTag NJDNode_get_pos_group3_tag(NJDNode * node);
 const char *NJDNode_get_ctype(NJDNode * node);
 const char *NJDNode_get_cform(NJDNode * node);
 const char *NJDNode_get_orig(NJDNode * node);
@@ -108,6 +153,8 @@ int NJDNode_get_mora_size(NJDNode * node);
 const char *NJDNode_get_chain_rule(NJDNode * node);
 int NJDNode_get_chain_flag(NJDNode * node);
 void NJDNode_load(NJDNode * node, const char *str);
+void NJDNode_load_feature(NJDNode * node, const char *string, int string_length,
+                          const char *feature);
 NJDNode *NJDNode_insert(NJDNode * prev, NJDNode * next, NJDNode * node);
 void NJDNode_copy(NJDNode * node1, NJDNode * node2);
 void NJDNode_print(NJDNode * node);
@@ -120,9 +167,11 @@ void NJDNode_clear(NJDNode * node);
 typedef struct _NJD {
    NJDNode *head;
    NJDNode *tail;
+   OJTArena *arena;             /* allocator for new nodes (NULL for heap) */
 } NJD;
 
 void NJD_initialize(NJD * njd);
+void NJD_set_arena(NJD * njd, OJTArena * arena);
 void NJD_load(NJD * njd, const char *str);
 void NJD_load_from_fp(NJD * njd, FILE * fp);
 int NJD_get_size(NJD * njd);
@@ -57,6 +57,28 @@ NJD_NODE_C_START;
 
 #include "njd.h"
 
+#ifdef ASCII_HEADER
+#if defined(CHARSET_EUC_JP)
+#include "njd_rule_ascii_for_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "njd_rule_ascii_for_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "njd_rule_ascii_for_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#else
+#if defined(CHARSET_EUC_JP)
+#include "njd_rule_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "njd_rule_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "njd_rule_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#endif
+
 static const char *nodata = "*";
 
 #define MAXBUFLEN 1024
@@ -78,6 +100,30 @@ static void get_token_from_string(const char *str, int *index, char *buff, char
    buff[i] = '\0';
 }
 
+NJDTag NJDTag_find(const char *str, int length)
+{
+   int left = 0;
+   int right = sizeof(njd_tag_list) / sizeof(njd_tag_list[0]) - 1;
+   int middle;
+   int cmp;
+
+   if (str == NULL || length <= 0)
+      return NJD_TAG_NONE;
+   while (left <= right) {
+      middle = (left + right) / 2;
+      cmp = strncmp(njd_tag_list[middle].str, str, length);
+      if (cmp == 0 && njd_tag_list[middle].str[length] != '\0')
+         cmp = 1;
+      if (cmp == 0)
+         return njd_tag_list[middle].tag;
+      if (cmp < 0)
+         left = middle + 1;
+      else
+         right = middle - 1;
+   }
+   return NJD_TAG_NONE;
+}
+
 void NJDNode_initialize(NJDNode * node)
 {
    node->string = NULL;
@@ -85,6 +131,10 @@ void NJDNode_initialize(NJDNode * node)
    node->pos_group1 = NULL;
    node->pos_group2 = NULL;
    node->pos_group3 = NULL;
+   node->pos_tag = NJD_TAG_NONE;
+   node->pos_group1_tag = NJD_TAG_NONE;
+   node->pos_group2_tag = NJD_TAG_NONE;
+   node->pos_group3_tag = NJD_TAG_NONE;
    node->ctype = NULL;
    node->cform = NULL;
    node->orig = NULL;
@@ -96,106 +146,136 @@ void NJDNode_initialize(NJDNode * node)
    node->chain_flag = -1;
    node->prev = NULL;
    node->next = NULL;
+   node->arena = NULL;
+}
+
+NJDNode *NJDNode_new(OJTArena * arena)
+{
+   NJDNode *node = (NJDNode *) OJTArena_calloc(arena, 1, sizeof(NJDNode));
+
+   NJDNode_initialize(node);
+   node->arena = arena;
+   return node;
+}
+
+void NJDNode_delete(NJDNode * node)
+{
+   OJTArena *arena = node->arena;
+
+   NJDNode_clear(node);
+   OJTArena_free(arena, node);
 }
 
 void NJDNode_set_string(NJDNode * node, const char *str)
 {
    if (node->string != NULL)
-      free(node->string);
+      OJTArena_free(node->arena, node->string);
    if (str == NULL || strlen(str) == 0)
       node->string = NULL;
    else
-      node->string = strdup(str);
+      node->string = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_pos(NJDNode * node, const char *str)
 {
    if (node->pos != NULL)
-      free(node->pos);
-   if (str == NULL || strlen(str) == 0)
+      OJTArena_free(node->arena, node->pos);
+   if (str == NULL || strlen(str) == 0) {
       node->pos = NULL;
-   else
-      node->pos = strdup(str);
+      node->pos_tag = NJD_TAG_NONE;
+   } else {
+      node->pos = OJTArena_strdup(node->arena, str);
+      node->pos_tag = NJDTag_find(str, strlen(str));
+   }
 }
 
 void NJDNode_set_pos_group1(NJDNode * node, const char *str)
 {
    if (node->pos_group1 != NULL)
-      free(node->pos_group1);
-   if (str == NULL || strlen(str) == 0)
+      OJTArena_free(node->arena, node->pos_group1);
+   if (str == NULL || strlen(str) == 0) {
       node->pos_group1 = NULL;
-   else
-      node->pos_group1 = strdup(str);
+      node->pos_group1_tag = NJD_TAG_NONE;
+   } else {
+      node->pos_group1 = OJTArena_strdup(node->arena, str);
+      node->pos_group1_tag = NJDTag_find(str, strlen(str));
+   }
 }
 
 void NJDNode_set_pos_group2(NJDNode * node, const char *str)
 {
    if (node->pos_group2 != NULL)
-      free(node->pos_group2);
-   if (str == NULL || strlen(str) == 0)
+      OJTArena_free(node->arena, node->pos_group2);
+   if (str == NULL || strlen(str) == 0) {
       node->pos_group2 = NULL;
-   else
-      node->pos_group2 = strdup(str);
+      node->pos_group2_tag = NJD_TAG_NONE;
+   } else {
+      node->pos_group2 = OJTArena_strdup(node->arena, str);
+      node->pos_group2_tag = NJDTag_find(str, strlen(str));
+   }
 }
 
 void NJDNode_set_pos_group3(NJDNode * node, const char *str)
 {
    if (node->pos_group3 != NULL)
-      free(node->pos_group3);
-   if (str == NULL || strlen(str) == 0)
+      OJTArena_free(node->arena, node->pos_group3);
+   if (str == NULL || strlen(str) == 0) {
       node->pos_group3 = NULL;
-   else
-      node->pos_group3 = strdup(str);
+      node->pos_group3_tag = NJD_TAG_NONE;
+   } else {
+      node->pos_group3 = OJTArena_strdup(node->arena, str);
+      node->pos_group3_tag = NJDTag_find(str, strlen(str));
+   }
 }
 
 void NJDNode_set_ctype(NJDNode * node, const char *str)
 {
    if (node->ctype != NULL)
-      free(node->ctype);
+      OJTArena_free(node->arena, node->ctype);
    if (str == NULL || strlen(str) == 0)
       node->ctype = NULL;
    else
-      node->ctype = strdup(str);
+      node->ctype = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_cform(NJDNode * node, const char *str)
 {
    if (node->cform != NULL)
-      free(node->cform);
+      OJTArena_free(node->arena, node->cform);
    if (str == NULL || strlen(str) == 0)
       node->cform = NULL;
    else
-      node->cform = strdup(str);
+      node->cform = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_orig(NJDNode * node, const char *str)
 {
    if (node->orig != NULL)
-      free(node->orig);
+      OJTArena_free(node->arena, node->orig);
    if (str == NULL || strlen(str) == 0)
       node->orig = NULL;
    else
-      node->orig = strdup(str);
+      node->orig = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_read(NJDNode * node, const char *str)
 {
    if (node->read != NULL)
-      free(node->read);
+      OJTArena_free(node->arena, node->read);
    if (str == NULL || strlen(str) == 0)
       node->read = NULL;
    else
-      node->read = strdup(str);
+      node->read = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_pron(NJDNode * node, const char *str)
 {
    if (node->pron != NULL)
-      free(node->pron);
+      OJTArena_free(node->arena, node->pron);
    if (str == NULL || strlen(str) == 0)
       node->pron = NULL;
    else
-      node->pron = strdup(str);
+      node->pron = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_acc(NJDNode * node, int acc)
@@ -220,11 +300,11 @@ void NJDNode_set_mora_size(NJDNode * node, int size)
 void NJDNode_set_chain_rule(NJDNode * node, const char *str)
 {
    if (node->chain_rule != NULL)
-      free(node->chain_rule);
+      OJTArena_free(node->arena, node->chain_rule);
    if (str == NULL || strlen(str) == 0)
       node->chain_rule = NULL;
    else
-      node->chain_rule = strdup(str);
+      node->chain_rule = OJTArena_strdup(node->arena, str);
 }
 
 void NJDNode_set_chain_flag(NJDNode * node, int flag)
@@ -238,12 +318,13 @@ void NJDNode_add_string(NJDNode * node, const char *str)
 
    if (str != NULL) {
       if (node->string == NULL) {
-         node->string = strdup(str);
+         node->string = OJTArena_strdup(node->arena, str);
       } else {
-         c = (char *) calloc(strlen(node->string) + strlen(str) + 1, sizeof(char));
+         c = (char *) OJTArena_calloc(node->arena, strlen(node->string) + strlen(str) + 1,
+                                      sizeof(char));
          strcpy(c, node->string);
          strcat(c, str);
-         free(node->string);
+         OJTArena_free(node->arena, node->string);
          node->string = c;
       }
    }
@@ -255,12 +336,13 @@ void NJDNode_add_orig(NJDNode * node, const char *str)
 
    if (str != NULL) {
       if (node->orig == NULL) {
-         node->orig = strdup(str);
+         node->orig = OJTArena_strdup(node->arena, str);
       } else {
-         c = (char *) calloc(strlen(node->orig) + strlen(str) + 1, sizeof(char));
+         c = (char *) OJTArena_calloc(node->arena, strlen(node->orig) + strlen(str) + 1,
+                                      sizeof(char));
          strcpy(c, node->orig);
          strcat(c, str);
-         free(node->orig);
+         OJTArena_free(node->arena, node->orig);
          node->orig = c;
       }
    }
@@ -272,12 +354,13 @@ void NJDNode_add_read(NJDNode * node, const char *str)
 
    if (str != NULL) {
       if (node->read == NULL) {
-         node->read = strdup(str);
+         node->read = OJTArena_strdup(node->arena, str);
       } else {
-         c = (char *) calloc(strlen(node->read) + strlen(str) + 1, sizeof(char));
+         c = (char *) OJTArena_calloc(node->arena, strlen(node->read) + strlen(str) + 1,
+                                      sizeof(char));
          strcpy(c, node->read);
          strcat(c, str);
-         free(node->read);
+         OJTArena_free(node->arena, node->read);
          node->read = c;
       }
    }
@@ -289,12 +372,13 @@ void NJDNode_add_pron(NJDNode * node, const char *str)
 
    if (str != NULL) {
       if (node->pron == NULL) {
-         node->pron = strdup(str);
+         node->pron = OJTArena_strdup(node->arena, str);
       } else {
-         c = (char *) calloc(strlen(node->pron) + strlen(str) + 1, sizeof(char));
+         c = (char *) OJTArena_calloc(node->arena, strlen(node->pron) + strlen(str) + 1,
+                                      sizeof(char));
          strcpy(c, node->pron);
          strcat(c, str);
-         free(node->pron);
+         OJTArena_free(node->arena, node->pron);
          node->pron = c;
       }
    }
@@ -354,6 +438,26 @@ const char *NJDNode_get_pos_group3(NJDNode * node)
    return node->pos_group3;
 }
 
+NJDTag NJDNode_get_pos_tag(NJDNode * node)
+{
+   return node->pos_tag;
+}
+
+NJDTag NJDNode_get_pos_group1_tag(NJDNode * node)
+{
+   return node->pos_group1_tag;
+}
+
+NJDTag NJDNode_get_pos_group2_tag(NJDNode * node)
+{
+   return node->pos_group2_tag;
+}
+
+NJDTag NJDNode_get_pos_group3_tag(NJDNode * node)
+{
+   return node->pos_group3_tag;
+}
+
 const char *NJDNode_get_ctype(NJDNode * node)
 {
    if (node->ctype == NULL)
@@ -411,10 +515,59 @@ int NJDNode_get_chain_flag(NJDNode * node)
    return node->chain_flag;
 }
 
+static const char *get_field_from_string(const char *str, int *index, int *length, char d)
+{
+   const char *start = &str[*index];
+
+   *length = 0;
+   while (str[*index] != d && str[*index] != '\0') {
+      (*index)++;
+      (*length)++;
+   }
+   if (str[*index] == d)
+      (*index)++;
+   return start;
+}
+
+static void copy_field(char *buff, const char *str, int length)
+{
+   if (length > MAXBUFLEN - 1)
+      length = MAXBUFLEN - 1;
+   memcpy(buff, str, length);
+   buff[length] = '\0';
+}
+
+static void set_field(NJDNode * node, char **field, const char *str, int length)
+{
+   if (*field != NULL)
+      OJTArena_free(node->arena, *field);
+   if (length == 0) {
+      *field = NULL;
+   } else {
+      *field = (char *) OJTArena_calloc(node->arena, length + 1, sizeof(char));
+      memcpy(*field, str, length);
+   }
+}
+
 void NJDNode_load(NJDNode * node, const char *str)
+{
+   int index = 0;
+   int length;
+   const char *string = get_field_from_string(str, &index, &length, ',');
+
+   NJDNode_load_feature(node, string, length, &str[index]);
+}
+
+/* load node from surface and dictionary feature without intermediate strings */
+void NJDNode_load_feature(NJDNode * node, const char *string, int string_length,
+                          const char *feature)
 {
    int i, j;
    int index = 0;
+   int length;
+   const char *field;
+   const char *orig, *read, *pron, *acc;
+   int orig_length, read_length, pron_length, acc_length;
    char buff[MAXBUFLEN];
    char buff_string[MAXBUFLEN];
    char buff_orig[MAXBUFLEN];
@@ -430,37 +583,41 @@ void NJDNode_load(NJDNode * node, const char *str)
    NJDNode *prev = NULL;
 
    /* load */
-   get_token_from_string(str, &index, buff_string, ',');
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_pos(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_pos_group1(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_pos_group2(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_pos_group3(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_ctype(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_cform(node, buff);
-   get_token_from_string(str, &index, buff_orig, ',');
-   get_token_from_string(str, &index, buff_read, ',');
-   get_token_from_string(str, &index, buff_pron, ',');
-   get_token_from_string(str, &index, buff_acc, ',');
-   get_token_from_string(str, &index, buff, ',');
-   NJDNode_set_chain_rule(node, buff);
-   get_token_from_string(str, &index, buff, ',');
-   if (strcmp(buff, "1") == 0)
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->pos, field, length);
+   node->pos_tag = NJDTag_find(field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->pos_group1, field, length);
+   node->pos_group1_tag = NJDTag_find(field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->pos_group2, field, length);
+   node->pos_group2_tag = NJDTag_find(field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->pos_group3, field, length);
+   node->pos_group3_tag = NJDTag_find(field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->ctype, field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->cform, field, length);
+   orig = get_field_from_string(feature, &index, &orig_length, ',');
+   read = get_field_from_string(feature, &index, &read_length, ',');
+   pron = get_field_from_string(feature, &index, &pron_length, ',');
+   acc = get_field_from_string(feature, &index, &acc_length, ',');
+   field = get_field_from_string(feature, &index, &length, ',');
+   set_field(node, &node->chain_rule, field, length);
+   field = get_field_from_string(feature, &index, &length, ',');
+   if (length == 1 && field[0] == '1')
       NJDNode_set_chain_flag(node, 1);
-   else if (strcmp(buff, "0") == 0)
+   else if (length == 1 && field[0] == '0')
       NJDNode_set_chain_flag(node, 0);
 
    /* for symbol */
+   copy_field(buff_acc, acc, acc_length);
    if (strstr(buff_acc, "*") != NULL || strstr(buff_acc, "/") == NULL) {
-      NJDNode_set_string(node, buff_string);
-      NJDNode_set_orig(node, buff_orig);
-      NJDNode_set_read(node, buff_read);
-      NJDNode_set_pron(node, buff_pron);
+      set_field(node, &node->string, string, string_length);
+      set_field(node, &node->orig, orig, orig_length);
+      set_field(node, &node->read, read, read_length);
+      set_field(node, &node->pron, pron, pron_length);
       NJDNode_set_acc(node, 0);
       NJDNode_set_mora_size(node, 0);
       return;
@@ -473,10 +630,10 @@ void NJDNode_load(NJDNode * node, const char *str)
 
    /* for single word */
    if (count == 1) {
-      NJDNode_set_string(node, buff_string);
-      NJDNode_set_orig(node, buff_orig);
-      NJDNode_set_read(node, buff_read);
-      NJDNode_set_pron(node, buff_pron);
+      set_field(node, &node->string, string, string_length);
+      set_field(node, &node->orig, orig, orig_length);
+      set_field(node, &node->read, read, read_length);
+      set_field(node, &node->pron, pron, pron_length);
       index_acc = 0;
       get_token_from_string(buff_acc, &index_acc, buff, '/');
       if (buff[0] == '\0') {
@@ -498,6 +655,10 @@ void NJDNode_load(NJDNode * node, const char *str)
    }
 
    /* parse chained word */
+   copy_field(buff_string, string, string_length);
+   copy_field(buff_orig, orig, orig_length);
+   copy_field(buff_read, read, read_length);
+   copy_field(buff_pron, pron, pron_length);
    index_string = 0;
    index_orig = 0;
    index_read = 0;
@@ -505,8 +666,7 @@ void NJDNode_load(NJDNode * node, const char *str)
    index_acc = 0;
    for (i = 0; i < count; i++) {
       if (i > 0) {
-         node = (NJDNode *) calloc(1, sizeof(NJDNode));
-         NJDNode_initialize(node);
+         node = NJDNode_new(prev->arena);
          NJDNode_copy(node, prev);
          NJDNode_set_chain_flag(node, 0);
          node->prev = prev;
@@ -613,49 +773,53 @@ void NJDNode_sprint(NJDNode * node, char *buff, const char *split_code)
 void NJDNode_clear(NJDNode * node)
 {
    if (node->string != NULL) {
-      free(node->string);
+      OJTArena_free(node->arena, node->string);
       node->string = NULL;
    }
    if (node->pos != NULL) {
-      free(node->pos);
+      OJTArena_free(node->arena, node->pos);
       node->pos = NULL;
    }
+   node->pos_tag = NJD_TAG_NONE;
    if (node->pos_group1 != NULL) {
-      free(node->pos_group1);
+      OJTArena_free(node->arena, node->pos_group1);
       node->pos_group1 = NULL;
    }
+   node->pos_group1_tag = NJD_TAG_NONE;
    if (node->pos_group2 != NULL) {
-      free(node->pos_group2);
+      OJTArena_free(node->arena, node->pos_group2);
       node->pos_group2 = NULL;
    }
+   node->pos_group2_tag = NJD_TAG_NONE;
    if (node->pos_group3 != NULL) {
-      free(node->pos_group3);
+      OJTArena_free(node->arena, node->pos_group3);
       node->pos_group3 = NULL;
    }
+   node->pos_group3_tag = NJD_TAG_NONE;
    if (node->ctype != NULL) {
-      free(node->ctype);
+      OJTArena_free(node->arena, node->ctype);
       node->ctype = NULL;
    }
    if (node->cform != NULL) {
-      free(node->cform);
+      OJTArena_free(node->arena, node->cform);
       node->cform = NULL;
    }
    if (node->orig != NULL) {
-      free(node->orig);
+      OJTArena_free(node->arena, node->orig);
       node->orig = NULL;
    }
    if (node->read != NULL) {
-      free(node->read);
+      OJTArena_free(node->arena, node->read);
       node->read = NULL;
    }
    if (node->pron != NULL) {
-      free(node->pron);
+      OJTArena_free(node->arena, node->pron);
       node->pron = NULL;
    }
    node->acc = 0;
    node->mora_size = 0;
    if (node->chain_rule != NULL) {
-      free(node->chain_rule);
+      OJTArena_free(node->arena, node->chain_rule);
       node->chain_rule = NULL;
    }
    node->chain_flag = -1;
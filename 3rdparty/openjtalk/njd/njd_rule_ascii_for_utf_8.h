@@ -0,0 +1,86 @@
+/* ----------------------------------------------------------------- */
+/*           The Japanese TTS System "Open JTalk"                    */
+/*           developed by HTS Working Group                          */
+/*           http://open-jtalk.sourceforge.net/                      */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2008-2016  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the HTS working group nor the names of its  */
+/*   contributors may be used to endorse or promote products derived */
+/*   from this software without specific prior written permission.   */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+/* ----------------------------------------------------------------- */
+
+#ifndef NJD_RULE_H
+#define NJD_RULE_H
+
+#ifdef __cplusplus
+#define NJD_RULE_H_START extern "C" {
+#define NJD_RULE_H_END   }
+#else
+#define NJD_RULE_H_START
+#define NJD_RULE_H_END
+#endif                          /* __CPLUSPLUS */
+
+NJD_RULE_H_START;
+
+/* part-of-speech strings interned as NJDTag (sorted by byte value for binary search) */
+static const struct {
+   const char *str;
+   NJDTag tag;
+} njd_tag_list[] = {
+   {"\xe3\x82\xb5\xe5\xa4\x89\xe6\x8e\xa5\xe7\xb6\x9a", NJD_TAG_SAHEN_SETSUZOKU},
+   {"\xe3\x83\x95\xe3\x82\xa3\xe3\x83\xa9\xe3\x83\xbc", NJD_TAG_FILLER},
+   {"\xe5\x89\xaf\xe8\xa9\x9e", NJD_TAG_FUKUSHI},
+   {"\xe5\x89\xaf\xe8\xa9\x9e\xe5\x8f\xaf\xe8\x83\xbd", NJD_TAG_FUKUSHI_KANOU},
+   {"\xe5\x8a\xa9\xe5\x8b\x95\xe8\xa9\x9e", NJD_TAG_JODOUSHI},
+   {"\xe5\x8a\xa9\xe6\x95\xb0\xe8\xa9\x9e", NJD_TAG_JOSUUSHI},
+   {"\xe5\x8a\xa9\xe8\xa9\x9e", NJD_TAG_JOSHI},
+   {"\xe5\x8b\x95\xe8\xa9\x9e", NJD_TAG_DOUSHI},
+   {"\xe5\x90\x8d", NJD_TAG_MEI},
+   {"\xe5\x90\x8d\xe8\xa9\x9e", NJD_TAG_MEISHI},
+   {"\xe5\xa7\x93", NJD_TAG_SEI},
+   {"\xe5\xbd\xa2\xe5\xae\xb9\xe5\x8b\x95\xe8\xa9\x9e\xe8\xaa\x9e\xe5\xb9\xb9", NJD_TAG_KEIYOUDOUSHI_GOKAN},
+   {"\xe5\xbd\xa2\xe5\xae\xb9\xe8\xa9\x9e", NJD_TAG_KEIYOUSHI},
+   {"\xe6\x84\x9f\xe5\x8b\x95\xe8\xa9\x9e", NJD_TAG_KANDOUSHI},
+   {"\xe6\x8e\xa5\xe5\xb0\xbe", NJD_TAG_SETSUBI},
+   {"\xe6\x8e\xa5\xe7\xb6\x9a\xe5\x8a\xa9\xe8\xa9\x9e", NJD_TAG_SETSUZOKUJOSHI},
+   {"\xe6\x8e\xa5\xe7\xb6\x9a\xe8\xa9\x9e", NJD_TAG_SETSUZOKUSHI},
+   {"\xe6\x8e\xa5\xe9\xa0\xad\xe8\xa9\x9e", NJD_TAG_SETTOUSHI},
+   {"\xe6\x95\xb0", NJD_TAG_KAZU},
+   {"\xe6\x95\xb0\xe6\x8e\xa5\xe7\xb6\x9a", NJD_TAG_SUUSETSUZOKU},
+   {"\xe8\xa8\x98\xe5\x8f\xb7", NJD_TAG_KIGOU},
+   {"\xe9\x80\xa3\xe4\xbd\x93\xe8\xa9\x9e", NJD_TAG_RENTAISHI},
+   {"\xe9\x9d\x9e\xe8\x87\xaa\xe7\xab\x8b", NJD_TAG_HIJIRITSU}
+};
+
+NJD_RULE_H_END;
+
+#endif                          /* !NJD_RULE_H */
@@ -0,0 +1,86 @@
+/* ----------------------------------------------------------------- */
+/*           The Japanese TTS System "Open JTalk"                    */
+/*           developed by HTS Working Group                          */
+/*           http://open-jtalk.sourceforge.net/                      */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2008-2016  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the HTS working group nor the names of its  */
+/*   contributors may be used to endorse or promote products derived */
+/*   from this software without specific prior written permission.   */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+/* ----------------------------------------------------------------- */
+
+#ifndef NJD_RULE_H
+#define NJD_RULE_H
+
+#ifdef __cplusplus
+#define NJD_RULE_H_START extern "C" {
+#define NJD_RULE_H_END   }
+#else
+#define NJD_RULE_H_START
+#define NJD_RULE_H_END
+#endif                          /* __CPLUSPLUS */
+
+NJD_RULE_H_START;
+
+/* part-of-speech strings interned as NJDTag (sorted by byte value for binary search) */
+static const struct {
+   const char *str;
+   NJDTag tag;
+} njd_tag_list[] = {
+   {"サ変接続", NJD_TAG_SAHEN_SETSUZOKU},
+   {"フィラー", NJD_TAG_FILLER},
+   {"副詞", NJD_TAG_FUKUSHI},
+   {"副詞可能", NJD_TAG_FUKUSHI_KANOU},
+   {"助動詞", NJD_TAG_JODOUSHI},
+   {"助数詞", NJD_TAG_JOSUUSHI},
+   {"助詞", NJD_TAG_JOSHI},
+   {"動詞", NJD_TAG_DOUSHI},
+   {"名", NJD_TAG_MEI},
+   {"名詞", NJD_TAG_MEISHI},
+   {"姓", NJD_TAG_SEI},
+   {"形容動詞語幹", NJD_TAG_KEIYOUDOUSHI_GOKAN},
+   {"形容詞", NJD_TAG_KEIYOUSHI},
+   {"感動詞", NJD_TAG_KANDOUSHI},
+   {"接尾", NJD_TAG_SETSUBI},
+   {"接続助詞", NJD_TAG_SETSUZOKUJOSHI},
+   {"接続詞", NJD_TAG_SETSUZOKUSHI},
+   {"接頭詞", NJD_TAG_SETTOUSHI},
+   {"数", NJD_TAG_KAZU},
+   {"数接続", NJD_TAG_SUUSETSUZOKU},
+   {"記号", NJD_TAG_KIGOU},
+   {"連体詞", NJD_TAG_RENTAISHI},
+   {"非自立", NJD_TAG_HIJIRITSU}
+};
+
+NJD_RULE_H_END;
+
+#endif                          /* !NJD_RULE_H */
@@ -141,8 +141,7 @@ void njd2jpcommon(JPCommon * jpcommon, NJD * njd)
    JPCommonNode *jnode;
 
    for (inode = njd->head; inode != NULL; inode = inode->next) {
-      jnode = (JPCommonNode *) calloc(1, sizeof(JPCommonNode));
-      JPCommonNode_initialize(jnode);
+      jnode = JPCommonNode_new(jpcommon->arena);
       JPCommonNode_set_pron(jnode, NJDNode_get_pron(inode));
       convert_pos(buff, NJDNode_get_pos(inode), NJDNode_get_pos_group1(inode),
                   NJDNode_get_pos_group2(inode), NJDNode_get_pos_group3(inode));
@@ -106,83 +106,78 @@ void njd_set_accent_phrase(NJD * njd)
          NJDNode_set_chain_flag(node, 1);
 
          /* Rule 02 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI)
+            if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
                NJDNode_set_chain_flag(node, 1);
 
          /* Rule 03 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_KEIYOUSHI) == 0)
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_KEIYOUSHI)
+            if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
                NJDNode_set_chain_flag(node, 0);
 
          /* Rule 04 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
-            if (strcmp
-                (NJDNode_get_pos_group1(node->prev), NJD_SET_ACCENT_PHRASE_KEIYOUDOUSHI_GOKAN) == 0)
-               if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI)
+            if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_KEIYOUDOUSHI_GOKAN)
+               if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
                   NJDNode_set_chain_flag(node, 0);
 
          /* Rule 05 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_DOUSHI) == 0) {
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_KEIYOUSHI) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_DOUSHI) {
+            if (NJDNode_get_pos_tag(node) == NJD_TAG_KEIYOUSHI)
                NJDNode_set_chain_flag(node, 0);
-            else if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+            else if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
                NJDNode_set_chain_flag(node, 0);
          }
 
          /* Rule 06 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_FUKUSHI) == 0
-             || strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_FUKUSHI) == 0
-             || strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_SETSUZOKUSHI) == 0
-             || strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_SETSUZOKUSHI) == 0
-             || strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_RENTAISHI) == 0
-             || strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_RENTAISHI) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_FUKUSHI
+             || NJDNode_get_pos_tag(node->prev) == NJD_TAG_FUKUSHI
+             || NJDNode_get_pos_tag(node) == NJD_TAG_SETSUZOKUSHI
+             || NJDNode_get_pos_tag(node->prev) == NJD_TAG_SETSUZOKUSHI
+             || NJDNode_get_pos_tag(node) == NJD_TAG_RENTAISHI
+             || NJDNode_get_pos_tag(node->prev) == NJD_TAG_RENTAISHI)
             NJDNode_set_chain_flag(node, 0);
 
          /* Rule 07 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
-            if (strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_ACCENT_PHRASE_FUKUSHI_KANOU)
-                == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI)
+            if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_FUKUSHI_KANOU)
                NJDNode_set_chain_flag(node, 0);
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
-            if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_PHRASE_FUKUSHI_KANOU) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
+            if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_FUKUSHI_KANOU)
                NJDNode_set_chain_flag(node, 0);
 
          /* Rule 08 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JODOUSHI) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_JODOUSHI)
             NJDNode_set_chain_flag(node, 1);
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JOSHI) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_JOSHI)
             NJDNode_set_chain_flag(node, 1);
 
          /* Rule 09 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_JODOUSHI) == 0)
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JODOUSHI) != 0 &&
-                strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JOSHI) != 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_JODOUSHI)
+            if (NJDNode_get_pos_tag(node) != NJD_TAG_JODOUSHI &&
+                NJDNode_get_pos_tag(node) != NJD_TAG_JOSHI)
                NJDNode_set_chain_flag(node, 0);
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_JOSHI) == 0)
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JODOUSHI) != 0 &&
-                strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_JOSHI) != 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_JOSHI)
+            if (NJDNode_get_pos_tag(node) != NJD_TAG_JODOUSHI &&
+                NJDNode_get_pos_tag(node) != NJD_TAG_JOSHI)
                NJDNode_set_chain_flag(node, 0);
 
          /* Rule 10 */
-         if (strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_ACCENT_PHRASE_SETSUBI) == 0)
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+         if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_SETSUBI)
+            if (NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
                NJDNode_set_chain_flag(node, 0);
 
          /* Rule 11 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_KEIYOUSHI) == 0)
-            if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_PHRASE_HIJIRITSU) == 0) {
-               if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_DOUSHI) == 0) {
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_KEIYOUSHI)
+            if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_HIJIRITSU) {
+               if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_DOUSHI) {
                   if (strtopcmp(NJDNode_get_cform(node->prev), NJD_SET_ACCENT_PHRASE_RENYOU) != -1)
                      NJDNode_set_chain_flag(node, 1);
-               } else if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_KEIYOUSHI)
-                          == 0) {
+               } else if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_KEIYOUSHI) {
                   if (strtopcmp(NJDNode_get_cform(node->prev), NJD_SET_ACCENT_PHRASE_RENYOU) != -1)
                      NJDNode_set_chain_flag(node, 1);
-               } else if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_JOSHI) == 0) {
-                  if (strcmp
-                      (NJDNode_get_pos_group1(node->prev),
-                       NJD_SET_ACCENT_PHRASE_SETSUZOKUJOSHI) == 0) {
+               } else if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_JOSHI) {
+                  if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_SETSUZOKUJOSHI) {
                      if (strcmp(NJDNode_get_string(node->prev), NJD_SET_ACCENT_PHRASE_TE) == 0)
                         NJDNode_set_chain_flag(node, 1);
                      else if (strcmp(NJDNode_get_string(node->prev), NJD_SET_ACCENT_PHRASE_DE) == 0)
@@ -192,48 +187,46 @@ void njd_set_accent_phrase(NJD * njd)
             }
 
          /* Rule 12 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_DOUSHI) == 0)
-            if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_PHRASE_HIJIRITSU) == 0) {
-               if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_DOUSHI) == 0) {
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_DOUSHI)
+            if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_HIJIRITSU) {
+               if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_DOUSHI) {
                   if (strtopcmp(NJDNode_get_cform(node->prev), NJD_SET_ACCENT_PHRASE_RENYOU) != -1)
                      NJDNode_set_chain_flag(node, 1);
-               } else if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0) {
-                  if (strcmp
-                      (NJDNode_get_pos_group1(node->prev),
-                       NJD_SET_ACCENT_PHRASE_SAHEN_SETSUZOKU) == 0)
+               } else if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI) {
+                  if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_SAHEN_SETSUZOKU)
                      NJDNode_set_chain_flag(node, 1);
                }
             }
 
          /* Rule 13 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0) {
-            if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_DOUSHI) == 0 ||
-                strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_KEIYOUSHI) == 0 ||
-                strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_PHRASE_KEIYOUDOUSHI_GOKAN) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI) {
+            if (NJDNode_get_pos_tag(node) == NJD_TAG_DOUSHI ||
+                NJDNode_get_pos_tag(node) == NJD_TAG_KEIYOUSHI ||
+                NJDNode_get_pos_group1_tag(node) == NJD_TAG_KEIYOUDOUSHI_GOKAN)
                NJDNode_set_chain_flag(node, 0);
          }
 
          /* Rule 14 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_KIGOU) == 0 ||
-             strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_KIGOU) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_KIGOU ||
+             NJDNode_get_pos_tag(node->prev) == NJD_TAG_KIGOU)
             NJDNode_set_chain_flag(node, 0);
 
          /* Rule 15 */
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_SETTOUSHI) == 0)
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_SETTOUSHI)
             NJDNode_set_chain_flag(node, 0);
 
          /* Rule 16 */
-         if (strcmp(NJDNode_get_pos_group3(node->prev), NJD_SET_ACCENT_PHRASE_SEI) == 0
-             && strcmp(NJDNode_get_pos(node), NJD_SET_ACCENT_PHRASE_MEISHI) == 0)
+         if (NJDNode_get_pos_group3_tag(node->prev) == NJD_TAG_SEI
+             && NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
             NJDNode_set_chain_flag(node, 0);
 
          /* Rule 17 */
-         if (strcmp(NJDNode_get_pos(node->prev), NJD_SET_ACCENT_PHRASE_MEISHI) == 0
-             && strcmp(NJDNode_get_pos_group3(node), NJD_SET_ACCENT_PHRASE_MEI) == 0)
+         if (NJDNode_get_pos_tag(node->prev) == NJD_TAG_MEISHI
+             && NJDNode_get_pos_group3_tag(node) == NJD_TAG_MEI)
             NJDNode_set_chain_flag(node, 0);
 
          /* Rule 18 */
-         if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_PHRASE_SETSUBI) == 0)
+         if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_SETSUBI)
             NJDNode_set_chain_flag(node, 1);
       }
    }
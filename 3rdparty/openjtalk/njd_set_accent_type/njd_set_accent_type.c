@@ -199,8 +199,8 @@ void njd_set_accent_type(NJD * njd)
 
       /* change accent type for digit */
       if (node->prev != NULL && NJDNode_get_chain_flag(node) == 1 &&
-          strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_ACCENT_TYPE_KAZU) == 0 &&
-          strcmp(NJDNode_get_pos_group1(node), NJD_SET_ACCENT_TYPE_KAZU) == 0) {
+          NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_KAZU &&
+          NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU) {
          if (strcmp(NJDNode_get_string(node), NJD_SET_ACCENT_TYPE_JYUU) == 0) { /* 10^1 */
             if (NJDNode_get_string(node->prev) != NULL &&
                 (strcmp(NJDNode_get_string(node->prev), NJD_SET_ACCENT_TYPE_SAN) == 0 ||
@@ -270,7 +270,7 @@ void njd_set_accent_type(NJD * njd)
 
       if (strcmp(NJDNode_get_string(node), NJD_SET_ACCENT_TYPE_JYUU) == 0 &&
           NJDNode_get_chain_flag(node) != 1 && node->next != NULL &&
-          strcmp(NJDNode_get_pos_group1(node->next), NJD_SET_ACCENT_TYPE_KAZU) == 0) {
+          NJDNode_get_pos_group1_tag(node->next) == NJD_TAG_KAZU) {
          NJDNode_set_acc(node, 0);
       }
 
@@ -103,7 +103,7 @@ static int get_digit(NJDNode * node, int convert_flag)
    if (strcmp(NJDNode_get_string(node), "*") == 0)
       return -1;
 
-   if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_KAZU) == 0)
+   if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU)
       for (i = 0; njd_set_digit_rule_numeral_list1[i] != NULL; i += 3)
          if (strcmp(njd_set_digit_rule_numeral_list1[i], NJDNode_get_string(node)) == 0) {
             if (convert_flag == 1) {
@@ -137,23 +137,23 @@ static int is_comma(const char *str)
 
 static int get_digit_sequence_score(NJDNode * start, NJDNode * end)
 {
-   const char *buff_pos_group1 = NULL;
-   const char *buff_pos_group2 = NULL;
+   NJDTag buff_pos_group1 = NJD_TAG_NONE;
+   NJDTag buff_pos_group2 = NJD_TAG_NONE;
    const char *buff_string = NULL;
    int score = 0;
 
    if (start->prev) {
-      buff_pos_group1 = NJDNode_get_pos_group1(start->prev);
-      buff_pos_group2 = NJDNode_get_pos_group2(start->prev);
+      buff_pos_group1 = NJDNode_get_pos_group1_tag(start->prev);
+      buff_pos_group2 = NJDNode_get_pos_group2_tag(start->prev);
       buff_string = NJDNode_get_string(start->prev);
-      if (strcmp(buff_pos_group1, NJD_SET_DIGIT_SUUSETSUZOKU) == 0)     /* prev pos_group1 */
+      if (buff_pos_group1 == NJD_TAG_SUUSETSUZOKU)      /* prev pos_group1 */
          score += 2;
-      if (strcmp(buff_pos_group2, NJD_SET_DIGIT_JOSUUSHI) == 0 || strcmp(buff_pos_group1, NJD_SET_DIGIT_FUKUSHIKANOU) == 0)     /* prev pos_group1 and pos_group2 */
+      if (buff_pos_group2 == NJD_TAG_JOSUUSHI || buff_pos_group1 == NJD_TAG_FUKUSHI_KANOU)      /* prev pos_group1 and pos_group2 */
          score += 1;
       if (buff_string != NULL) {
          if (is_period(buff_string) == 1) {
             if (!start->prev->prev
-                || strcmp(NJDNode_get_pos_group1(start->prev->prev), NJD_SET_DIGIT_KAZU) != 0)
+                || NJDNode_get_pos_group1_tag(start->prev->prev) != NJD_TAG_KAZU)
                score += 0;
             else
                score -= 5;
@@ -169,7 +169,7 @@ static int get_digit_sequence_score(NJDNode * start, NJDNode * end)
             score -= 2;
          else if (strcmp(buff_string, NJD_SET_DIGIT_KAKKO1) == 0) {
             if (!start->prev->prev
-                || strcmp(NJDNode_get_pos_group1(start->prev->prev), NJD_SET_DIGIT_KAZU) != 0)
+                || NJDNode_get_pos_group1_tag(start->prev->prev) != NJD_TAG_KAZU)
                score += 0;
             else
                score -= 2;
@@ -185,11 +185,10 @@ static int get_digit_sequence_score(NJDNode * start, NJDNode * end)
       }
    }
    if (end->next) {
-      buff_pos_group1 = NJDNode_get_pos_group1(end->next);
-      buff_pos_group2 = NJDNode_get_pos_group2(end->next);      /* next pos_group2 */
+      buff_pos_group1 = NJDNode_get_pos_group1_tag(end->next);
+      buff_pos_group2 = NJDNode_get_pos_group2_tag(end->next);  /* next pos_group2 */
       buff_string = NJDNode_get_string(end->next);      /* next string */
-      if (strcmp(buff_pos_group2, NJD_SET_DIGIT_JOSUUSHI) == 0
-          || strcmp(buff_pos_group1, NJD_SET_DIGIT_FUKUSHIKANOU) == 0)
+      if (buff_pos_group2 == NJD_TAG_JOSUUSHI || buff_pos_group1 == NJD_TAG_FUKUSHI_KANOU)
          score += 2;
       if (buff_string != NULL) {
          if (strcmp(buff_string, NJD_SET_DIGIT_HAIHUN1) == 0)
@@ -206,7 +205,7 @@ static int get_digit_sequence_score(NJDNode * start, NJDNode * end)
             score -= 2;
          else if (strcmp(buff_string, NJD_SET_DIGIT_KAKKO2) == 0) {
             if (!end->next->next
-                || strcmp(NJDNode_get_pos_group1(end->next->next), NJD_SET_DIGIT_KAZU) != 0)
+                || NJDNode_get_pos_group1_tag(end->next->next) != NJD_TAG_KAZU)
                score += 0;
             else
                score -= 2;
@@ -289,8 +288,7 @@ static void convert_digit_sequence_for_numerical_reading(NJDNode * start, NJDNod
          }
          if (have == 1) {
             if (place > 0) {
-               newnode = (NJDNode *) calloc(1, sizeof(NJDNode));
-               NJDNode_initialize(newnode);
+               newnode = NJDNode_new(node->arena);
                NJDNode_load(newnode, (char *) njd_set_digit_rule_numeral_list3[place]);
                node = NJDNode_insert(node, node->next, newnode);
             }
@@ -306,8 +304,7 @@ static void convert_digit_sequence_for_numerical_reading(NJDNode * start, NJDNod
             NJDNode_load(node, (char *) njd_set_digit_rule_numeral_list2[index]);
             have = 1;
          } else {
-            newnode = (NJDNode *) calloc(1, sizeof(NJDNode));
-            NJDNode_initialize(newnode);
+            newnode = NJDNode_new(node->arena);
             NJDNode_load(newnode, (char *) njd_set_digit_rule_numeral_list2[index]);
             node = NJDNode_insert(node, node->next, newnode);
             have = 1;
@@ -495,10 +492,10 @@ void njd_set_digit(NJD * njd)
 
    /* convert digit sequence */
    for (node = njd->head; node != NULL; node = node->next) {
-      if (find == 0 && strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_KAZU) == 0)
+      if (find == 0 && NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU)
          find = 1;
       if (get_digit(node, 1) >= 0 ||
-          (strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_KAZU) == 0 &&
+          (NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU &&
            (is_period(NJDNode_get_string(node)) == 1 || is_comma(NJDNode_get_string(node)) == 1)
           )) {
          if (s == NULL)
@@ -524,8 +521,8 @@ void njd_set_digit(NJD * njd)
       if (strcmp(NJDNode_get_string(node), "*") != 0
           && strcmp(NJDNode_get_string(node->prev), "*") != 0
           && is_period(NJDNode_get_string(node)) == 1
-          && strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_DIGIT_KAZU) == 0
-          && strcmp(NJDNode_get_pos_group1(node->next), NJD_SET_DIGIT_KAZU) == 0) {
+          && NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_KAZU
+          && NJDNode_get_pos_group1_tag(node->next) == NJD_TAG_KAZU) {
          NJDNode_load(node, NJD_SET_DIGIT_TEN_FEATURE);
          NJDNode_set_chain_flag(node, 1);
          if (strcmp(NJDNode_get_string(node->prev), NJD_SET_DIGIT_ZERO1) == 0
@@ -543,7 +540,7 @@ void njd_set_digit(NJD * njd)
          }
          /* skip digit sequence */
          node = node->next;
-         while (node && strcmp(NJDNode_get_pos(node), NJD_SET_DIGIT_MEISHI) == 0)
+         while (node && NJDNode_get_pos_tag(node) == NJD_TAG_MEISHI)
             node = node->next;
          if (node)
             node = node->next;
@@ -553,9 +550,9 @@ void njd_set_digit(NJD * njd)
    }
 
    for (node = njd->head->next; node != NULL; node = node->next) {
-      if (strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_DIGIT_KAZU) == 0) {
-         if (strcmp(NJDNode_get_pos_group2(node), NJD_SET_DIGIT_JOSUUSHI) == 0
-             || strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_FUKUSHIKANOU) == 0) {
+      if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_KAZU) {
+         if (NJDNode_get_pos_group2_tag(node) == NJD_TAG_JOSUUSHI
+             || NJDNode_get_pos_group1_tag(node) == NJD_TAG_FUKUSHI_KANOU) {
             /* convert digit pron */
             if (search_numerative_class(njd_set_digit_rule_numerative_class1b, node) == 1)
                convert_digit_pron(njd_set_digit_rule_conv_table1b, node->prev);
@@ -598,8 +595,8 @@ void njd_set_digit(NJD * njd)
    }
 
    for (node = njd->head->next; node != NULL; node = node->next) {
-      if (strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_DIGIT_KAZU) == 0) {
-         if (strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_KAZU) == 0
+      if (NJDNode_get_pos_group1_tag(node->prev) == NJD_TAG_KAZU) {
+         if (NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU
              && NJDNode_get_string(node->prev) != NULL && NJDNode_get_string(node) != NULL) {
             /* modify accent phrase */
             find = 0;
@@ -644,12 +641,12 @@ void njd_set_digit(NJD * njd)
    for (node = njd->head; node != NULL; node = node->next) {
       if (node->next != NULL &&
           strcmp(NJDNode_get_string(node->next), "*") != 0 &&
-          strcmp(NJDNode_get_pos_group1(node), NJD_SET_DIGIT_KAZU) == 0 &&
+          NJDNode_get_pos_group1_tag(node) == NJD_TAG_KAZU &&
           (node->prev == NULL
-           || strcmp(NJDNode_get_pos(node->prev), NJD_SET_DIGIT_KIGOU) == 0
-           || strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_DIGIT_KAZU) != 0)
-          && (strcmp(NJDNode_get_pos_group2(node->next), NJD_SET_DIGIT_JOSUUSHI) == 0
-              || strcmp(NJDNode_get_pos_group1(node->next), NJD_SET_DIGIT_FUKUSHIKANOU) == 0)) {
+           || NJDNode_get_pos_tag(node->prev) == NJD_TAG_KIGOU
+           || NJDNode_get_pos_group1_tag(node->prev) != NJD_TAG_KAZU)
+          && (NJDNode_get_pos_group2_tag(node->next) == NJD_TAG_JOSUUSHI
+              || NJDNode_get_pos_group1_tag(node->next) == NJD_TAG_FUKUSHI_KANOU)) {
          /* convert class3 */
          for (i = 0; njd_set_digit_rule_numerative_class3[i] != NULL; i += 2) {
             if (strcmp(NJDNode_get_string(node->next), njd_set_digit_rule_numerative_class3[i]) == 0
@@ -708,7 +705,7 @@ void njd_set_digit(NJD * njd)
 
    for (node = njd->head; node != NULL; node = node->next) {
       if ((node->prev == NULL
-           || strcmp(NJDNode_get_pos_group1(node->prev), NJD_SET_DIGIT_KAZU) != 0)
+           || NJDNode_get_pos_group1_tag(node->prev) != NJD_TAG_KAZU)
           && node->next != NULL && node->next->next != NULL) {
          if (strcmp(NJDNode_get_string(node), NJD_SET_DIGIT_TEN) == 0
              && strcmp(NJDNode_get_string(node->next), NJD_SET_DIGIT_FOUR) == 0) {
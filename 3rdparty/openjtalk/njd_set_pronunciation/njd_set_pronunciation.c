@@ -80,21 +80,9 @@ NJD_SET_PRONUNCIATION_C_START;
 #endif
 #endif
 
-#define MAXBUFLEN 1024
-
-static int strtopcmp(const char *str, const char *pattern)
-{
-   int i;
+#include "njd_set_pronunciation_trie.h"
 
-   for (i = 0;; i++) {
-      if (pattern[i] == '\0')
-         return i;
-      if (str[i] == '\0')
-         return -1;
-      if (str[i] != pattern[i])
-         return -1;
-   }
-}
+#define MAXBUFLEN 1024
 
 void njd_set_pronunciation(NJD * njd)
 {
@@ -103,6 +91,10 @@ void njd_set_pronunciation(NJD * njd)
    int i, j = 0;
    int pos;
    int len;
+   const char *value;
+   int value_size;
+   char buff[MAXBUFLEN];
+   int buff_size;
 
    for (node = njd->head; node != NULL; node = node->next) {
       if (NJDNode_get_mora_size(node) == 0) {
@@ -112,21 +104,30 @@ void njd_set_pronunciation(NJD * njd)
          {
             str = NJDNode_get_string(node);
             len = strlen(str);
+            buff_size = 0;
+            buff[0] = '\0';
             for (pos = 0; pos < len;) {
-               for (i = 0, j = 0; njd_set_pronunciation_list[i] != NULL; i += 3) {
-                  j = strtopcmp(&str[pos], njd_set_pronunciation_list[i]);
-                  if (j > 0)
-                     break;
-               }
+               j = OJTTrie_match(&njd_set_pronunciation_trie, &str[pos], &i);
                if (j > 0) {
                   pos += j;
-                  NJDNode_add_read(node, (char *) njd_set_pronunciation_list[i + 1]);
-                  NJDNode_add_pron(node, (char *) njd_set_pronunciation_list[i + 1]);
+                  value = njd_set_pronunciation_list[i + 1];
+                  value_size = strlen(value);
+                  if (buff_size + value_size >= MAXBUFLEN) {
+                     NJDNode_add_read(node, buff);
+                     NJDNode_add_pron(node, buff);
+                     buff_size = 0;
+                  }
+                  memcpy(&buff[buff_size], value, value_size + 1);
+                  buff_size += value_size;
                   NJDNode_add_mora_size(node, atoi(njd_set_pronunciation_list[i + 2]));
                } else {
                   pos++;
                }
             }
+            if (buff_size > 0) {
+               NJDNode_add_read(node, buff);
+               NJDNode_add_pron(node, buff);
+            }
             /* if filler, overwrite pos */
             if (NJDNode_get_mora_size(node) != 0) {
                NJDNode_set_pos(node, NJD_SET_PRONUNCIATION_FILLER);
@@ -140,12 +141,10 @@ void njd_set_pronunciation(NJD * njd)
          }
          /* if known symbol, set the pronunciation */
          if (strcmp(NJDNode_get_pron(node), "*") == 0) {
-            for (i = 0; njd_set_pronunciation_symbol_list[i] != NULL; i += 2) {
-               if (strcmp(NJDNode_get_string(node), njd_set_pronunciation_symbol_list[i]) == 0) {
-                  NJDNode_set_read(node, (char *) njd_set_pronunciation_symbol_list[i + 1]);
-                  NJDNode_set_pron(node, (char *) njd_set_pronunciation_symbol_list[i + 1]);
-                  break;
-               }
+            i = OJTTrie_find(&njd_set_pronunciation_symbol_trie, NJDNode_get_string(node));
+            if (i >= 0) {
+               NJDNode_set_read(node, (char *) njd_set_pronunciation_symbol_list[i + 1]);
+               NJDNode_set_pron(node, (char *) njd_set_pronunciation_symbol_list[i + 1]);
             }
          }
          /* if the word is not kana, set pause symbol */
@@ -161,28 +160,21 @@ void njd_set_pronunciation(NJD * njd)
    /* chain kana sequence */
    {
       NJDNode *head_of_kana_filler_sequence = NULL;
-      int find;
       for (node = njd->head; node != NULL; node = node->next) {
-         if (strcmp(NJDNode_get_pos(node), NJD_SET_PRONUNCIATION_FILLER) == 0) {
-            find = 0;
-            for (i = 0; njd_set_pronunciation_list[i] != NULL; i += 3) {
-               if (strcmp(NJDNode_get_string(node), njd_set_pronunciation_list[i]) == 0) {
-                  find = 1;
-                  if (head_of_kana_filler_sequence == NULL) {
-                     head_of_kana_filler_sequence = node;
-                  } else {
-                     NJDNode_add_string(head_of_kana_filler_sequence, NJDNode_get_string(node));
-                     NJDNode_add_orig(head_of_kana_filler_sequence, NJDNode_get_orig(node));
-                     NJDNode_add_read(head_of_kana_filler_sequence, NJDNode_get_read(node));
-                     NJDNode_add_pron(head_of_kana_filler_sequence, NJDNode_get_pron(node));
-                     NJDNode_add_mora_size(head_of_kana_filler_sequence,
-                                           NJDNode_get_mora_size(node));
-                     NJDNode_set_pron(node, NULL);
-                  }
-                  break;
+         if (NJDNode_get_pos_tag(node) == NJD_TAG_FILLER) {
+            if (OJTTrie_find(&njd_set_pronunciation_trie, NJDNode_get_string(node)) >= 0) {
+               if (head_of_kana_filler_sequence == NULL) {
+                  head_of_kana_filler_sequence = node;
+               } else {
+                  NJDNode_add_string(head_of_kana_filler_sequence, NJDNode_get_string(node));
+                  NJDNode_add_orig(head_of_kana_filler_sequence, NJDNode_get_orig(node));
+                  NJDNode_add_read(head_of_kana_filler_sequence, NJDNode_get_read(node));
+                  NJDNode_add_pron(head_of_kana_filler_sequence, NJDNode_get_pron(node));
+                  NJDNode_add_mora_size(head_of_kana_filler_sequence,
+                                        NJDNode_get_mora_size(node));
+                  NJDNode_set_pron(node, NULL);
                }
-            }
-            if (find == 0) {
+            } else {
                head_of_kana_filler_sequence = NULL;
             }
          } else {
@@ -195,14 +187,14 @@ void njd_set_pronunciation(NJD * njd)
    for (node = njd->head; node != NULL; node = node->next) {
       if (node->next != NULL
           && strcmp(NJDNode_get_pron(node->next), NJD_SET_PRONUNCIATION_U) == 0
-          && strcmp(NJDNode_get_pos(node->next), NJD_SET_PRONUNCIATION_JODOUSHI) == 0
-          && (strcmp(NJDNode_get_pos(node), NJD_SET_PRONUNCIATION_DOUSHI) == 0
-              || strcmp(NJDNode_get_pos(node), NJD_SET_PRONUNCIATION_JODOUSHI) == 0)
+          && NJDNode_get_pos_tag(node->next) == NJD_TAG_JODOUSHI
+          && (NJDNode_get_pos_tag(node) == NJD_TAG_DOUSHI
+              || NJDNode_get_pos_tag(node) == NJD_TAG_JODOUSHI)
           && NJDNode_get_mora_size(node) > 0) {
          NJDNode_set_pron(node->next, NJD_SET_PRONUNCIATION_CHOUON);
       }
       if (node->next != NULL
-          && strcmp(NJDNode_get_pos(node), NJD_SET_PRONUNCIATION_JODOUSHI) == 0
+          && NJDNode_get_pos_tag(node) == NJD_TAG_JODOUSHI
           && strcmp(NJDNode_get_string(node->next), NJD_SET_PRONUNCIATION_QUESTION) == 0) {
          if (strcmp(NJDNode_get_string(node), NJD_SET_PRONUNCIATION_DESU_STR) == 0)
             NJDNode_set_pron(node, NJD_SET_PRONUNCIATION_DESU_PRON);
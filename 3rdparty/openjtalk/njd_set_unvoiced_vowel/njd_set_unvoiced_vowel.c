@@ -251,9 +251,9 @@ void njd_set_unvoiced_vowel(NJD * njd)
              (strcmp(mora1, NJD_SET_UNVOICED_VOWEL_MA) == 0
               || strcmp(mora1, NJD_SET_UNVOICED_VOWEL_DE) == 0)
              && strcmp(mora2, NJD_SET_UNVOICED_VOWEL_SU) == 0
-             && (strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_DOUSHI) == 0
-                 || strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_JODOUSHI) == 0
-                 || strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_KANDOUSHI) == 0)
+             && (NJDNode_get_pos_tag(nlink2) == NJD_TAG_DOUSHI
+                 || NJDNode_get_pos_tag(nlink2) == NJD_TAG_JODOUSHI
+                 || NJDNode_get_pos_tag(nlink2) == NJD_TAG_KANDOUSHI)
              ) {
             if (strcmp(NJDNode_get_pron(nlink3), NJD_SET_UNVOICED_VOWEL_QUESTION) == 0
                 || strcmp(NJDNode_get_pron(nlink3), NJD_SET_UNVOICED_VOWEL_CHOUON) == 0)
@@ -265,9 +265,9 @@ void njd_set_unvoiced_vowel(NJD * njd)
          /* rule 2: look-ahead for 'shi' */
          if (flag1 != 1 && flag2 == -1 && flag3 != 1 && mora2 != NULL &&
              strcmp(NJDNode_get_pron(nlink2), NJD_SET_UNVOICED_VOWEL_SHI) == 0 &&
-             (strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_DOUSHI) == 0 ||
-              strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_JODOUSHI) == 0 ||
-              strcmp(NJDNode_get_pos(nlink2), NJD_SET_UNVOICED_VOWEL_JOSHI) == 0)) {
+             (NJDNode_get_pos_tag(nlink2) == NJD_TAG_DOUSHI ||
+              NJDNode_get_pos_tag(nlink2) == NJD_TAG_JODOUSHI ||
+              NJDNode_get_pos_tag(nlink2) == NJD_TAG_JOSHI)) {
             if (atype2 == midx2 + 1) {
                /* rule 4 */
                flag2 = 0;
@@ -285,7 +285,7 @@ void njd_set_unvoiced_vowel(NJD * njd)
 
          /* estimate unvoice */
          if (flag1 == -1) {
-            if (strcmp(NJDNode_get_pos(nlink1), NJD_SET_UNVOICED_VOWEL_FILLER) == 0) {
+            if (NJDNode_get_pos_tag(nlink1) == NJD_TAG_FILLER) {
                /* rule 0 */
                flag1 = 0;
             } else if (flag2 == 1) {
@@ -0,0 +1,128 @@
+/* ----------------------------------------------------------------- */
+/*  ojt_arena: bump allocator for per-sentence front-end data        */
+/* ----------------------------------------------------------------- */
+
+#ifndef OJT_ARENA_C
+#define OJT_ARENA_C
+
+#ifdef __cplusplus
+#define OJT_ARENA_C_START extern "C" {
+#define OJT_ARENA_C_END   }
+#else
+#define OJT_ARENA_C_START
+#define OJT_ARENA_C_END
+#endif                          /* __CPLUSPLUS */
+
+OJT_ARENA_C_START;
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ojt_arena.h"
+
+#define OJT_ARENA_ALIGNMENT      16
+#define OJT_ARENA_MIN_BLOCK_SIZE 16384
+#define OJT_ARENA_ALIGN(n)       (((n) + OJT_ARENA_ALIGNMENT - 1) & ~((size_t) OJT_ARENA_ALIGNMENT - 1))
+#define OJT_ARENA_HEADER_SIZE    OJT_ARENA_ALIGN(sizeof(OJTArenaBlock))
+
+static OJTArenaBlock *OJTArenaBlock_new(size_t size)
+{
+   OJTArenaBlock *block = (OJTArenaBlock *) malloc(OJT_ARENA_HEADER_SIZE + size);
+
+   block->next = NULL;
+   block->size = size;
+   block->used = 0;
+   return block;
+}
+
+void OJTArena_initialize(OJTArena * arena)
+{
+   arena->block = NULL;
+   arena->capacity = 0;
+}
+
+void *OJTArena_calloc(OJTArena * arena, size_t num, size_t size)
+{
+   size_t n;
+   size_t block_size;
+   OJTArenaBlock *block;
+   void *mem;
+
+   if (arena == NULL)
+      return calloc(num, size);
+
+   n = OJT_ARENA_ALIGN(num * size);
+   if (n == 0)
+      n = OJT_ARENA_ALIGNMENT;
+
+   block = arena->block;
+   if (block == NULL || block->used + n > block->size) {
+      /* grow geometrically, older blocks stay valid until reset */
+      block_size = arena->capacity > OJT_ARENA_MIN_BLOCK_SIZE ? arena->capacity : OJT_ARENA_MIN_BLOCK_SIZE;
+      if (block_size < n)
+         block_size = n;
+      block = OJTArenaBlock_new(block_size);
+      block->next = arena->block;
+      arena->block = block;
+      arena->capacity += block_size;
+   }
+
+   mem = (char *) block + OJT_ARENA_HEADER_SIZE + block->used;
+   block->used += n;
+   memset(mem, 0, n);
+   return mem;
+}
+
+char *OJTArena_strdup(OJTArena * arena, const char *str)
+{
+   char *buff;
+   size_t size;
+
+   if (arena == NULL)
+      return strdup(str);
+
+   size = strlen(str) + 1;
+   buff = (char *) OJTArena_calloc(arena, size, sizeof(char));
+   memcpy(buff, str, size);
+   return buff;
+}
+
+void OJTArena_free(OJTArena * arena, void *ptr)
+{
+   /* arena memory is released all at once by OJTArena_reset() */
+   if (arena == NULL)
+      free(ptr);
+}
+
+void OJTArena_reset(OJTArena * arena)
+{
+   size_t capacity = arena->capacity;
+
+   if (arena->block == NULL)
+      return;
+
+   if (arena->block->next == NULL) {
+      arena->block->used = 0;
+      return;
+   }
+
+   /* merge into a single block of the high-water size */
+   OJTArena_clear(arena);
+   arena->block = OJTArenaBlock_new(capacity);
+   arena->capacity = capacity;
+}
+
+void OJTArena_clear(OJTArena * arena)
+{
+   OJTArenaBlock *block, *next;
+
+   for (block = arena->block; block != NULL; block = next) {
+      next = block->next;
+      free(block);
+   }
+   OJTArena_initialize(arena);
+}
+
+OJT_ARENA_C_END;
+
+#endif                          /* !OJT_ARENA_C */
@@ -0,0 +1,43 @@
+/* ----------------------------------------------------------------- */
+/*  ojt_arena: bump allocator for per-sentence front-end data        */
+/* ----------------------------------------------------------------- */
+
+#ifndef OJT_ARENA_H
+#define OJT_ARENA_H
+
+#ifdef __cplusplus
+#define OJT_ARENA_H_START extern "C" {
+#define OJT_ARENA_H_END   }
+#else
+#define OJT_ARENA_H_START
+#define OJT_ARENA_H_END
+#endif                          /* __CPLUSPLUS */
+
+OJT_ARENA_H_START;
+
+#include <stddef.h>
+
+/* OJTArena */
+
+typedef struct _OJTArenaBlock {
+   struct _OJTArenaBlock *next; /* previous (smaller) block */
+   size_t size;                 /* size of data following the header */
+   size_t used;                 /* allocated bytes of data */
+} OJTArenaBlock;
+
+typedef struct _OJTArena {
+   OJTArenaBlock *block;        /* current block */
+   size_t capacity;             /* total size of all blocks */
+} OJTArena;
+
+/* all functions accept a NULL arena and then fall back to the heap */
+void OJTArena_initialize(OJTArena * arena);
+void *OJTArena_calloc(OJTArena * arena, size_t num, size_t size);
+char *OJTArena_strdup(OJTArena * arena, const char *str);
+void OJTArena_free(OJTArena * arena, void *ptr);
+void OJTArena_reset(OJTArena * arena);
+void OJTArena_clear(OJTArena * arena);
+
+OJT_ARENA_H_END;
+
+#endif                          /* !OJT_ARENA_H */
@@ -0,0 +1,73 @@
+/* ----------------------------------------------------------------- */
+/*  ojt_trie: static byte tries compiled from rule header lists      */
+/* ----------------------------------------------------------------- */
+
+#ifndef OJT_TRIE_C
+#define OJT_TRIE_C
+
+#ifdef __cplusplus
+#define OJT_TRIE_C_START extern "C" {
+#define OJT_TRIE_C_END   }
+#else
+#define OJT_TRIE_C_START
+#define OJT_TRIE_C_END
+#endif                          /* __CPLUSPLUS */
+
+OJT_TRIE_C_START;
+
+#include <stddef.h>
+
+#include "ojt_trie.h"
+
+static int OJTTrie_next(const OJTTrie * trie, int node, unsigned char c)
+{
+   int i;
+   const int end = trie->node[node * 3 + 1];
+
+   for (i = trie->node[node * 3]; i < end; i++)
+      if (trie->edge_label[i] == c)
+         return trie->edge_next[i];
+   return 0;
+}
+
+int OJTTrie_match(const OJTTrie * trie, const char *str, int *rule)
+{
+   const unsigned char *s = (const unsigned char *) str;
+   int node;
+   int length;
+   int matched = -1;
+
+   if (str == NULL || s[0] == '\0')
+      return -1;
+   node = trie->root[s[0]];
+   for (length = 1; node > 0; length++) {
+      if (trie->node[node * 3 + 2] >= 0) {
+         matched = length;
+         *rule = trie->node[node * 3 + 2];
+      }
+      if (s[length] == '\0')
+         break;
+      node = OJTTrie_next(trie, node, s[length]);
+   }
+   return matched;
+}
+
+int OJTTrie_find(const OJTTrie * trie, const char *str)
+{
+   const unsigned char *s = (const unsigned char *) str;
+   int node;
+   int i;
+
+   if (str == NULL || s[0] == '\0')
+      return -1;
+   node = trie->root[s[0]];
+   for (i = 1; node > 0 && s[i] != '\0'; i++)
+      node = OJTTrie_next(trie, node, s[i]);
+   if (node <= 0)
+      return -1;
+   return trie->node[node * 3 + 2];
+}
+
+OJT_TRIE_C_END;
+
+#endif                          /* !OJT_TRIE_C */
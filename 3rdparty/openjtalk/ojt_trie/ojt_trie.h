@@ -0,0 +1,35 @@
+/* ----------------------------------------------------------------- */
+/*  ojt_trie: static byte tries compiled from rule header lists      */
+/* ----------------------------------------------------------------- */
+
+#ifndef OJT_TRIE_H
+#define OJT_TRIE_H
+
+#ifdef __cplusplus
+#define OJT_TRIE_H_START extern "C" {
+#define OJT_TRIE_H_END   }
+#else
+#define OJT_TRIE_H_START
+#define OJT_TRIE_H_END
+#endif                          /* __CPLUSPLUS */
+
+OJT_TRIE_H_START;
+
+/* OJTTrie: tables generated by ojt_trie_gen */
+
+typedef struct _OJTTrie {
+   const int *root;             /* node reached by each first byte (0 if none) */
+   const int *node;             /* first edge, last edge + 1 and rule index (-1 if none) */
+   const int *edge_label;       /* edge byte, sorted within each node */
+   const int *edge_next;        /* edge destination */
+} OJTTrie;
+
+/* longest pattern at the head of str, returns its length (-1 if none) and the rule index */
+int OJTTrie_match(const OJTTrie * trie, const char *str, int *rule);
+
+/* rule index of the pattern equal to str (-1 if none) */
+int OJTTrie_find(const OJTTrie * trie, const char *str);
+
+OJT_TRIE_H_END;
+
+#endif                          /* !OJT_TRIE_H */
@@ -0,0 +1,262 @@
+/* ----------------------------------------------------------------- */
+/*  ojt_trie: static byte tries compiled from rule header lists      */
+/* ----------------------------------------------------------------- */
+
+/* ojt_trie_gen: compile rule header lists into OJTTrie tables at build time */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ASCII_HEADER
+#if defined(CHARSET_EUC_JP)
+#include "text2mecab_rule_ascii_for_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "text2mecab_rule_ascii_for_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "text2mecab_rule_ascii_for_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#else
+#if defined(CHARSET_EUC_JP)
+#include "text2mecab_rule_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "text2mecab_rule_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "text2mecab_rule_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#endif
+
+#ifdef ASCII_HEADER
+#if defined(CHARSET_EUC_JP)
+#include "njd_set_pronunciation_rule_ascii_for_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "njd_set_pronunciation_rule_ascii_for_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "njd_set_pronunciation_rule_ascii_for_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#else
+#if defined(CHARSET_EUC_JP)
+#include "njd_set_pronunciation_rule_euc_jp.h"
+#elif defined(CHARSET_SHIFT_JIS)
+#include "njd_set_pronunciation_rule_shift_jis.h"
+#elif defined(CHARSET_UTF_8)
+#include "njd_set_pronunciation_rule_utf_8.h"
+#else
+#error CHARSET is not specified
+#endif
+#endif
+
+/* lists that can be compiled: name, first pattern, entry stride */
+static const struct {
+   const char *name;
+   const char **list;
+   int stride;
+} trie_list[] = {
+   {"text2mecab", text2mecab_conv_list, 2},
+   {"njd_set_pronunciation", njd_set_pronunciation_list, 3},
+   {"njd_set_pronunciation_symbol", njd_set_pronunciation_symbol_list, 2}
+};
+
+typedef struct _TrieNode {
+   int child[256];
+   int rule;
+} TrieNode;
+
+static TrieNode *node_list = NULL;
+static int node_size = 0;
+
+static FILE *output = NULL;
+static const char *output_name = NULL;
+
+/* remove the partial output, so that a failed build does not leave a header that looks up to date */
+static void fail(void)
+{
+   if (output != NULL) {
+      fclose(output);
+      remove(output_name);
+   }
+   exit(1);
+}
+
+static void *check_alloc(void *ptr)
+{
+   if (ptr == NULL) {
+      fprintf(stderr, "ERROR: ojt_trie_gen: Cannot allocate memory.\n");
+      fail();
+   }
+   return ptr;
+}
+
+static int new_node(void)
+{
+   int i;
+
+   node_list = (TrieNode *) check_alloc(realloc(node_list, (node_size + 1) * sizeof(TrieNode)));
+   for (i = 0; i < 256; i++)
+      node_list[node_size].child[i] = 0;
+   node_list[node_size].rule = -1;
+   return node_size++;
+}
+
+static void print_int_list(FILE * fp, const char *name, const char *suffix, const int *list,
+                           int size)
+{
+   int i;
+
+   fprintf(fp, "static const int %s_trie_%s[] = {\n", name, suffix);
+   for (i = 0; i < size; i++)
+      fprintf(fp, "%s%d,%s", i % 12 == 0 ? "   " : "", list[i], i % 12 == 11 ? "\n" : " ");
+   if (size % 12 != 0)
+      fprintf(fp, "\n");
+   fprintf(fp, "};\n\n");
+}
+
+static void write_trie(FILE * fp, const char *name, const char **list, int stride)
+{
+   int i, j;
+   int node;
+   int edge_size;
+   int max_expansion = 1;
+   int *order;                  /* node index -> output index (breadth first) */
+   int *queue;
+   int head, tail;
+   int *node_table;
+   int *edge_label;
+   int *edge_next;
+   int root[256];
+   char upper[256];
+
+   /* build */
+   node_size = 0;
+   new_node();
+   for (i = 0; list[i] != NULL; i += stride) {
+      const unsigned char *key = (const unsigned char *) list[i];
+      const int key_length = strlen(list[i]);
+      const int value_length = strlen(list[i + 1]);
+
+      if (key_length == 0) {
+         fprintf(stderr, "ERROR: ojt_trie_gen: Empty pattern in %s.\n", name);
+         fail();
+      }
+      for (node = 0, j = 0; j < key_length; j++) {
+         if (node_list[node].child[key[j]] == 0) {
+            const int child = new_node();
+            node_list[node].child[key[j]] = child;
+         }
+         node = node_list[node].child[key[j]];
+         /* the lists do have patterns that are prefixes of others (e.g. ｳ and ｳﾞ), longest
+            match only picks the same rule as the original first-match scans because every
+            longer pattern is listed before its prefixes, so that order is enforced here */
+         if (j < key_length - 1 && node_list[node].rule >= 0) {
+            fprintf(stderr, "ERROR: ojt_trie_gen: Pattern \"%s\" in %s comes after its prefix \"%s\".\n",
+                    list[i], name, list[node_list[node].rule]);
+            fail();
+         }
+      }
+      /* the original linear scans used the first matching entry, keep that on duplicates */
+      if (node_list[node].rule < 0)
+         node_list[node].rule = i;
+      if (value_length > max_expansion * key_length)
+         max_expansion = (value_length + key_length - 1) / key_length;
+   }
+
+   /* number nodes breadth first so that siblings are contiguous */
+   order = (int *) check_alloc(calloc(node_size, sizeof(int)));
+   queue = (int *) check_alloc(calloc(node_size, sizeof(int)));
+   node_table = (int *) check_alloc(calloc(node_size * 3, sizeof(int)));
+   edge_label = (int *) check_alloc(calloc(node_size, sizeof(int)));
+   edge_next = (int *) check_alloc(calloc(node_size, sizeof(int)));
+   head = 0;
+   tail = 0;
+   queue[tail++] = 0;
+   while (head < tail) {
+      node = queue[head];
+      order[node] = head++;
+      for (j = 0; j < 256; j++)
+         if (node_list[node].child[j] != 0)
+            queue[tail++] = node_list[node].child[j];
+   }
+   edge_size = 0;
+   for (i = 0; i < node_size; i++) {
+      node = queue[i];
+      node_table[i * 3] = edge_size;
+      for (j = 0; j < 256; j++) {
+         if (node_list[node].child[j] != 0) {
+            edge_label[edge_size] = j;
+            edge_next[edge_size] = order[node_list[node].child[j]];
+            edge_size++;
+         }
+      }
+      node_table[i * 3 + 1] = edge_size;
+      node_table[i * 3 + 2] = node_list[node].rule;
+   }
+   for (j = 0; j < 256; j++)
+      root[j] = node_list[0].child[j] != 0 ? order[node_list[0].child[j]] : 0;
+
+   /* output */
+   for (i = 0; name[i] != '\0' && i < 255; i++)
+      upper[i] = toupper((unsigned char) name[i]);
+   upper[i] = '\0';
+   fprintf(fp, "/* upper bound of output bytes per input byte */\n");
+   fprintf(fp, "#define %s_TRIE_MAX_EXPANSION %d\n\n", upper, max_expansion);
+   print_int_list(fp, name, "root", root, 256);
+   print_int_list(fp, name, "node", node_table, node_size * 3);
+   print_int_list(fp, name, "edge_label", edge_label, edge_size);
+   print_int_list(fp, name, "edge_next", edge_next, edge_size);
+   fprintf(fp, "static const OJTTrie %s_trie = {\n", name);
+   fprintf(fp, "   %s_trie_root, %s_trie_node, %s_trie_edge_label, %s_trie_edge_next\n", name, name,
+           name, name);
+   fprintf(fp, "};\n\n");
+
+   free(order);
+   free(queue);
+   free(node_table);
+   free(edge_label);
+   free(edge_next);
+}
+
+int main(int argc, char **argv)
+{
+   int i, j;
+   int found;
+   FILE *fp;
+
+   if (argc < 3) {
+      fprintf(stderr, "Usage: ojt_trie_gen output.h list [list ...]\n");
+      return 1;
+   }
+
+   fp = fopen(argv[1], "w");
+   if (fp == NULL) {
+      fprintf(stderr, "ERROR: ojt_trie_gen: Cannot open %s.\n", argv[1]);
+      return 1;
+   }
+   output = fp;
+   output_name = argv[1];
+   fprintf(fp, "/* generated by ojt_trie_gen, do not edit */\n\n");
+   fprintf(fp, "#include \"ojt_trie.h\"\n\n");
+   for (i = 2; i < argc; i++) {
+      found = 0;
+      for (j = 0; j < (int) (sizeof(trie_list) / sizeof(trie_list[0])); j++) {
+         if (strcmp(argv[i], trie_list[j].name) == 0) {
+            write_trie(fp, trie_list[j].name, trie_list[j].list, trie_list[j].stride);
+            found = 1;
+         }
+      }
+      if (found == 0) {
+         fprintf(stderr, "ERROR: ojt_trie_gen: Unknown list %s.\n", argv[i]);
+         fail();
+      }
+   }
+   fclose(fp);
+   free(node_list);
+
+   return 0;
+}
@@ -52,6 +52,7 @@
 TEXT2MECAB_C_START;
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "text2mecab.h"
@@ -78,36 +79,19 @@ TEXT2MECAB_C_START;
 #endif
 #endif
 
-static int strtopcmp(const char *str, const char *pattern)
-{
-   int i;
+#include "text2mecab_trie.h"
 
-   for (i = 0;; i++) {
-      if (pattern[i] == '\0')
-         return i;
-      if (str[i] == '\0')
-         return -1;
-      if (str[i] != pattern[i])
-         return -1;
-   }
-}
-
-void text2mecab(char *output, const char *input)
+static void convert(char *output, const char *input, int length)
 {
    int i, j;
-   const int length = strlen(input);
    const char *str;
    int index = 0;
-   int s, e = -1;
+   int s, e;
 
    for (s = 0; s < length;) {
       str = &input[s];
       /* search */
-      for (i = 0; text2mecab_conv_list[i] != NULL; i += 2) {
-         e = strtopcmp(str, text2mecab_conv_list[i]);
-         if (e != -1)
-            break;
-      }
+      e = OJTTrie_match(&text2mecab_trie, str, &i);
       if (e != -1) {
          /* convert */
          s += e;
@@ -127,7 +111,7 @@ void text2mecab(char *output, const char *input)
             }
          }
          if (e > 0) {
-            for (j = 0; j < e; j++)
+            for (j = 0; j < e && s < length; j++)
                output[index++] = input[s++];
          } else {
             /* unknown */
@@ -139,6 +123,28 @@ void text2mecab(char *output, const char *input)
    output[index] = '\0';
 }
 
+void text2mecab(char *output, const char *input)
+{
+   convert(output, input, strlen(input));
+}
+
+int text2mecab_realloc(char **output, size_t * size, const char *input)
+{
+   const int length = strlen(input);
+   const size_t required = (size_t) length * TEXT2MECAB_TRIE_MAX_EXPANSION + 1;
+   char *buff;
+
+   if (*output == NULL || *size < required) {
+      buff = (char *) realloc(*output, required);
+      if (buff == NULL)
+         return 0;
+      *output = buff;
+      *size = required;
+   }
+   convert(*output, input, length);
+   return 1;
+}
+
 TEXT2MECAB_C_END;
 
 #endif                          /* !TEXT2MECAB_C */
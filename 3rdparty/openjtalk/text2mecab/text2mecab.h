@@ -51,8 +51,13 @@
 
 TEXT2MECAB_H_START;
 
+#include <stddef.h>
+
 void text2mecab(char *output, const char *input);
 
+/* convert into *output, growing it with realloc() to fit; *size is its allocated size */
+int text2mecab_realloc(char **output, size_t * size, const char *input);
+
 TEXT2MECAB_H_END;
 
 #endif                          /* !TEXT2MECAB_H */
@@ -42,6 +42,20 @@ int main(int argc, char *argv[])
     QCommandLineOption katakanaInput("o", "Katakana input.");
     parser.addOption(katakanaInput);
 
+#ifdef ENABLE_SPEECH_SYNTH
+    QCommandLineOption synthVoices("v", "Speech synthesis voice, can be given several times to give cards different voices.", "path");
+    parser.addOption(synthVoices);
+
+    QCommandLineOption synthVoiceWeights("w", "Comma separated weights to interpolate the speech synthesis voices for every card.", "weights");
+    parser.addOption(synthVoiceWeights);
+
+    QCommandLineOption synthSampleRate("s", "Speech synthesis sample rate, 0 for the rate of the voice.", "rate", QStringLiteral("0"));
+    parser.addOption(synthSampleRate);
+
+    QCommandLineOption synthQualityLevel("q", "Lowest speech synthesis quality level to fall back to when synthesis is slow, 0 always uses full quality.", "level");
+    parser.addOption(synthQualityLevel);
+#endif
+
     parser.process(app);
 
     Quiz::CardFilters cardFilters = Quiz::CardFilter::None;
@@ -52,9 +66,26 @@ int main(int argc, char *argv[])
     if (parser.isSet(examplesOnly))
         cardFilters.setFlag(Quiz::CardFilter::ExamplesOnly);
 
+#ifdef ENABLE_SPEECH_SYNTH
+    Quiz quiz(parser.values(synthVoices));
+#else
     Quiz quiz;
+#endif
     quiz.setCardFilters(cardFilters);
     quiz.setKatakanaInput(parser.isSet(katakanaInput));
+#ifdef ENABLE_SPEECH_SYNTH
+    if (parser.isSet(synthVoiceWeights)) {
+        QList<double> voiceWeights;
+        const auto weights = parser.value(synthVoiceWeights).split(QLatin1Char(','));
+        for (const auto &weight : weights)
+            voiceWeights.append(weight.toDouble());
+        quiz.setSynthVoiceWeights(voiceWeights);
+    }
+    if (parser.isSet(synthSampleRate))
+        quiz.setSynthSampleRate(parser.value(synthSampleRate).toInt());
+    if (parser.isSet(synthQualityLevel))
+        quiz.setMaxSynthQualityLevel(parser.value(synthQualityLevel).toInt());
+#endif
     if (!quiz.readCards(parser.value(questionsPath)))
         return -1;
 
@@ -0,0 +1,114 @@
+#include "pcmbuffer.h"
+
+#include <QMutex>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+struct PcmBuffer::Data {
+    std::atomic<int> ref = 1;
+    std::vector<qint16> samples;
+    std::shared_ptr<PcmBufferPool::State> pool;
+};
+
+struct PcmBufferPool::State {
+    ~State()
+    {
+        for (auto *d : free)
+            delete d;
+    }
+
+    QMutex mutex;
+    std::vector<PcmBuffer::Data *> free;
+};
+
+PcmBuffer::PcmBuffer(Data *d)
+    : d(d)
+{
+}
+
+PcmBuffer::PcmBuffer(const PcmBuffer &other)
+    : d(other.d)
+{
+    if (d)
+        d->ref.fetch_add(1, std::memory_order_relaxed);
+}
+
+PcmBuffer::PcmBuffer(PcmBuffer &&other) noexcept
+    : d(std::exchange(other.d, nullptr))
+{
+}
+
+PcmBuffer::~PcmBuffer()
+{
+    if (!d || d->ref.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    // the samples keep their capacity for the next utterance
+    auto pool = std::move(d->pool);
+    QMutexLocker locker(&pool->mutex);
+    pool->free.push_back(d);
+}
+
+PcmBuffer &PcmBuffer::operator=(PcmBuffer other) noexcept
+{
+    std::swap(d, other.d);
+    return *this;
+}
+
+bool PcmBuffer::isNull() const
+{
+    return !d;
+}
+
+size_t PcmBuffer::size() const
+{
+    return d ? d->samples.size() : 0;
+}
+
+const qint16 *PcmBuffer::data() const
+{
+    return d ? d->samples.data() : nullptr;
+}
+
+const qint16 *PcmBuffer::constData() const
+{
+    return data();
+}
+
+qint16 *PcmBuffer::data()
+{
+    Q_ASSERT(!d || d->ref.load(std::memory_order_relaxed) == 1);
+    return d ? d->samples.data() : nullptr;
+}
+
+void PcmBuffer::resize(size_t size)
+{
+    Q_ASSERT(d && d->ref.load(std::memory_order_relaxed) == 1);
+    d->samples.resize(size);
+}
+
+PcmBufferPool::PcmBufferPool()
+    : m_state(std::make_shared<State>())
+{
+}
+
+PcmBufferPool::~PcmBufferPool() = default;
+
+PcmBuffer PcmBufferPool::acquire()
+{
+    PcmBuffer::Data *d = nullptr;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        if (!m_state->free.empty()) {
+            d = m_state->free.back();
+            m_state->free.pop_back();
+        }
+    }
+    if (!d)
+        d = new PcmBuffer::Data;
+    d->ref.store(1, std::memory_order_relaxed);
+    d->pool = m_state;
+    return PcmBuffer(d);
+}
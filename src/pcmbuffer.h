@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QMetaType>
+#include <QtGlobal>
+
+#include <memory>
+
+class PcmBufferPool;
+
+// Mono 16-bit PCM samples taken from a PcmBufferPool. Copies share the
+// samples, which go back to their pool when the last copy is gone, so audio
+// is handed from the synth thread to playback without copying and buffers
+// are reused once their capacity covers the longest utterance.
+class PcmBuffer
+{
+public:
+    PcmBuffer() = default;
+    PcmBuffer(const PcmBuffer &other);
+    PcmBuffer(PcmBuffer &&other) noexcept;
+    ~PcmBuffer();
+
+    PcmBuffer &operator=(PcmBuffer other) noexcept;
+
+    bool isNull() const;
+    size_t size() const;
+    const qint16 *data() const;
+    const qint16 *constData() const;
+    // only to be written before the buffer is shared
+    qint16 *data();
+    void resize(size_t size);
+
+private:
+    friend class PcmBufferPool;
+    struct Data;
+
+    explicit PcmBuffer(Data *d);
+
+    Data *d = nullptr;
+};
+
+Q_DECLARE_METATYPE(PcmBuffer)
+
+class PcmBufferPool
+{
+public:
+    PcmBufferPool();
+    ~PcmBufferPool();
+
+    PcmBufferPool(const PcmBufferPool &) = delete;
+    PcmBufferPool &operator=(const PcmBufferPool &) = delete;
+
+    PcmBuffer acquire();
+
+private:
+    friend class PcmBuffer;
+    struct State;
+
+    // buffers still in use keep the free list alive past the pool
+    std::shared_ptr<State> m_state;
+};
@@ -0,0 +1,44 @@
+#include "pcmdevice.h"
+
+#include <algorithm>
+#include <cstring>
+
+PcmDevice::PcmDevice(QObject *parent)
+    : QIODevice(parent)
+{
+}
+
+void PcmDevice::setBuffer(const PcmBuffer &buffer)
+{
+    clear();
+    m_buffer = buffer;
+    // unbuffered, QIODevice would otherwise copy the samples into its own
+    // read buffer first
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void PcmDevice::clear()
+{
+    if (isOpen())
+        close();
+    m_buffer = {};
+}
+
+qint64 PcmDevice::size() const
+{
+    return static_cast<qint64>(m_buffer.size() * sizeof(qint16));
+}
+
+qint64 PcmDevice::readData(char *data, qint64 maxSize)
+{
+    const auto count = std::min(maxSize, size() - pos());
+    if (count <= 0)
+        return 0;
+    std::memcpy(data, reinterpret_cast<const char *>(m_buffer.constData()) + pos(), count);
+    return count;
+}
+
+qint64 PcmDevice::writeData(const char *, qint64)
+{
+    return -1;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "pcmbuffer.h"
+
+#include <QIODevice>
+
+// Read-only device over a PcmBuffer, so an audio sink reads the synthesized
+// samples in place. Clearing it returns the buffer to its pool.
+class PcmDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit PcmDevice(QObject *parent = nullptr);
+
+    void setBuffer(const PcmBuffer &buffer);
+    void clear();
+
+    qint64 size() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    PcmBuffer m_buffer;
+};
@@ -17,24 +17,33 @@
 #include "synththread.h"
 #endif
 
+#ifdef ENABLE_SPEECH_SYNTH
 Quiz::Quiz(QObject *parent)
+    : Quiz(QStringList(), parent)
+{
+}
+
+// every voice is loaded once, cards then pick one of them without reloading,
+// without voices the default one is used
+Quiz::Quiz(const QStringList &synthVoicePaths, QObject *parent)
     : QObject(parent)
-#ifdef ENABLE_SPEECH_SYNTH
-    , m_synthThread(new SynthThread(this))
+    , m_synthThread(synthVoicePaths.isEmpty() ? new SynthThread(this) : new SynthThread(synthVoicePaths, this))
     , m_synthState(m_synthThread->initialized() && initializeAudio() ? SynthState::Idle : SynthState::Error)
-#endif
 {
-#ifdef ENABLE_SPEECH_SYNTH
-    connect(m_synthThread, &SynthThread::synthesizedAudio, this, [this](const QByteArray &audioData) {
+    connect(m_synthThread, &SynthThread::synthesizedAudio, this, [this](const PcmBuffer &audio) {
         Q_ASSERT(m_audioSink);
-        m_audioBuffer.setData(audioData);
-        m_audioBuffer.open(QIODevice::ReadOnly);
-        m_audioSink->start(&m_audioBuffer);
+        m_audioDevice.setBuffer(audio);
+        m_audioSink->start(&m_audioDevice);
         m_synthState = SynthState::Playing;
         emit synthStateChanged();
     });
-#endif
 }
+#else
+Quiz::Quiz(QObject *parent)
+    : QObject(parent)
+{
+}
+#endif
 
 Quiz::~Quiz()
 {
@@ -55,6 +64,27 @@ void Quiz::setKatakanaInput(bool katakanaInput)
     emit katakanaInputChanged(katakanaInput);
 }
 
+#ifdef ENABLE_SPEECH_SYNTH
+// interpolates the voices for every card instead of giving each card one voice
+void Quiz::setSynthVoiceWeights(const QList<double> &voiceWeights)
+{
+    m_synthVoiceWeights = voiceWeights;
+}
+
+void Quiz::setSynthSampleRate(int sampleRate)
+{
+    stopSynth();
+    m_synthThread->setSampleRate(sampleRate);
+    m_synthState = m_synthThread->initialized() && initializeAudio() ? SynthState::Idle : SynthState::Error;
+    emit synthStateChanged();
+}
+
+void Quiz::setMaxSynthQualityLevel(int level)
+{
+    m_synthThread->setMaxQualityLevel(level);
+}
+#endif
+
 bool Quiz::katakanaInput() const
 {
     return m_katakanaInput;
@@ -304,7 +334,13 @@ int Quiz::countReviewCards() const
 void Quiz::sayExample()
 {
     if (m_curExample && m_synthState == SynthState::Idle) {
-        m_synthThread->synthesize(m_curExample->nihongo);
+        if (!m_synthVoiceWeights.isEmpty()) {
+            m_synthThread->synthesize(m_curExample->nihongo, m_synthVoiceWeights);
+        } else {
+            // a card always gets the same voice
+            const auto voice = static_cast<int>(m_curCard - m_cards.data()) % m_synthThread->voiceCount();
+            m_synthThread->synthesize(m_curExample->nihongo, voice);
+        }
         m_synthState = SynthState::Loading;
         emit synthStateChanged();
     }
@@ -330,11 +366,21 @@ bool Quiz::initializeAudio()
     format.setChannelCount(1);
     format.setSampleFormat(QAudioFormat::Int16);
 
+    // play at the synthesis rate when possible, otherwise resample to the
+    // rate the device prefers
     QAudioDevice info(QMediaDevices::defaultAudioOutput());
     if (!info.isFormatSupported(format)) {
-        return false;
+        format.setSampleRate(info.preferredFormat().sampleRate());
+        if (!info.isFormatSupported(format)) {
+            return false;
+        }
+        qDebug() << "Resampling speech from" << m_synthThread->sampleRate() << "Hz to" << format.sampleRate() << "Hz";
+        m_synthThread->setOutputSampleRate(format.sampleRate());
+    } else {
+        m_synthThread->setOutputSampleRate(0);
     }
 
+    delete m_audioSink;
     m_audioSink = new QAudioSink(format, this);
     connect(m_audioSink, &QAudioSink::stateChanged, this, [this](QAudio::State newState) {
         switch (newState) {
@@ -345,7 +391,8 @@ bool Quiz::initializeAudio()
             if (m_audioSink->error() != QAudio::NoError) {
                 qWarning() << "Error playing audio:" << m_audioSink->error();
             }
-            m_audioBuffer.close();
+            // the samples go back to the pool of the synth thread
+            m_audioDevice.clear();
             m_synthState = SynthState::Idle;
             emit synthStateChanged();
             break;
@@ -1,8 +1,12 @@
 #pragma once
 
-#include <QBuffer>
+#include <QObject>
 #include <QVariantMap>
 
+#ifdef ENABLE_SPEECH_SYNTH
+#include "pcmdevice.h"
+#endif
+
 class QAudioSink;
 class SynthThread;
 
@@ -19,6 +23,9 @@ class Quiz : public QObject
 
 public:
     Quiz(QObject *parent = nullptr);
+#ifdef ENABLE_SPEECH_SYNTH
+    explicit Quiz(const QStringList &synthVoicePaths, QObject *parent = nullptr);
+#endif
     ~Quiz();
 
     enum class SynthState {
@@ -40,6 +47,11 @@ public:
 
     void setCardFilters(CardFilters cardFilters);
     void setKatakanaInput(bool katakanaInput);
+#ifdef ENABLE_SPEECH_SYNTH
+    void setSynthVoiceWeights(const QList<double> &voiceWeights);
+    void setSynthSampleRate(int sampleRate);
+    void setMaxSynthQualityLevel(int level);
+#endif
 
     bool readCards(const QString &path);
 
@@ -106,7 +118,8 @@ private:
     QString m_deckPath;
 #ifdef ENABLE_SPEECH_SYNTH
     SynthThread *m_synthThread;
-    QBuffer m_audioBuffer;
+    QList<double> m_synthVoiceWeights;
+    PcmDevice m_audioDevice;
     QAudioSink *m_audioSink = nullptr;
     SynthState m_synthState;
 #endif
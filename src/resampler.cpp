@@ -0,0 +1,123 @@
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numbers>
+#include <numeric>
+
+namespace {
+
+constexpr auto TapsPerZeroCrossing = 16;
+constexpr auto Rolloff = 0.9;
+constexpr auto KaiserBeta = 8.0;
+constexpr auto Lanes = 8;
+
+// modified Bessel function of the first kind, order 0
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; term > 1e-12 * sum; ++k) {
+        const auto t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+double sinc(double x)
+{
+    if (x == 0.0)
+        return 1.0;
+    return std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+}
+
+} // namespace
+
+Resampler::Resampler(int inputRate, int outputRate)
+    : m_inputRate(inputRate)
+    , m_outputRate(outputRate)
+{
+    if (inputRate == outputRate)
+        return;
+
+    const auto divisor = std::gcd(inputRate, outputRate);
+    m_up = outputRate / divisor;
+    m_down = inputRate / divisor;
+
+    // when decimating the filter cuts at the output Nyquist frequency, in
+    // input samples the kernel gets wider by the same factor
+    const auto cutoff = Rolloff * std::min(1.0, static_cast<double>(m_up) / m_down);
+    auto halfTaps = static_cast<int>(std::ceil(TapsPerZeroCrossing * Rolloff / cutoff));
+    // rounded up so the taps split evenly across the accumulator lanes
+    halfTaps = (halfTaps + Lanes / 2 - 1) / (Lanes / 2) * (Lanes / 2);
+    m_taps = 2 * halfTaps;
+
+    const auto window = besselI0(KaiserBeta);
+    m_coefficients.resize(m_up * m_taps);
+    for (int phase = 0; phase < m_up; ++phase) {
+        auto *coefficients = &m_coefficients[phase * m_taps];
+        double sum = 0.0;
+        for (int i = 0; i < m_taps; ++i) {
+            // distance in input samples from input tap i to the output sample
+            const auto t = static_cast<double>(phase) / m_up + halfTaps - 1 - i;
+            const auto x = t / halfTaps;
+            const auto w = std::abs(x) < 1.0 ? besselI0(KaiserBeta * std::sqrt(1.0 - x * x)) / window : 0.0;
+            const auto h = sinc(cutoff * t) * w;
+            coefficients[i] = static_cast<float>(h);
+            sum += h;
+        }
+        // unity gain at DC for every phase
+        for (int i = 0; i < m_taps; ++i)
+            coefficients[i] = static_cast<float>(coefficients[i] / sum);
+    }
+}
+
+bool Resampler::isNull() const
+{
+    return m_coefficients.empty();
+}
+
+int Resampler::inputRate() const
+{
+    return m_inputRate;
+}
+
+int Resampler::outputRate() const
+{
+    return m_outputRate;
+}
+
+void Resampler::process(const float *input, size_t size, std::vector<float> &output)
+{
+    if (isNull()) {
+        output.assign(input, input + size);
+        return;
+    }
+
+    // zero padded so the dot products never need bounds checks
+    const auto halfTaps = m_taps / 2;
+    m_input.assign(size + m_taps, 0.0f);
+    std::copy(input, input + size, m_input.begin() + halfTaps - 1);
+
+    const auto outputSize = (size * m_up + m_down - 1) / m_down;
+    output.resize(outputSize);
+    size_t position = 0;
+    int phase = 0;
+    for (size_t i = 0; i < outputSize; ++i) {
+        const auto *x = &m_input[position];
+        const auto *coefficients = &m_coefficients[phase * m_taps];
+        // independent partial sums, a single accumulator would serialize the adds
+        float sum[Lanes] = {};
+        for (int j = 0; j < m_taps; j += Lanes) {
+            for (int k = 0; k < Lanes; ++k)
+                sum[k] += coefficients[j + k] * x[j + k];
+        }
+        output[i] = std::accumulate(std::begin(sum), std::end(sum), 0.0f);
+
+        phase += m_down;
+        position += phase / m_up;
+        phase %= m_up;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Rational polyphase resampler with a Kaiser windowed sinc filter. The
+// coefficients are stored phase by phase so each output sample is a single
+// contiguous dot product, which the compiler vectorizes.
+class Resampler
+{
+public:
+    Resampler() = default;
+    Resampler(int inputRate, int outputRate);
+
+    bool isNull() const;
+    int inputRate() const;
+    int outputRate() const;
+
+    void process(const float *input, size_t size, std::vector<float> &output);
+
+private:
+    int m_inputRate = 0;
+    int m_outputRate = 0;
+    int m_up = 1;
+    int m_down = 1;
+    int m_taps = 0;
+    std::vector<float> m_coefficients;
+    std::vector<float> m_input;
+};
@@ -10,13 +10,38 @@
 #include <njd_set_unvoiced_vowel.h>
 #include <text2mecab.h>
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 
 #include <algorithm>
 #include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 
 namespace {
 
+// labels of the most recently synthesized texts, about 500 sentences
+constexpr auto LabelCacheSize = 20000;
+
+// bump when the front end or the file layout changes labels for the same text
+constexpr quint32 LabelCacheMagic = 0x4a4c4243; // "JLBC"
+constexpr quint32 LabelCacheVersion = 1;
+
+// phoneme of the pauses OpenJTalk puts at both ends of an utterance
+constexpr auto SilencePhoneme = "sil";
+
+// silence kept around the speech, in milliseconds, enough for the attack
+// of the first phoneme and the filter tail of the last one
+constexpr auto LeadingSilence = 30;
+constexpr auto TrailingSilence = 100;
+
 class LocaleSetter
 {
 public:
@@ -43,11 +68,35 @@ private:
 } // namespace
 
 Synth::Synth()
+    : m_labelCache(LabelCacheSize)
 {
     Mecab_initialize(&m_mecab);
+    OJTArena_initialize(&m_arena);
     NJD_initialize(&m_njd);
+    NJD_set_arena(&m_njd, &m_arena);
     JPCommon_initialize(&m_jpcommon);
+    JPCommon_set_arena(&m_jpcommon, &m_arena);
     HTS_Engine_initialize(&m_engine);
+
+    // JPCommon labels and the HTS engine share the full-context layout, so
+    // questions can be matched against label fields instead of strings
+    for (int i = 0; i < JPCOMMON_LABEL_FIELD_SIZE; ++i) {
+        const auto field = static_cast<JPCommonLabelField>(i);
+        m_contextFields[i].prefix = JPCommonLabelField_get_prefix(field);
+        switch (JPCommonLabelField_get_type(field)) {
+        case JPCOMMON_LABEL_TYPE_STRING:
+            m_contextFields[i].type = HTS_CONTEXT_STRING;
+            break;
+        case JPCOMMON_LABEL_TYPE_SIGNED:
+            m_contextFields[i].type = HTS_CONTEXT_SIGNED;
+            break;
+        default:
+            m_contextFields[i].type = HTS_CONTEXT_INTEGER;
+            break;
+        }
+    }
+    m_contextFormat.field = m_contextFields;
+    m_contextFormat.nfield = JPCOMMON_LABEL_FIELD_SIZE;
 }
 
 Synth::~Synth()
@@ -55,76 +104,308 @@ Synth::~Synth()
     HTS_Engine_clear(&m_engine);
     JPCommon_clear(&m_jpcommon);
     NJD_clear(&m_njd);
+    OJTArena_clear(&m_arena);
     Mecab_clear(&m_mecab);
+    std::free(m_mecabInput);
 }
 
 bool Synth::loadDictionary(const char *dictionary)
 {
-    return Mecab_load(&m_mecab, dictionary) == TRUE;
+    if (Mecab_load(&m_mecab, dictionary) != TRUE)
+        return false;
+
+    // cached labels are only valid for the dictionary files they came from
+    QByteArray dictionaryId;
+    const auto files = QDir(QFile::decodeName(dictionary)).entryInfoList(QDir::Files, QDir::Name);
+    for (const auto &file : files)
+        dictionaryId += file.fileName().toUtf8() + ' ' + QByteArray::number(file.size()) + ' ' + QByteArray::number(file.lastModified().toMSecsSinceEpoch()) + '\n';
+    if (dictionaryId != m_dictionaryId) {
+        m_dictionaryId = dictionaryId;
+        m_labelCache.clear();
+        m_labelCacheChanged = false;
+    }
+    return true;
+}
+
+bool Synth::loadLabelCache(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version, fieldCount;
+    QByteArray dictionaryId;
+    stream >> magic >> version >> fieldCount >> dictionaryId;
+    if (magic != LabelCacheMagic || version != LabelCacheVersion || fieldCount != JPCOMMON_LABEL_FIELD_SIZE || dictionaryId != m_dictionaryId)
+        return false;
+
+    quint32 entryCount;
+    stream >> entryCount;
+    for (quint32 i = 0; i < entryCount && stream.status() == QDataStream::Ok; ++i) {
+        QByteArray text;
+        quint32 labelSize;
+        stream >> text >> labelSize;
+        // checked before allocating, a corrupt size could ask for any amount
+        if (stream.status() != QDataStream::Ok || labelSize == 0 || labelSize > quint32(LabelCacheSize)) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        auto context = std::make_unique<std::vector<HTS_ContextValue>>(labelSize * JPCOMMON_LABEL_FIELD_SIZE);
+        for (size_t j = 0; j < context->size() && stream.status() == QDataStream::Ok; ++j) {
+            if (m_contextFields[j % JPCOMMON_LABEL_FIELD_SIZE].type == HTS_CONTEXT_STRING) {
+                QByteArray string;
+                stream >> string;
+                (*context)[j].string = internString(string.isNull() ? nullptr : string.constData());
+            } else {
+                qint32 integer;
+                stream >> integer;
+                (*context)[j].integer = integer;
+            }
+        }
+        if (stream.status() == QDataStream::Ok)
+            m_labelCache.insert(text, context.release(), labelSize);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        m_labelCache.clear();
+        return false;
+    }
+    return true;
+}
+
+bool Synth::saveLabelCache(const QString &path)
+{
+    if (!m_labelCacheChanged)
+        return true;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    const auto texts = m_labelCache.keys();
+    stream << LabelCacheMagic << LabelCacheVersion << quint32(JPCOMMON_LABEL_FIELD_SIZE) << m_dictionaryId << quint32(texts.size());
+    for (const auto &text : texts) {
+        const auto *context = m_labelCache.object(text);
+        stream << text << quint32(context->size() / JPCOMMON_LABEL_FIELD_SIZE);
+        for (size_t i = 0; i < context->size(); ++i) {
+            if (m_contextFields[i % JPCOMMON_LABEL_FIELD_SIZE].type == HTS_CONTEXT_STRING)
+                stream << QByteArray((*context)[i].string);
+            else
+                stream << qint32((*context)[i].integer);
+        }
+    }
+    if (!file.commit())
+        return false;
+    m_labelCacheChanged = false;
+    return true;
+}
+
+const char *Synth::internString(const char *string)
+{
+    if (!string)
+        return nullptr;
+    return m_strings.emplace(string).first->c_str();
 }
 
 bool Synth::loadVoice(const char *voice)
+{
+    return loadVoices({ voice });
+}
+
+bool Synth::loadVoices(const std::vector<const char *> &voices)
 {
     // hts_engine uses atof, set locale to "C"
     LocaleSetter locale(LC_NUMERIC, "C");
 
-    char *voices = const_cast<char *>(voice);
-    if (HTS_Engine_load(&m_engine, &voices, 1) != TRUE) {
+    if (HTS_Engine_load(&m_engine, const_cast<char **>(voices.data()), voices.size()) != TRUE) {
         return false;
     }
-    qDebug() << "Loaded voice, label format:" << HTS_Engine_get_fullcontext_label_format(&m_engine);
+    qDebug() << "Loaded" << voices.size() << "voices, label format:" << HTS_Engine_get_fullcontext_label_format(&m_engine);
+    loadedVoice();
 
     return true;
 }
 
+bool Synth::loadVoiceImage(const char *image)
+{
+    return loadVoiceImages({ image });
+}
+
+bool Synth::loadVoiceImages(const std::vector<const char *> &images)
+{
+    // stream options are still parsed with atof
+    LocaleSetter locale(LC_NUMERIC, "C");
+
+    // every voice is a read-only mapping of its image, shared with any
+    // other engine that maps the same file
+    if (HTS_Engine_load_images(&m_engine, const_cast<char **>(images.data()), images.size()) != TRUE) {
+        return false;
+    }
+    qDebug() << "Loaded" << images.size() << "voice images, label format:" << HTS_Engine_get_fullcontext_label_format(&m_engine);
+    loadedVoice();
+
+    return true;
+}
+
+void Synth::loadedVoice()
+{
+    // loading resets every condition of the engine
+    HTS_Engine_set_frame_callback(&m_engine, &Synth::frameCallback, this);
+    m_voiceSampleRate = HTS_Engine_get_sampling_frequency(&m_engine);
+    m_voiceFramePeriod = HTS_Engine_get_fperiod(&m_engine);
+    m_outputSampleRate = 0;
+    m_resampler = {};
+    setContextFormat();
+    invalidate(Step::Text);
+}
+
+void Synth::setContextFormat()
+{
+    if (HTS_Engine_set_context_format(&m_engine, &m_contextFormat) != TRUE)
+        qDebug() << "Some questions of the voice need label strings";
+}
+
+bool Synth::saveVoiceImage(const char *image, const char *voice)
+{
+    return HTS_Engine_save_image(&m_engine, image, voice) == TRUE;
+}
+
+// compares the size and checksum of the voice with those the image records, and checksums the image itself
+bool Synth::isVoiceImageOf(const char *image, const char *voice)
+{
+    return HTS_Engine_check_image(image, voice) == TRUE;
+}
+
+size_t Synth::voiceCount() const
+{
+    return HTS_Engine_get_nvoices(const_cast<HTS_Engine *>(&m_engine));
+}
+
+void Synth::setVoice(size_t index)
+{
+    std::vector<double> weights(voiceCount());
+    if (index < weights.size())
+        weights[index] = 1.0;
+    setVoiceWeights(weights);
+}
+
+void Synth::setVoiceWeights(const std::vector<double> &weights)
+{
+    // weights are normalized, a voice with weight 0 is skipped by the tree
+    // search so selecting one of the loaded voices costs the same as having
+    // loaded only that one
+    const auto voiceCount = this->voiceCount();
+    double sum = 0.0;
+    for (size_t i = 0; i < std::min(weights.size(), voiceCount); ++i)
+        sum += std::max(weights[i], 0.0);
+    if (sum <= 0.0)
+        return;
+
+    // the weights pick the models of every label, so the state sequence has
+    // to be searched again
+    const auto streamCount = HTS_Engine_get_nstream(&m_engine);
+    for (size_t i = 0; i < voiceCount; ++i) {
+        const auto weight = i < weights.size() ? std::max(weights[i], 0.0) / sum : 0.0;
+        setCondition(m_engine.condition.duration_iw[i], Step::Text, [&] { HTS_Engine_set_duration_interpolation_weight(&m_engine, i, weight); });
+        for (size_t j = 0; j < streamCount; ++j) {
+            setCondition(m_engine.condition.parameter_iw[i][j], Step::Text, [&] { HTS_Engine_set_parameter_interpolation_weight(&m_engine, i, j, weight); });
+            setCondition(m_engine.condition.gv_iw[i][j], Step::Text, [&] { HTS_Engine_set_gv_interpolation_weight(&m_engine, i, j, weight); });
+        }
+    }
+}
+
+size_t Synth::voiceSampleRate() const
+{
+    return m_voiceSampleRate;
+}
+
+size_t Synth::synthesisRate() const
+{
+    return HTS_Engine_get_sampling_frequency(const_cast<HTS_Engine *>(&m_engine));
+}
+
+size_t Synth::outputSampleRate() const
+{
+    return m_outputSampleRate ? m_outputSampleRate : synthesisRate();
+}
+
+void Synth::setSynthesisRate(size_t value)
+{
+    // the vocoder maps the voice spectrum onto the synthesis band, frames
+    // keep the duration they have at the voice rate
+    const auto rate = value ? value : m_voiceSampleRate;
+    if (rate == synthesisRate())
+        return;
+    HTS_Engine_set_sampling_frequency(&m_engine, rate);
+    HTS_Engine_set_fperiod(&m_engine, std::lround(static_cast<double>(m_voiceFramePeriod) * rate / m_voiceSampleRate));
+    invalidate(Step::Samples);
+    setOutputSampleRate(m_outputSampleRate);
+}
+
+void Synth::setOutputSampleRate(size_t value)
+{
+    m_outputSampleRate = value;
+    const auto outputRate = outputSampleRate();
+    if (static_cast<size_t>(m_resampler.inputRate()) != synthesisRate() || static_cast<size_t>(m_resampler.outputRate()) != outputRate)
+        m_resampler = Resampler(synthesisRate(), outputRate);
+}
+
 void Synth::setSamplingFrequency(size_t value)
 {
-    HTS_Engine_set_sampling_frequency(&m_engine, value);
+    setCondition(m_engine.condition.sampling_frequency, Step::Samples, [&] { HTS_Engine_set_sampling_frequency(&m_engine, value); });
 }
 
 void Synth::setFramePeriod(size_t value)
 {
-    HTS_Engine_set_fperiod(&m_engine, value);
+    setCondition(m_engine.condition.fperiod, Step::Samples, [&] { HTS_Engine_set_fperiod(&m_engine, value); });
 }
 
 void Synth::setAllPassConstant(double value)
 {
-    HTS_Engine_set_alpha(&m_engine, value);
+    setCondition(m_engine.condition.alpha, Step::Samples, [&] { HTS_Engine_set_alpha(&m_engine, value); });
 }
 
 void Synth::setPostfilteringCoefficient(double value)
 {
-    HTS_Engine_set_beta(&m_engine, value);
+    setCondition(m_engine.condition.beta, Step::Samples, [&] { HTS_Engine_set_beta(&m_engine, value); });
+}
+
+void Synth::setPadeOrder(size_t value)
+{
+    setCondition(m_engine.condition.pade_order, Step::Samples, [&] { HTS_Engine_set_pade_order(&m_engine, value); });
 }
 
 void Synth::setSpeechSpeedRate(double value)
 {
-    HTS_Engine_set_speed(&m_engine, value);
+    setCondition(m_engine.condition.speed, Step::StateSequence, [&] { HTS_Engine_set_speed(&m_engine, value); });
 }
 
 void Synth::setAdditionalHalfTone(double value)
 {
-    HTS_Engine_add_half_tone(&m_engine, value);
+    setCondition(m_engine.condition.additional_half_tone, Step::StateSequence, [&] { HTS_Engine_add_half_tone(&m_engine, value); });
 }
 
 void Synth::setVoiceUnvoicedThreshold(double value)
 {
-    HTS_Engine_set_msd_threshold(&m_engine, 1, value);
+    setCondition(m_engine.condition.msd_threshold[1], Step::Parameters, [&] { HTS_Engine_set_msd_threshold(&m_engine, 1, value); });
 }
 
 void Synth::setGVWeightForSpectrum(double value)
 {
-    HTS_Engine_set_gv_weight(&m_engine, 0, value);
+    setCondition(m_engine.condition.gv_weight[0], Step::Parameters, [&] { HTS_Engine_set_gv_weight(&m_engine, 0, value); });
 }
 
 void Synth::setGVWeightForLogF0(double value)
 {
-    HTS_Engine_set_gv_weight(&m_engine, 1, value);
+    setCondition(m_engine.condition.gv_weight[1], Step::Parameters, [&] { HTS_Engine_set_gv_weight(&m_engine, 1, value); });
 }
 
 void Synth::setVolume(double value)
 {
-    HTS_Engine_set_volume(&m_engine, value);
+    setCondition(m_engine.condition.volume, Step::Samples, [&] { HTS_Engine_set_volume(&m_engine, value); });
 }
 
 void Synth::setAudioBufferSize(size_t value)
@@ -132,13 +413,129 @@ void Synth::setAudioBufferSize(size_t value)
     HTS_Engine_set_audio_buff_size(&m_engine, value);
 }
 
-QByteArray Synth::synthesize(const char *text)
+template<typename T, typename Setter>
+void Synth::setCondition(const T &condition, Step step, Setter setter)
 {
-    char buf[1024];
-    text2mecab(buf, text);
-    Mecab_analysis(&m_mecab, buf);
+    const auto previous = condition;
+    setter();
+    if (condition != previous)
+        invalidate(step);
+}
+
+void Synth::invalidate(Step step)
+{
+    m_step = std::max(m_step, step);
+}
+
+// the samples are written straight into the buffer that is played
+bool Synth::synthesize(const char *text, PcmBuffer &audio)
+{
+    // the state sequence and parameters of the last text are kept, so a
+    // change of condition only reruns the steps that depend on it
+    const bool synthesized = m_step < Step::Text && m_text == text ? resynthesize() : synthesizeText(text);
+    if (synthesized && isStopped()) {
+        // the vocoder was stopped between two frames, the parameters are kept
+        // so it starts over from them on the next call
+        m_text = text;
+        m_step = Step::Samples;
+        audio.resize(0);
+        return false;
+    }
+    if (!synthesized) {
+        HTS_Engine_refresh(&m_engine);
+        m_text.clear();
+        m_step = Step::Text;
+        audio.resize(0);
+        return false;
+    }
+    m_text = text;
+    m_step = Step::None;
+
+    // the boundary silence is as long as the frames given to its states, so
+    // most of it is cut without looking at the waveform
+    const auto sampleCount = HTS_Engine_get_nsamples(&m_engine);
+    const auto framePeriod = HTS_Engine_get_fperiod(&m_engine);
+    const auto labelCount = HTS_Engine_get_total_state(&m_engine) / HTS_Engine_get_nstate(&m_engine);
+    const auto leading = m_leadingSilence ? labelFrames(0) * framePeriod : 0;
+    const auto trailing = m_trailingSilence && labelCount > 1 ? labelFrames(labelCount - 1) * framePeriod : 0;
+    const auto begin = leading - std::min(leading, synthesisRate() * LeadingSilence / 1000);
+    const auto end = std::max(begin, sampleCount - (trailing - std::min(trailing, synthesisRate() * TrailingSilence / 1000)));
+    m_speechOnset = (leading - begin) * outputSampleRate() / synthesisRate();
+
+    m_samples.resize(end - begin);
+    for (size_t i = begin; i < end; ++i)
+        m_samples[i - begin] = static_cast<float>(HTS_Engine_get_generated_speech(&m_engine, i));
+    m_resampler.process(m_samples.data(), m_samples.size(), m_resampled);
+    audio.resize(m_resampled.size());
+    auto *data = audio.data();
+    for (const auto sample : m_resampled)
+        *data++ = static_cast<qint16>(std::clamp(sample, -32768.0f, 32767.0f));
+
+    return true;
+}
+
+// offset of the end of the leading silence in the last result, in samples
+// at the output rate
+size_t Synth::speechOnset() const
+{
+    return m_speechOnset;
+}
 
-    mecab2njd(&m_njd, Mecab_get_feature(&m_mecab), Mecab_get_size(&m_mecab));
+// may be called from any thread, synthesize fails until it is cleared
+void Synth::setStopped(bool stopped)
+{
+    m_stopped = stopped;
+}
+
+bool Synth::isStopped() const
+{
+    return m_stopped;
+}
+
+// called on the synthesizing thread after every vocoder frame
+void Synth::setProgressHandler(std::function<void(size_t frame, size_t frameCount)> handler)
+{
+    m_progressHandler = std::move(handler);
+}
+
+// the engine stop flag isn't atomic, so the vocoder polls m_stopped here
+// between two frames instead
+HTS_Boolean Synth::frameCallback(void *data, size_t frame, size_t frameCount)
+{
+    auto *synth = static_cast<Synth *>(data);
+    if (synth->m_progressHandler)
+        synth->m_progressHandler(frame, frameCount);
+    return synth->m_stopped ? FALSE : TRUE;
+}
+
+bool Synth::resynthesize()
+{
+    if (m_step >= Step::StateSequence && HTS_Engine_update_state_sequence(&m_engine) != TRUE)
+        return false;
+    if (m_step >= Step::Parameters && HTS_Engine_generate_parameter_sequence(&m_engine) != TRUE)
+        return false;
+    if (m_step >= Step::Samples && HTS_Engine_generate_sample_sequence(&m_engine) != TRUE)
+        return false;
+    return true;
+}
+
+bool Synth::synthesizeText(const char *text)
+{
+    if (!text2mecab_realloc(&m_mecabInput, &m_mecabInputSize, text))
+        return false;
+
+    // labels only depend on the normalized text and the dictionary
+    const QByteArray key(m_mecabInput);
+    if (const auto *context = m_labelCache.object(key)) {
+        setBoundarySilence(context->data(), context->size() / JPCOMMON_LABEL_FIELD_SIZE);
+        return synthesizeContexts(context->data(), context->size() / JPCOMMON_LABEL_FIELD_SIZE);
+    }
+
+    Mecab_analysis(&m_mecab, m_mecabInput);
+
+    const auto *tokens = Mecab_get_token(&m_mecab);
+    for (int i = 0, size = Mecab_get_size(&m_mecab); i < size; ++i)
+        mecab2njd_push_token(&m_njd, tokens[i].surface, tokens[i].length, tokens[i].feature);
     njd_set_pronunciation(&m_njd);
     njd_set_digit(&m_njd);
     njd_set_accent_phrase(&m_njd);
@@ -147,24 +544,53 @@ QByteArray Synth::synthesize(const char *text)
     njd_set_long_vowel(&m_njd);
     njd2jpcommon(&m_jpcommon, &m_njd);
     JPCommon_make_label(&m_jpcommon);
-    QByteArray result;
-    if (JPCommon_get_label_size(&m_jpcommon) > 2) {
-        if (HTS_Engine_synthesize_from_strings(&m_engine, JPCommon_get_label_feature(&m_jpcommon), JPCommon_get_label_size(&m_jpcommon)) == TRUE) {
-            const auto sampleCount = HTS_Engine_get_nsamples(&m_engine);
-            result.resize(sampleCount * sizeof(short));
-            auto *data = result.data();
-            for (int i = 0; i < sampleCount; ++i) {
-                const auto sample = HTS_Engine_get_generated_speech(&m_engine, i);
-                const short value = static_cast<short>(std::clamp(sample, -32768.0, 32767.0));
-                *data++ = value & 0xff;
-                *data++ = (value >> 8) & 0xff;
-            }
+    bool synthesized = false;
+    const auto labelSize = JPCommon_get_label_size(&m_jpcommon);
+    if (labelSize > 2) {
+        const auto *context = JPCommon_get_label_context(&m_jpcommon);
+        m_context.resize(labelSize * JPCOMMON_LABEL_FIELD_SIZE);
+        for (size_t i = 0; i < m_context.size(); ++i) {
+            if (m_contextFields[i % JPCOMMON_LABEL_FIELD_SIZE].type == HTS_CONTEXT_STRING)
+                m_context[i].string = internString(context[i].string);
+            else
+                m_context[i].integer = context[i].integer;
+        }
+        setBoundarySilence(m_context.data(), labelSize);
+        synthesized = synthesizeContexts(m_context.data(), labelSize);
+        if (synthesized) {
+            m_labelCache.insert(key, new std::vector<HTS_ContextValue>(m_context), labelSize);
+            m_labelCacheChanged = true;
         }
-        HTS_Engine_refresh(&m_engine);
     }
     JPCommon_refresh(&m_jpcommon);
     NJD_refresh(&m_njd);
+    OJTArena_reset(&m_arena);
     Mecab_refresh(&m_mecab);
 
-    return result;
+    return synthesized;
+}
+
+bool Synth::synthesizeContexts(const HTS_ContextValue *context, size_t labelSize)
+{
+    return HTS_Engine_generate_state_sequence_from_contexts(&m_engine, context, labelSize) == TRUE
+        && HTS_Engine_generate_parameter_sequence(&m_engine) == TRUE && HTS_Engine_generate_sample_sequence(&m_engine) == TRUE;
+}
+
+void Synth::setBoundarySilence(const HTS_ContextValue *context, size_t labelSize)
+{
+    const auto isSilence = [&](size_t label) {
+        const auto *phoneme = context[label * JPCOMMON_LABEL_FIELD_SIZE + JPCOMMON_LABEL_P3].string;
+        return phoneme && std::strcmp(phoneme, SilencePhoneme) == 0;
+    };
+    m_leadingSilence = labelSize > 0 && isSilence(0);
+    m_trailingSilence = labelSize > 0 && isSilence(labelSize - 1);
+}
+
+size_t Synth::labelFrames(size_t label)
+{
+    const auto stateCount = HTS_Engine_get_nstate(&m_engine);
+    size_t frames = 0;
+    for (size_t i = label * stateCount; i < (label + 1) * stateCount; ++i)
+        frames += HTS_Engine_get_state_duration(&m_engine, i);
+    return frames;
 }
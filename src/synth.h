@@ -4,8 +4,20 @@
 #include <jpcommon.h>
 #include <mecab.h>
 #include <njd.h>
+#include <ojt_arena.h>
+
+#include "pcmbuffer.h"
+#include "resampler.h"
 
 #include <QByteArray>
+#include <QCache>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 class Synth
 {
@@ -18,11 +30,29 @@ public:
 
     bool loadDictionary(const char *dictionary);
     bool loadVoice(const char *voice);
+    bool loadVoices(const std::vector<const char *> &voices);
+    bool loadVoiceImage(const char *image);
+    bool loadVoiceImages(const std::vector<const char *> &images);
+    bool saveVoiceImage(const char *image, const char *voice);
+    static bool isVoiceImageOf(const char *image, const char *voice);
+    bool loadLabelCache(const QString &path);
+    bool saveLabelCache(const QString &path);
+
+    size_t voiceCount() const;
+    void setVoice(size_t index);
+    void setVoiceWeights(const std::vector<double> &weights);
+
+    size_t voiceSampleRate() const;
+    size_t synthesisRate() const;
+    size_t outputSampleRate() const;
+    void setSynthesisRate(size_t value);
+    void setOutputSampleRate(size_t value);
 
     void setSamplingFrequency(size_t value);
     void setFramePeriod(size_t value);
     void setAllPassConstant(double value);
     void setPostfilteringCoefficient(double value);
+    void setPadeOrder(size_t value);
     void setSpeechSpeedRate(double value);
     void setAdditionalHalfTone(double value);
     void setVoiceUnvoicedThreshold(double value);
@@ -31,11 +61,65 @@ public:
     void setVolume(double value);
     void setAudioBufferSize(size_t value);
 
-    QByteArray synthesize(const char *text);
+    bool synthesize(const char *text, PcmBuffer &audio);
+    size_t speechOnset() const;
+    void setStopped(bool stopped);
+    bool isStopped() const;
+    void setProgressHandler(std::function<void(size_t frame, size_t frameCount)> handler);
 
 private:
+    // synthesis steps in order, the last text is synthesized again from the
+    // earliest step whose conditions changed
+    enum class Step {
+        None,
+        Samples,
+        Parameters,
+        StateSequence,
+        Text
+    };
+
+    static HTS_Boolean frameCallback(void *data, size_t frame, size_t frameCount);
+    void setContextFormat();
+    void loadedVoice();
+    template<typename T, typename Setter>
+    void setCondition(const T &condition, Step step, Setter setter);
+    void invalidate(Step step);
+    bool resynthesize();
+    bool synthesizeText(const char *text);
+    bool synthesizeContexts(const HTS_ContextValue *context, size_t labelSize);
+    void setBoundarySilence(const HTS_ContextValue *context, size_t labelSize);
+    size_t labelFrames(size_t label);
+    const char *internString(const char *string);
+
     HTS_Engine m_engine;
+    HTS_ContextField m_contextFields[JPCOMMON_LABEL_FIELD_SIZE];
+    HTS_ContextFormat m_contextFormat;
+    std::vector<HTS_ContextValue> m_context;
+    // label string fields point into m_strings, which outlives the front end
+    // buffers they are copied from
+    std::unordered_set<std::string> m_strings;
+    QCache<QByteArray, std::vector<HTS_ContextValue>> m_labelCache;
+    QByteArray m_dictionaryId;
+    bool m_labelCacheChanged = false;
+    OJTArena m_arena;
     NJD m_njd;
     JPCommon m_jpcommon;
     Mecab m_mecab;
+    char *m_mecabInput = nullptr;
+    size_t m_mecabInputSize = 0;
+    size_t m_voiceSampleRate = 0;
+    size_t m_voiceFramePeriod = 0;
+    size_t m_outputSampleRate = 0;
+    Resampler m_resampler;
+    std::vector<float> m_samples;
+    std::vector<float> m_resampled;
+    QByteArray m_text;
+    Step m_step = Step::Text;
+    bool m_leadingSilence = false;
+    bool m_trailingSilence = false;
+    size_t m_speechOnset = 0;
+    // the only stop flag written from other threads, the engine one is left
+    // to the synthesizing thread
+    std::atomic<bool> m_stopped = false;
+    std::function<void(size_t frame, size_t frameCount)> m_progressHandler;
 };
@@ -0,0 +1,35 @@
+#include "synthawaiter.h"
+
+#include <QFutureWatcher>
+
+SynthAwaiter::SynthAwaiter(const QFuture<PcmBuffer> &future, QObject *context)
+    : m_future(future)
+    , m_context(context)
+{
+}
+
+bool SynthAwaiter::await_ready() const
+{
+    return m_future.isFinished();
+}
+
+void SynthAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    if (!m_context)
+        return;
+    // the watcher also reports canceled futures as finished, a continuation
+    // with then() would never run for them
+    auto *watcher = new QFutureWatcher<PcmBuffer>(m_context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handle] {
+        watcher->deleteLater();
+        handle.resume();
+    });
+    watcher->setFuture(m_future);
+}
+
+PcmBuffer SynthAwaiter::await_resume() const
+{
+    if (m_future.isCanceled() || m_future.resultCount() == 0)
+        return {};
+    return m_future.result();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pcmbuffer.h"
+
+#include <QFuture>
+#include <QPointer>
+
+#include <coroutine>
+
+class QObject;
+
+// Awaits a future of SynthThread::synthesizeAsync in a C++20 coroutine:
+//
+//     const auto audio = co_await SynthAwaiter(synthThread->synthesizeAsync(text), this);
+//
+// The coroutine resumes in the thread of context, with a null buffer if the
+// request was canceled. It is never resumed if context is destroyed first.
+class SynthAwaiter
+{
+public:
+    SynthAwaiter(const QFuture<PcmBuffer> &future, QObject *context);
+
+    bool await_ready() const;
+    void await_suspend(std::coroutine_handle<> handle);
+    PcmBuffer await_resume() const;
+
+private:
+    QFuture<PcmBuffer> m_future;
+    QPointer<QObject> m_context;
+};
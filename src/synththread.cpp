@@ -1,75 +1,401 @@
 #include "synththread.h"
 
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QPromise>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace {
 constexpr auto DictionaryPath = "/var/lib/mecab/dic/open-jtalk/naist-jdic";
 constexpr auto VoicePath = "/usr/share/hts-voice/nitech-jp-atr503-m001/nitech_jp_atr503_m001.htsvoice";
-constexpr auto SampleRate = 48000;
+constexpr auto PostfilteringCoefficient = 0.0;
+constexpr auto GVWeight = 1.0;
+
+// quality is restored once synthesis is this much under the targets, so the
+// cost of the better level doesn't push it straight back over them
+constexpr auto RestoreMargin = 0.4;
+
+QString labelCachePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(QStringLiteral("labels.cache"));
+}
+
+struct QualityLevel {
+    bool postfilter;
+    bool gvForSpectrum;
+    bool gvForLogF0;
+    int maxSampleRate; // 0 for no limit
+    int padeOrder;
+};
+
+// ordered by what is lost first, GV and the postfilter only shape the
+// parameters while the sample rate and pade order cut the vocoder cost, the
+// engine has pade coefficients for orders 4 and 5 only and HTS_EMBEDDED
+// builds clamp 5 down to 4
+constexpr QualityLevel QualityLevels[] = {
+    { true, true, true, 0, 5 },
+    { false, false, true, 0, 5 },
+    { false, false, false, 0, 4 },
+    { false, false, false, 22050, 4 },
+    { false, false, false, 16000, 4 },
+};
+constexpr auto QualityLevelCount = static_cast<int>(std::size(QualityLevels));
 } // namespace
 
 SynthThread::SynthThread(QObject *parent)
+    : SynthThread(QStringList { QString::fromUtf8(VoicePath) }, parent)
+{
+}
+
+// all voices are loaded up front and selected per request by their
+// interpolation weights, so they must share the sample rate and the streams
+SynthThread::SynthThread(const QStringList &voicePaths, QObject *parent)
     : QThread(parent)
+    , m_voicePaths(voicePaths)
+    , m_maxQualityLevel(QualityLevelCount - 1)
 {
     initializeSynth();
 }
 
+SynthThread::CancelToken::CancelToken()
+    : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void SynthThread::CancelToken::cancel() const
+{
+    m_cancelled->store(true);
+}
+
+bool SynthThread::CancelToken::isCancelled() const
+{
+    return m_cancelled->load();
+}
+
+bool SynthThread::CancelToken::operator==(const CancelToken &other) const
+{
+    return m_cancelled == other.m_cancelled;
+}
+
 bool SynthThread::initialized() const
 {
     return m_initialized;
 }
 
+int SynthThread::voiceCount() const
+{
+    return m_voiceCount;
+}
+
 SynthThread::~SynthThread()
 {
     m_mutex.lock();
     m_abort = true;
+    m_synth.setStopped(true);
     m_condition.wakeOne();
     m_mutex.unlock();
     wait();
+
+    if (m_initialized) {
+        const auto path = labelCachePath();
+        if (!QDir().mkpath(QFileInfo(path).path()) || !m_synth.saveLabelCache(path))
+            qWarning("Failed to write label cache %s", qPrintable(path));
+    }
 }
 
 int SynthThread::sampleRate() const
 {
-    return SampleRate;
+    QMutexLocker locker(&m_mutex);
+    return m_sampleRate ? m_sampleRate : static_cast<int>(m_synth.voiceSampleRate());
+}
+
+// 0 synthesizes at the rate of the voice, the voice spectrum is mapped onto
+// lower rates so they can trade bandwidth for vocoder time
+void SynthThread::setSampleRate(int sampleRate)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sampleRate = sampleRate;
+}
+
+// audio is resampled to this rate when the device can't play the synthesis
+// rate, 0 plays it as synthesized
+void SynthThread::setOutputSampleRate(int sampleRate)
+{
+    QMutexLocker locker(&m_mutex);
+    m_outputSampleRate = sampleRate;
+}
+
+// synthesis falls back at most to this level when it can't keep up with
+// the targets, 0 always synthesizes at full quality
+void SynthThread::setMaxQualityLevel(int level)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxQualityLevel = std::clamp(level, 0, QualityLevelCount - 1);
+}
+
+// synthesis time over audio duration
+void SynthThread::setTargetRealTimeFactor(double realTimeFactor)
+{
+    QMutexLocker locker(&m_mutex);
+    m_targetRealTimeFactor = realTimeFactor;
+}
+
+// time the synthesis of one job may take, the time it waits in the queue
+// doesn't count as a lower quality wouldn't shorten it
+void SynthThread::setMaxSynthesisTime(int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxSynthesisTime = msecs;
+}
+
+void SynthThread::synthesize(const QString &text, int voice)
+{
+    synthesize(text, singleVoiceWeights(voice));
+}
+
+QList<double> SynthThread::singleVoiceWeights(int voice) const
+{
+    QList<double> voiceWeights(m_voiceCount, 0.0);
+    if (voice >= 0 && voice < m_voiceCount)
+        voiceWeights[voice] = 1.0;
+    return voiceWeights;
+}
+
+// an interactive job, its audio goes to synthesizedAudio
+void SynthThread::synthesize(const QString &text, const QList<double> &voiceWeights)
+{
+    Job job;
+    job.text = text;
+    job.voiceWeights = voiceWeights;
+    synthesize(job);
 }
 
-void SynthThread::synthesize(const QString &text)
+void SynthThread::synthesize(const Job &job)
 {
     if (!m_initialized)
         return;
+    // direct, so it runs in the destroying thread before the context is gone
+    if (job.context)
+        connect(job.context, &QObject::destroyed, this, &SynthThread::contextDestroyed, static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection));
     QMutexLocker locker(&m_mutex);
-    m_text = text;
+    enqueue(job);
+}
+
+// called with m_mutex locked
+void SynthThread::enqueue(const Job &job)
+{
+    // behind the queued jobs of the same priority
+    const auto position = std::find_if(m_jobs.begin(), m_jobs.end(), [&job](const Job &queued) { return queued.priority < job.priority; });
+    m_jobs.insert(position, job);
+    if (m_runningJob && m_runningJob->priority < job.priority)
+        m_synth.setStopped(true);
     if (!isRunning()) {
         start(LowPriority);
     } else {
-        m_restart = true;
         m_condition.wakeOne();
     }
 }
 
+void SynthThread::cancel(const CancelToken &cancelToken)
+{
+    cancelToken.cancel();
+    QMutexLocker locker(&m_mutex);
+    if (m_runningJob && m_runningJob->cancelToken == cancelToken)
+        m_synth.setStopped(true);
+}
+
+QFuture<PcmBuffer> SynthThread::synthesizeAsync(const QString &text, int voice, Priority priority)
+{
+    return synthesizeAsync(text, singleVoiceWeights(voice), priority);
+}
+
+// a text requested again while it is still pending shares the first
+// request's future, and its job, so cancelling it cancels both
+QFuture<PcmBuffer> SynthThread::synthesizeAsync(const QString &text, const QList<double> &voiceWeights, Priority priority)
+{
+    if (!m_initialized)
+        return {};
+
+    auto key = text;
+    for (const auto weight : voiceWeights)
+        key += QLatin1Char('\n') + QString::number(weight);
+
+    QMutexLocker locker(&m_mutex);
+    if (const auto it = m_pendingRequests.constFind(key); it != m_pendingRequests.cend() && !it->future.isFinished() && !it->future.isCanceled()) {
+        raisePriority(it->cancelToken, priority);
+        return it->future;
+    }
+    // the future of a job dropped when cancelled finishes as canceled
+    m_pendingRequests.removeIf([](QHash<QString, PendingRequest>::iterator it) { return it->future.isFinished(); });
+
+    auto promise = std::make_shared<QPromise<PcmBuffer>>();
+    Job job;
+    job.text = text;
+    job.voiceWeights = voiceWeights;
+    job.priority = priority;
+    job.done = [this, promise, key, cancelToken = job.cancelToken](const PcmBuffer &audio) {
+        {
+            // a request made after this one was cancelled may have taken its place
+            QMutexLocker locker(&m_mutex);
+            if (const auto it = m_pendingRequests.constFind(key); it != m_pendingRequests.cend() && it->cancelToken == cancelToken)
+                m_pendingRequests.erase(it);
+        }
+        promise->addResult(audio);
+        promise->finish();
+    };
+    job.progress = [this, promise, cancelToken = job.cancelToken](size_t frame, size_t frameCount) {
+        if (promise->isCanceled()) {
+            if (!cancelToken.isCancelled())
+                cancel(cancelToken);
+            return;
+        }
+        if (frame == 0)
+            promise->setProgressRange(0, static_cast<int>(frameCount));
+        promise->setProgressValue(static_cast<int>(frame));
+    };
+    promise->start();
+    const auto future = promise->future();
+    m_pendingRequests.insert(key, { future, job.cancelToken });
+    enqueue(job);
+    return future;
+}
+
+// called with m_mutex locked
+void SynthThread::raisePriority(const CancelToken &cancelToken, Priority priority)
+{
+    const auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [&cancelToken](const Job &queued) { return queued.cancelToken == cancelToken; });
+    if (it == m_jobs.end() || it->priority >= priority)
+        return;
+    auto job = *it;
+    m_jobs.erase(it);
+    job.priority = priority;
+    enqueue(job);
+}
+
 void SynthThread::run()
 {
     for (;;) {
         m_mutex.lock();
-        const auto text = m_text;
-        m_mutex.unlock();
-
-        if (m_abort)
+        while (!m_abort && m_jobs.isEmpty())
+            m_condition.wait(&m_mutex);
+        if (m_abort) {
+            m_mutex.unlock();
             break;
+        }
+        m_runningJob = m_jobs.takeFirst();
+        // cleared while holding the lock, so a stop for this job is never lost
+        m_synth.setStopped(false);
+        const auto sampleRate = m_sampleRate;
+        const auto outputSampleRate = m_outputSampleRate;
+        const auto maxQualityLevel = m_maxQualityLevel;
+        const auto targetRealTimeFactor = m_targetRealTimeFactor;
+        const auto maxSynthesisTime = m_maxSynthesisTime;
+        m_mutex.unlock();
 
-        QElapsedTimer timer;
-        timer.start();
-        const auto audioData = m_synth.synthesize(text.toUtf8().data());
-        qDebug() << "Synthesized in" << timer.elapsed() << "ms";
+        const auto &job = *m_runningJob;
+        auto audio = m_bufferPool.acquire();
+        bool preempted = false;
+        if (job.progress)
+            job.progress(0, 0);
+        if (!job.cancelToken.isCancelled()) {
+            m_qualityLevel = std::min(m_qualityLevel, maxQualityLevel);
+            applyQualityLevel(sampleRate, outputSampleRate);
+            m_synth.setVoiceWeights({ job.voiceWeights.begin(), job.voiceWeights.end() });
 
-        emit synthesizedAudio(audioData);
+            QElapsedTimer timer;
+            timer.start();
+            m_synth.setProgressHandler(job.progress);
+            preempted = !m_synth.synthesize(job.text.toUtf8().data(), audio) && m_synth.isStopped();
+            m_synth.setProgressHandler({});
+            const auto elapsed = timer.elapsed();
+            if (!preempted) {
+                const auto duration = static_cast<qint64>(audio.size() * 1000 / m_synth.outputSampleRate());
+                const auto speechOnset = static_cast<qint64>(m_synth.speechOnset() * 1000 / m_synth.outputSampleRate());
+                qDebug() << "Synthesized" << duration << "ms in" << elapsed << "ms at quality level" << m_qualityLevel << "speech starts at" << speechOnset << "ms";
+                updateQualityLevel(elapsed, duration, maxQualityLevel, targetRealTimeFactor, maxSynthesisTime);
+            }
+        }
 
         m_mutex.lock();
-        if (!m_restart) {
-            m_condition.wait(&m_mutex);
+        const auto finished = std::move(*m_runningJob);
+        m_runningJob.reset();
+        if (preempted && !finished.cancelToken.isCancelled()) {
+            // ahead of the other jobs of its priority, it was picked first
+            const auto position = std::find_if(m_jobs.begin(), m_jobs.end(), [&finished](const Job &queued) { return queued.priority <= finished.priority; });
+            m_jobs.insert(position, finished);
         }
-        m_restart = false;
+        const auto delivered = !preempted && !finished.cancelToken.isCancelled();
+        auto *context = finished.done ? finished.context : nullptr;
+        // posted while holding the lock, contextDestroyed takes it too so the
+        // context can't be destroyed meanwhile, a destroyed context drops it
+        if (delivered && context)
+            QMetaObject::invokeMethod(context, [done = finished.done, audio] { done(audio); });
         m_mutex.unlock();
+
+        if (delivered && !context)
+            finishJob(finished, audio);
+    }
+}
+
+// jobs with a context are delivered by run
+void SynthThread::finishJob(const Job &job, const PcmBuffer &audio)
+{
+    if (!job.done) {
+        emit synthesizedAudio(audio);
+    } else {
+        job.done(audio);
+    }
+}
+
+// called in the thread destroying context
+void SynthThread::contextDestroyed(QObject *context)
+{
+    QMutexLocker locker(&m_mutex);
+    for (const auto &job : std::as_const(m_jobs)) {
+        if (job.context == context)
+            job.cancelToken.cancel();
+    }
+    if (m_runningJob && m_runningJob->context == context) {
+        m_runningJob->cancelToken.cancel();
+        m_synth.setStopped(true);
+    }
+}
+
+void SynthThread::applyQualityLevel(int sampleRate, int outputSampleRate)
+{
+    // lower synthesis rates are resampled back to the rate audio was opened with
+    const auto &level = QualityLevels[m_qualityLevel];
+    const auto baseSampleRate = sampleRate ? sampleRate : static_cast<int>(m_synth.voiceSampleRate());
+    m_synth.setSynthesisRate(level.maxSampleRate ? std::min(baseSampleRate, level.maxSampleRate) : baseSampleRate);
+    m_synth.setOutputSampleRate(outputSampleRate ? outputSampleRate : baseSampleRate);
+    m_synth.setPostfilteringCoefficient(level.postfilter ? PostfilteringCoefficient : 0.0);
+    m_synth.setGVWeightForSpectrum(level.gvForSpectrum ? GVWeight : 0.0);
+    m_synth.setGVWeightForLogF0(level.gvForLogF0 ? GVWeight : 0.0);
+    m_synth.setPadeOrder(level.padeOrder);
+}
+
+void SynthThread::updateQualityLevel(qint64 elapsed, qint64 duration, int maxQualityLevel, double targetRealTimeFactor, int maxSynthesisTime)
+{
+    if (duration <= 0)
+        return;
+    const auto realTimeFactor = static_cast<double>(elapsed) / duration;
+    if (realTimeFactor > targetRealTimeFactor || elapsed > maxSynthesisTime) {
+        if (m_qualityLevel < maxQualityLevel) {
+            ++m_qualityLevel;
+            qDebug() << "Real-time factor" << realTimeFactor << "lowering synthesis quality to level" << m_qualityLevel;
+        }
+    } else if (realTimeFactor < RestoreMargin * targetRealTimeFactor && elapsed < RestoreMargin * maxSynthesisTime) {
+        if (m_qualityLevel > 0) {
+            --m_qualityLevel;
+            qDebug() << "Real-time factor" << realTimeFactor << "raising synthesis quality to level" << m_qualityLevel;
+        }
     }
 }
 
@@ -79,23 +405,81 @@ void SynthThread::initializeSynth()
         qWarning("Failed to read dictionary file %s", DictionaryPath);
         return;
     }
+    m_synth.loadLabelCache(labelCachePath());
 
-    if (!m_synth.loadVoice(VoicePath)) {
-        qWarning("Failed to read voice file %s", VoicePath);
+    if (m_voicePaths.isEmpty() || !loadVoices()) {
+        qWarning("Failed to read voice files %s", qPrintable(m_voicePaths.join(QStringLiteral(", "))));
         return;
     }
+    m_voiceCount = static_cast<int>(m_synth.voiceCount());
 
-    m_synth.setSamplingFrequency(SampleRate);
-    m_synth.setFramePeriod(240);
     m_synth.setAllPassConstant(0.55);
-    m_synth.setPostfilteringCoefficient(0.0);
+    m_synth.setPostfilteringCoefficient(PostfilteringCoefficient);
     m_synth.setSpeechSpeedRate(1.0);
     m_synth.setAdditionalHalfTone(0.0);
     m_synth.setVoiceUnvoicedThreshold(0.5);
-    m_synth.setGVWeightForSpectrum(1.0);
-    m_synth.setGVWeightForLogF0(1.0);
+    m_synth.setGVWeightForSpectrum(GVWeight);
+    m_synth.setGVWeightForLogF0(GVWeight);
     m_synth.setVolume(1.0);
     m_synth.setAudioBufferSize(0);
 
     m_initialized = true;
 }
+
+bool SynthThread::loadVoices()
+{
+    // the precompiled voice images are mapped directly instead of parsing the
+    // voice files, switching voices later never touches the disk
+    for (const auto rebuild : { false, true }) {
+        QList<QByteArray> images;
+        for (const auto &voicePath : m_voicePaths) {
+            const auto image = voiceImage(voicePath, rebuild);
+            if (image.isEmpty())
+                break;
+            images.append(image);
+        }
+        if (images.size() != m_voicePaths.size())
+            break;
+
+        std::vector<const char *> imagePaths;
+        for (const auto &image : images)
+            imagePaths.push_back(image.constData());
+        if (m_synth.loadVoiceImages(imagePaths))
+            return true;
+        qWarning("Failed to read voice images");
+    }
+
+    QList<QByteArray> voices;
+    std::vector<const char *> voicePaths;
+    for (const auto &voicePath : m_voicePaths)
+        voices.append(QFile::encodeName(voicePath));
+    for (const auto &voice : voices)
+        voicePaths.push_back(voice.constData());
+    return m_synth.loadVoices(voicePaths);
+}
+
+QByteArray SynthThread::voiceImage(const QString &voicePath, bool rebuild)
+{
+    const QFileInfo voiceInfo(voicePath);
+    const auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    // voices of the same name in different directories get their own image
+    const auto pathHash = QCryptographicHash::hash(voiceInfo.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+    const QFileInfo imageInfo(QDir(cacheDir).filePath(voiceInfo.completeBaseName() + QLatin1Char('-') + QString::fromLatin1(pathHash) + QStringLiteral(".htsimage")));
+    const auto imagePath = QFile::encodeName(imageInfo.filePath());
+    const auto voice = QFile::encodeName(voicePath);
+
+    if (!rebuild && imageInfo.exists() && imageInfo.lastModified() >= voiceInfo.lastModified() && Synth::isVoiceImageOf(imagePath.constData(), voice.constData()))
+        return imagePath;
+
+    // images are written from a single voice, the engine is loaded with all
+    // of them afterwards
+    if (!m_synth.loadVoice(voice.constData()))
+        return {};
+
+    if (!QDir().mkpath(cacheDir) || !m_synth.saveVoiceImage(imagePath.constData(), voice.constData())) {
+        qWarning("Failed to write voice image %s", imagePath.constData());
+        return {};
+    }
+
+    return imagePath;
+}
@@ -1,37 +1,122 @@
 #pragma once
 
+#include "pcmbuffer.h"
 #include "synth.h"
 
+#include <QFuture>
+#include <QHash>
+#include <QList>
 #include <QMutex>
+#include <QStringList>
 #include <QThread>
 #include <QWaitCondition>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+
 class SynthThread : public QThread
 {
     Q_OBJECT
 
 public:
+    // jobs run in this order, a job stops lower priority work between two
+    // vocoder frames and that work starts over once it is done
+    enum class Priority {
+        Backfill,
+        Prefetch,
+        Interactive
+    };
+
+    // copies share the cancellation, a cancelled job is dropped when it is
+    // picked and its result is never delivered
+    class CancelToken
+    {
+    public:
+        CancelToken();
+
+        void cancel() const;
+        bool isCancelled() const;
+        bool operator==(const CancelToken &other) const;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_cancelled;
+    };
+
+    struct Job {
+        QString text;
+        QList<double> voiceWeights; // missing weights are 0
+        Priority priority = Priority::Interactive;
+        CancelToken cancelToken;
+        // done is called in the thread of context, or on the synth thread
+        // without one, jobs without done emit synthesizedAudio, and the job
+        // is cancelled when context is destroyed
+        QObject *context = nullptr;
+        std::function<void(const PcmBuffer &)> done;
+        // called on the synth thread with 0 before the job starts and before
+        // the first vocoder frame, then after every frame, a preempted job
+        // counts its frames again
+        std::function<void(size_t frame, size_t frameCount)> progress;
+    };
+
     explicit SynthThread(QObject *parent = nullptr);
+    explicit SynthThread(const QStringList &voicePaths, QObject *parent = nullptr);
     ~SynthThread();
 
     bool initialized() const;
+    int voiceCount() const;
     int sampleRate() const;
-    void synthesize(const QString &text);
+    void setSampleRate(int sampleRate);
+    void setOutputSampleRate(int sampleRate);
+    void setMaxQualityLevel(int level);
+    void setTargetRealTimeFactor(double realTimeFactor);
+    void setMaxSynthesisTime(int msecs);
+    void synthesize(const QString &text, int voice = 0);
+    void synthesize(const QString &text, const QList<double> &voiceWeights);
+    void synthesize(const Job &job);
+    void cancel(const CancelToken &cancelToken);
+    QFuture<PcmBuffer> synthesizeAsync(const QString &text, int voice = 0, Priority priority = Priority::Interactive);
+    QFuture<PcmBuffer> synthesizeAsync(const QString &text, const QList<double> &voiceWeights, Priority priority = Priority::Interactive);
 
 signals:
-    void synthesizedAudio(const QByteArray &audioData);
+    void synthesizedAudio(const PcmBuffer &audio);
 
 protected:
     void run() override;
 
 private:
+    struct PendingRequest {
+        QFuture<PcmBuffer> future;
+        CancelToken cancelToken;
+    };
+
     void initializeSynth();
+    bool loadVoices();
+    QByteArray voiceImage(const QString &voicePath, bool rebuild);
+    void enqueue(const Job &job);
+    void finishJob(const Job &job, const PcmBuffer &audio);
+    void contextDestroyed(QObject *context);
+    QList<double> singleVoiceWeights(int voice) const;
+    void raisePriority(const CancelToken &cancelToken, Priority priority);
+    void applyQualityLevel(int sampleRate, int outputSampleRate);
+    void updateQualityLevel(qint64 elapsed, qint64 duration, int maxQualityLevel, double targetRealTimeFactor, int maxSynthesisTime);
 
     Synth m_synth;
-    QMutex m_mutex;
+    PcmBufferPool m_bufferPool;
+    QStringList m_voicePaths;
+    int m_voiceCount = 0;
+    mutable QMutex m_mutex;
     QWaitCondition m_condition;
-    QString m_text;
-    bool m_restart = false;
+    QList<Job> m_jobs;
+    std::optional<Job> m_runningJob;
+    QHash<QString, PendingRequest> m_pendingRequests;
+    int m_sampleRate = 0;
+    int m_outputSampleRate = 0;
+    int m_maxQualityLevel;
+    double m_targetRealTimeFactor = 0.5;
+    int m_maxSynthesisTime = 1000;
+    int m_qualityLevel = 0;
     bool m_abort = false;
     bool m_initialized = false;
 };